@@ -0,0 +1,132 @@
+// Compares processing of many small matrices one by one with BatchedMatrix2D.
+// Usage: BatchedBenchmark [count = 10000]
+// Every line runs an operation on count square matrices of the size, separate matrices
+// are kept in shared pointers and processed by a call per matrix as an adapter would do,
+// the batch is processed by a single call with loops vectorized across matrices.
+
+#include "matrix/BatchedMatrix.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+void Print(const std::string& name, const size_t size, const double separateTime, const double batchedTime)
+{
+	std::cout << std::setw(20) << name
+		<< std::setw(4) << size << "x" << std::setw(2) << std::left << size << std::right
+		<< std::setw(12) << std::fixed << std::setprecision(2) << separateTime * 1e3 << "ms"
+		<< std::setw(12) << batchedTime * 1e3 << "ms"
+		<< std::setw(8) << std::setprecision(1) << separateTime / batchedTime << "x\n";
+}
+
+template<typename T>
+void Run(const size_t size, const size_t count)
+{
+	using Adapter = mtx::Matrix2DAdapter<T>;
+	std::vector<std::shared_ptr<mtx::Matrix2D<T>>> separate;
+	std::vector<std::shared_ptr<mtx::Matrix2D<T>>> others;
+	mtx::BatchedMatrix2D<T> batch(count, size, size, mtx::uninitialized);
+	mtx::BatchedMatrix2D<T> otherBatch(count, size, size, mtx::uninitialized);
+	for (size_t b = 0; b < count; ++b)
+	{
+		separate.push_back(std::make_shared<mtx::Matrix2D<T>>(mtx::CreateRandomMatrix2D<T>(mtx::execution::seq, size, size, 2 * b)));
+		others.push_back(std::make_shared<mtx::Matrix2D<T>>(mtx::CreateRandomMatrix2D<T>(mtx::execution::seq, size, size, 2 * b + 1)));
+		batch.Set(b, separate.back()->GetView());
+		otherBatch.Set(b, others.back()->GetView());
+	}
+
+	std::vector<mtx::Matrix2D<T>> results(count);
+	mtx::BatchedMatrix2D<T> batchResult(count, size, size, mtx::uninitialized);
+	Print(
+		"TransformMatrices",
+		size,
+		Measure([&]
+		{
+			for (size_t b = 0; b < count; ++b) {
+				results[b] = mtx::TransformMatrices(*separate[b], *others[b], std::plus<T>());
+			}
+		}),
+		Measure([&] { mtx::TransformMatrices(batch, otherBatch, batchResult, std::plus<T>()); }));
+	Print(
+		"Multiply",
+		size,
+		Measure([&]
+		{
+			for (size_t b = 0; b < count; ++b) {
+				results[b] = *separate[b] * *others[b];
+			}
+		}),
+		Measure([&] { mtx::Multiply(batch, otherBatch, batchResult); }));
+
+	std::vector<int> minimums(count);
+	Print(
+		"CountLocalMinimums",
+		size,
+		Measure([&]
+		{
+			for (size_t b = 0; b < count; ++b) {
+				minimums[b] = Adapter(separate[b]).CountLocalMinimums();
+			}
+		}),
+		Measure([&] { minimums = Adapter::CountLocalMinimums(batch); }));
+
+	std::vector<T> sums(count);
+	Print(
+		"SumOverMainDiagonal",
+		size,
+		Measure([&]
+		{
+			for (size_t b = 0; b < count; ++b) {
+				sums[b] = Adapter(separate[b]).SumOverMainDiagonal();
+			}
+		}),
+		Measure([&] { sums = Adapter::SumOverMainDiagonal(batch); }));
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+
+	std::cout << std::setw(27) << "size" << std::setw(14) << "separate" << std::setw(14) << "batched"
+		<< std::setw(9) << "speedup\n";
+	std::cout << "float\n";
+	for (const size_t size : { 4, 8, 16 }) {
+		Run<float>(size, count);
+	}
+	std::cout << "double\n";
+	for (const size_t size : { 4, 8, 16 }) {
+		Run<double>(size, count);
+	}
+
+	return 0;
+}
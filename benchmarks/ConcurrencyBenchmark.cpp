@@ -0,0 +1,136 @@
+// Measures throughput of analyses and writes of a matrix shared by several threads.
+// Usage: ConcurrencyBenchmark [size = 512] [readers = number of hardware threads - 1] [milliseconds = 1000]
+// Reader threads run CountLocalMinimums and SumOverMainDiagonal through their own adapters,
+// a writer thread runs CyclicShift and SetElement at the same time. Calls are coordinated
+// by a global mutex or by concurrent readers of Matrix2DAdapter, which read published copies.
+
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//! Numbers of calls finished during the run.
+struct Throughput
+{
+	std::uint64_t analyses_ = { 0 };
+	std::uint64_t writes_ = { 0 };
+	//! Sum of results of the analyses.
+	std::uint64_t checksum_ = { 0 };
+};
+
+//! Runs readers and the writer for the duration, every call is passed to guard
+//! which makes it under the global mutex or directly.
+template<typename Guard>
+Throughput Run(
+	const size_t size,
+	const size_t readersNumber,
+	const std::chrono::milliseconds duration,
+	const bool concurrent,
+	Guard guard)
+{
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(mtx::CreateRandomMatrix2D<int>(size, size, 1));
+	mtx::Matrix2DAdapter<int> writer(mat);
+	if (concurrent) {
+		writer.EnableConcurrentReaders();
+	}
+
+	std::atomic<bool> done{ false };
+	std::atomic<std::uint64_t> analyses{ 0 };
+	std::atomic<std::uint64_t> checksum{ 0 };
+	std::uint64_t writes = 0;
+	std::vector<std::thread> readers;
+	for (size_t i = 0; i < readersNumber; ++i)
+	{
+		readers.emplace_back([&]
+		{
+			const mtx::Matrix2DAdapter<int> reader(mat);
+			std::uint64_t calls = 0;
+			// Results are consumed, so the analyses aren't optimized away.
+			std::uint64_t sum = 0;
+			while (!done.load(std::memory_order_relaxed))
+			{
+				guard([&reader, &sum] { sum += static_cast<std::uint64_t>(reader.CountLocalMinimums()); });
+				guard([&reader, &sum] { sum += static_cast<std::uint64_t>(reader.SumOverMainDiagonal()); });
+				calls += 2;
+			}
+			analyses += calls;
+			checksum += sum;
+		});
+	}
+
+	std::thread writerThread([&]
+	{
+		size_t row = 0;
+		while (!done.load(std::memory_order_relaxed))
+		{
+			guard([&writer] { writer.CyclicShift(); });
+			guard([&writer, row] { writer.SetElement(row, row, static_cast<int>(row)); });
+			row = (row + 1) % size;
+			writes += 2;
+		}
+	});
+
+	std::this_thread::sleep_for(duration);
+	done = true;
+	writerThread.join();
+	for (auto& thread : readers) {
+		thread.join();
+	}
+
+	return Throughput{ analyses.load(), writes, checksum.load() };
+}
+
+void Print(const std::string& name, const Throughput& throughput, const std::chrono::milliseconds duration)
+{
+	const double seconds = static_cast<double>(duration.count()) / 1e3;
+	std::cout << std::setw(20) << std::left << name << std::right
+		<< std::setw(14) << std::fixed << std::setprecision(0) << static_cast<double>(throughput.analyses_) / seconds
+		<< std::setw(14) << static_cast<double>(throughput.writes_) / seconds
+		<< std::setw(14) << throughput.checksum_ << '\n';
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+	const size_t readersNumber = argc > 2
+		? std::strtoul(argv[2], nullptr, 10)
+		: std::max<size_t>(mtx::detail::GetThreadsNumber(), 2) - 1;
+	const std::chrono::milliseconds duration(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000);
+
+	std::cout << "size " << size << "x" << size << ", " << readersNumber << " readers, 1 writer\n"
+		<< std::setw(20) << "" << std::setw(14) << "analyses/s" << std::setw(14) << "writes/s"
+		<< std::setw(14) << "checksum" << '\n';
+
+	std::mutex mutex;
+	Print(
+		"global mutex",
+		Run(size, readersNumber, duration, false, [&mutex] (auto call)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			call();
+		}),
+		duration);
+	Print(
+		"concurrent readers",
+		Run(size, readersNumber, duration, true, [] (auto call) { call(); }),
+		duration);
+
+	return 0;
+}
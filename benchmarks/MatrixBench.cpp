@@ -0,0 +1,274 @@
+// Performance regression suite of Matrix2D and Matrix2DAdapter on Google Benchmark.
+// Usage: matrix-bench [Google Benchmark options], e.g. --benchmark_filter=Copy
+// Every operation runs on square matrices of int, float and double with sides from 32
+// (the matrix fits the L1 cache) to 4096 (far beyond the last level cache) and reports
+// bytes of elements read and written per second.
+// The matrix-bench-json target runs every benchmark for at least 0.05s and writes results
+// to matrix-bench.json in the build directory. The baseline was recorded with the same options
+// on a single CPU, compare results with it by tools/compare.py of Google Benchmark:
+//     compare.py benchmarks benchmarks/baseline/matrix-bench.json <build>/benchmarks/matrix-bench.json
+
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+//! Sides of matrices, 32 fits L1, 128 fits L2, 512 and 1024 fit or cross the last level cache.
+void Sizes(benchmark::internal::Benchmark* bench)
+{
+	for (const int side : { 32, 128, 512, 1024, 4096 }) {
+		bench->Arg(side);
+	}
+}
+
+//! Returns side of the matrix of the benchmark.
+size_t Side(const benchmark::State& state)
+{
+	return static_cast<size_t>(state.range(0));
+}
+
+//! Reports accessed bytes and elements, passes counts of matrices read and written by one iteration.
+template<typename T>
+void SetProcessed(benchmark::State& state, const double matrices)
+{
+	const auto elements = static_cast<std::int64_t>(matrices * static_cast<double>(Side(state) * Side(state)));
+	state.SetItemsProcessed(state.iterations() * elements);
+	state.SetBytesProcessed(state.iterations() * elements * static_cast<std::int64_t>(sizeof(T)));
+}
+
+template<typename T>
+mtx::Matrix2D<T> CreateMatrix(const benchmark::State& state, const std::uint64_t seed = 1)
+{
+	return mtx::CreateRandomMatrix2D<T>(Side(state), Side(state), seed);
+}
+
+template<typename T>
+void Construction(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		mtx::Matrix2D<T> mat(Side(state), Side(state));
+		benchmark::DoNotOptimize(mat.GetView().Data());
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void Copy(benchmark::State& state)
+{
+	const auto source = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		mtx::Matrix2D<T> copy(source);
+		benchmark::DoNotOptimize(copy.GetView().Data());
+	}
+	SetProcessed<T>(state, 2);
+}
+
+template<typename T>
+void Move(benchmark::State& state)
+{
+	auto first = CreateMatrix<T>(state);
+	mtx::Matrix2D<T> second;
+	for (auto _ : state)
+	{
+		second = std::move(first);
+		first = std::move(second);
+		benchmark::DoNotOptimize(first.GetView().Data());
+	}
+	// Moves don't touch elements, so only the number of moves is reported.
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template<typename T>
+void Slice(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		for (size_t r = 0; r < mat.GetRows(); ++r)
+		{
+			const auto row = mat.Slice(r);
+			benchmark::DoNotOptimize(row.data());
+		}
+	}
+	SetProcessed<T>(state, 2);
+}
+
+template<typename T>
+void TransformMatrices(benchmark::State& state)
+{
+	const auto left = CreateMatrix<T>(state, 1);
+	const auto right = CreateMatrix<T>(state, 2);
+	mtx::Matrix2D<T> result(Side(state), Side(state));
+	for (auto _ : state)
+	{
+		mtx::TransformMatrices(left.GetView(), right.GetView(), result.GetView(), std::plus<T>());
+		benchmark::ClobberMemory();
+	}
+	SetProcessed<T>(state, 3);
+}
+
+template<typename T>
+void Equal(benchmark::State& state)
+{
+	const auto left = CreateMatrix<T>(state);
+	const auto right = left;
+	for (auto _ : state)
+	{
+		bool equal = left == right;
+		benchmark::DoNotOptimize(equal);
+	}
+	SetProcessed<T>(state, 2);
+}
+
+template<typename T>
+void CountLocalMinimums(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		int minimums = mtx::Matrix2DAdapter<T>::CountLocalMinimums(mat.GetView());
+		benchmark::DoNotOptimize(minimums);
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void LongestIdenticalSet(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		int row = mtx::Matrix2DAdapter<T>::LongestIdenticalSet(mat.GetView());
+		benchmark::DoNotOptimize(row);
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void NonNegativeRowsMultiplication(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		T product = mtx::Matrix2DAdapter<T>::NonNegativeRowsMultiplication(mat.GetView());
+		benchmark::DoNotOptimize(product);
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void SumOverMainDiagonal(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		T sum = mtx::Matrix2DAdapter<T>::SumOverMainDiagonal(mat.GetView());
+		benchmark::DoNotOptimize(sum);
+	}
+	// Only elements over the main diagonal are read.
+	SetProcessed<T>(state, 0.5);
+}
+
+template<typename T>
+void Analyze(benchmark::State& state)
+{
+	const auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		auto result = mtx::Matrix2DAdapter<T>::Analyze(mat.GetView());
+		benchmark::DoNotOptimize(result);
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void CyclicShift(benchmark::State& state)
+{
+	auto mat = CreateMatrix<T>(state);
+	for (auto _ : state)
+	{
+		mtx::Matrix2DAdapter<T>::CyclicShift(mat.GetView(), 1);
+		benchmark::ClobberMemory();
+	}
+	SetProcessed<T>(state, 2);
+}
+
+template<typename T>
+void Transpose(benchmark::State& state)
+{
+	const auto source = CreateMatrix<T>(state);
+	mtx::Matrix2D<T> result(Side(state), Side(state));
+	for (auto _ : state)
+	{
+		mtx::Transpose(source.GetView(), result.GetView());
+		benchmark::ClobberMemory();
+	}
+	SetProcessed<T>(state, 2);
+}
+
+//! Sums every column of the matrix, column-major matrices are read with the unit stride.
+template<typename T, mtx::Layout L>
+void ColumnSums(benchmark::State& state)
+{
+	const auto mat = mtx::ConvertLayout(CreateMatrix<T>(state), L);
+	std::vector<T> sums(mat.GetColumns());
+	for (auto _ : state)
+	{
+		for (size_t c = 0; c < mat.GetColumns(); ++c)
+		{
+			const auto column = mat.ColumnView(c);
+			sums[c] = std::accumulate(column.Begin(), column.End(), T{});
+		}
+		benchmark::DoNotOptimize(sums.data());
+	}
+	SetProcessed<T>(state, 1);
+}
+
+template<typename T>
+void ColumnSumsRowMajor(benchmark::State& state)
+{
+	ColumnSums<T, mtx::Layout::RowMajor>(state);
+}
+
+template<typename T>
+void ColumnSumsColumnMajor(benchmark::State& state)
+{
+	ColumnSums<T, mtx::Layout::ColumnMajor>(state);
+}
+
+}	// namespace
+
+#define MATRIX_BENCHMARK(Func) \
+	BENCHMARK_TEMPLATE(Func, int)->Apply(Sizes); \
+	BENCHMARK_TEMPLATE(Func, float)->Apply(Sizes); \
+	BENCHMARK_TEMPLATE(Func, double)->Apply(Sizes)
+
+MATRIX_BENCHMARK(Construction);
+MATRIX_BENCHMARK(Copy);
+MATRIX_BENCHMARK(Move);
+MATRIX_BENCHMARK(Slice);
+MATRIX_BENCHMARK(TransformMatrices);
+MATRIX_BENCHMARK(Equal);
+MATRIX_BENCHMARK(CountLocalMinimums);
+MATRIX_BENCHMARK(LongestIdenticalSet);
+MATRIX_BENCHMARK(NonNegativeRowsMultiplication);
+MATRIX_BENCHMARK(SumOverMainDiagonal);
+MATRIX_BENCHMARK(Analyze);
+MATRIX_BENCHMARK(CyclicShift);
+MATRIX_BENCHMARK(Transpose);
+MATRIX_BENCHMARK(ColumnSumsRowMajor);
+MATRIX_BENCHMARK(ColumnSumsColumnMajor);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+// Compares built-in matrix multiplication with the naive triple loop.
+// Usage: MultiplyBenchmark [max size = 8192] [max size for naive loop = 2048]
+// Sizes are doubled starting from 64, naive loop is skipped for bigger sizes
+// because it takes minutes there.
+
+#include "matrix/Matrix.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+template<typename T>
+mtx::Matrix2D<T> NaiveMultiply(const mtx::Matrix2D<T>& left, const mtx::Matrix2D<T>& right)
+{
+	mtx::Matrix2D<T> result(left.GetRows(), right.GetColumns(), 0);
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < right.GetColumns(); ++c)
+		{
+			T sum = 0;
+			for (size_t k = 0; k < left.GetColumns(); ++k) {
+				sum += left(r, k) * right(k, c);
+			}
+			result(r, c) = sum;
+		}
+	}
+
+	return result;
+}
+
+//! Returns time of the call in seconds, the best of several runs for small sizes.
+template<typename Func>
+double Measure(Func func, const size_t size)
+{
+	const int repeats = size <= 256 ? 5 : 1;
+	double best = 0;
+	for (int i = 0; i < repeats; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+template<typename T>
+void Run(const std::string& typeName, const size_t maxSize, const size_t maxNaiveSize)
+{
+	std::cout << typeName << '\n'
+		<< std::setw(8) << "size"
+		<< std::setw(14) << "gemm GFLOP/s"
+		<< std::setw(15) << "naive GFLOP/s"
+		<< std::setw(10) << "speedup" << '\n';
+
+	for (size_t size = 64; size <= maxSize; size *= 2)
+	{
+		const auto left = mtx::CreateRandomMatrix2D<T>(size, size);
+		const auto right = mtx::CreateRandomMatrix2D<T>(size, size);
+		const double flops = 2.0 * size * size * size;
+
+		const double gemmTime = Measure([&] { auto product = left * right; }, size);
+		std::cout << std::setw(8) << size
+			<< std::setw(14) << std::fixed << std::setprecision(2) << flops / gemmTime * 1e-9;
+
+		if (size <= maxNaiveSize)
+		{
+			const double naiveTime = Measure([&] { auto product = NaiveMultiply(left, right); }, size);
+			std::cout << std::setw(15) << flops / naiveTime * 1e-9
+				<< std::setw(10) << naiveTime / gemmTime;
+		}
+		std::cout << std::endl;
+	}
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t maxSize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8192;
+	const size_t maxNaiveSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2048;
+
+	Run<float>("float", maxSize, maxNaiveSize);
+	Run<double>("double", maxSize, maxNaiveSize);
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+// Measures scaling of parallel overloads of matrix operations with the number of threads.
+// Usage: ParallelBenchmark [size = 4096] [max threads = number of hardware threads]
+// Number of threads is doubled starting from 1, the maximum is always measured.
+// Every number of threads gets its own scheduler with one worker less, since the
+// calling thread works too. Speedup is relative to the single thread run of the operation.
+
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+#include "matrix/Scheduler.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+//! Prints time and speedup of the operation for every number of threads.
+template<typename Func>
+void Run(const std::string& name, const std::vector<size_t>& threads, Func func)
+{
+	std::cout << std::setw(32) << std::left << name << std::right;
+	double singleThreadTime = 0;
+	for (const size_t threadsNumber : threads)
+	{
+		mtx::WorkStealingScheduler scheduler(threadsNumber - 1);
+		const auto policy = mtx::execution::par.On(scheduler);
+		const double time = Measure([&] { func(policy); });
+		if (threadsNumber == 1) {
+			singleThreadTime = time;
+		}
+		std::cout << std::setw(10) << std::fixed << std::setprecision(2) << time * 1e3 << "ms"
+			<< std::setw(6) << std::setprecision(1) << singleThreadTime / time << 'x';
+	}
+	std::cout << std::endl;
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+	const size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : mtx::detail::GetThreadsNumber();
+
+	std::vector<size_t> threads;
+	for (size_t t = 1; t < maxThreads; t *= 2) {
+		threads.push_back(t);
+	}
+	threads.push_back(maxThreads);
+
+	std::cout << "size " << size << "x" << size << '\n' << std::setw(32) << "threads";
+	for (const size_t threadsNumber : threads) {
+		std::cout << std::setw(19) << threadsNumber;
+	}
+	std::cout << '\n';
+
+	auto left = std::make_shared<mtx::Matrix2D<double>>(mtx::Matrix2D<double>::Dimension{ size, size });
+	auto right = mtx::Matrix2D<double>(left->GetSize());
+	std::mt19937_64 generator;
+	std::uniform_real_distribution<double> distribution(0.0, 100.0);
+	const mtx::Matrix2DAdapter<double> adapter(left);
+
+	Run("RandomizeElements", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		mtx::RandomizeElements(policy, *left, generator, distribution);
+	});
+	Run("RandomizeUniform", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		mtx::RandomizeUniform(policy, left->GetView(), 1, 0.0, 100.0);
+	});
+	right = *left;
+	Run("TransformMatrices", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		auto sum = mtx::TransformMatrices(policy, *left, right, std::plus<double>());
+	});
+	Run("Equal", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile bool equal = mtx::Equal(policy, *left, right);
+		(void)equal;
+	});
+	Run("CountLocalMinimums", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile int minimums = adapter.CountLocalMinimums(policy);
+		(void)minimums;
+	});
+	Run("CyclicShift", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		mtx::Matrix2DAdapter<double>::CyclicShift(policy, left->GetView(), size / 3);
+	});
+	Run("LongestIdenticalSet", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile int row = adapter.LongestIdenticalSet(policy);
+		(void)row;
+	});
+	Run("NonNegativeRowsMultiplication", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile double product = adapter.NonNegativeRowsMultiplication(policy);
+		(void)product;
+	});
+	Run("SumOverMainDiagonal", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile double sum = adapter.SumOverMainDiagonal(policy);
+		(void)sum;
+	});
+	Run("Four analyses separately", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile double sum = adapter.CountLocalMinimums(policy) + adapter.LongestIdenticalSet(policy)
+			+ adapter.NonNegativeRowsMultiplication(policy) + adapter.SumOverMainDiagonal(policy);
+		(void)sum;
+	});
+	Run("Four analyses by Analyze", threads, [&] (const mtx::execution::ParallelPolicy& policy)
+	{
+		volatile int minimums = adapter.Analyze(policy).localMinimums_;
+		(void)minimums;
+	});
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+// Compares the run-length kernel of LongestIdenticalSet with the per-element scan it replaced.
+// Usage: RunLengthBenchmark [size = 4096]
+// The per-element scan compares neighbors through accesses of the view and updates the run
+// after every comparison, the kernel compares whole vectors of neighbors and finds boundaries
+// of runs by bit-scan of the masks. Rows of random elements have runs of one or two elements,
+// rows of few values have many short runs, every tenth row of runs has long runs.
+// The last line scans rows in parallel by blocks of rows on the default scheduler.
+
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+#include "matrix/Simd.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+//! Returns number of row with the longest run, elements are compared one by one.
+template<typename T>
+int LongestIdenticalSetPerElement(const mtx::Matrix2DView<const T>& view)
+{
+	size_t number = 0;
+	size_t longestSet = 1;
+	for (size_t r = 0; r < view.GetRows(); ++r)
+	{
+		size_t currentLength = 1;
+		for (size_t c = 1; c < view.GetColumns(); ++c)
+		{
+			currentLength = view(r, c) == view(r, c - 1) ? currentLength + 1 : 1;
+			if (currentLength > longestSet)
+			{
+				longestSet = currentLength;
+				number = r;
+			}
+		}
+	}
+
+	return view.GetRows() == 0 ? -1 : static_cast<int>(number);
+}
+
+//! Prints time and speedup relative to the per-element scan.
+void Print(const std::string& name, const double time, const double baseline)
+{
+	std::cout << std::setw(24) << std::left << name << std::right
+		<< std::setw(10) << std::fixed << std::setprecision(2) << time * 1e3 << "ms"
+		<< std::setw(8) << std::setprecision(1) << baseline / time << "x\n";
+}
+
+template<typename T>
+void Run(const std::string& typeName, const std::string& dataName, const size_t size, const int values)
+{
+	mtx::Matrix2D<T> mat(size, size);
+	std::mt19937 generator;
+	std::uniform_int_distribution<int> distribution(0, values);
+	for (size_t r = 0; r < size; ++r)
+	{
+		// Long runs are made by repeating every value.
+		const size_t repeat = values < 1000 && r % 10 == 0 ? 50 : 1;
+		for (size_t c = 0; c < size; c += repeat)
+		{
+			const auto value = static_cast<T>(distribution(generator));
+			for (size_t i = c; i < c + repeat && i < size; ++i) {
+				mat(r, i) = value;
+			}
+		}
+	}
+	const mtx::Matrix2DView<const T> view = mat.GetView();
+	volatile int row = 0;
+
+	std::cout << typeName << ' ' << dataName << ' ' << size << "x" << size << '\n';
+	const double baseline = Measure([&] { row = LongestIdenticalSetPerElement(view); });
+	Print("per element", baseline, baseline);
+
+	for (int level = 0; level <= static_cast<int>(mtx::simd::GetSupportedIsa()); ++level)
+	{
+		const auto isa = static_cast<mtx::simd::Isa>(level);
+		mtx::simd::SetIsaLimit(isa);
+		const double time = Measure([&] { row = mtx::Matrix2DAdapter<T>::LongestIdenticalSet(view); });
+		Print(std::string("runs ") + mtx::simd::GetIsaName(isa), time, baseline);
+	}
+	mtx::simd::SetIsaLimit(mtx::simd::Isa::Avx512);
+
+	const double parallel = Measure([&]
+	{
+		row = mtx::Matrix2DAdapter<T>::LongestIdenticalSet(mtx::execution::par, view);
+	});
+	Print("runs parallel", parallel, baseline);
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+
+	Run<float>("float", "random", size, 1000000);
+	Run<float>("float", "runs", size, 3);
+	Run<double>("double", "random", size, 1000000);
+	Run<double>("double", "runs", size, 3);
+	Run<int>("int", "random", size, 1000000);
+	Run<int>("int", "runs", size, 3);
+	Run<long long>("long long", "random", size, 1000000);
+	Run<long long>("long long", "runs", size, 3);
+
+	return 0;
+}
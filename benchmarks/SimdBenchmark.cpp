@@ -0,0 +1,96 @@
+// Measures throughput of the vector kernels in GB/s for every supported instruction set.
+// Usage: SimdBenchmark [number of elements = 16M]
+// Sizes: small arrays stay in L1 cache, the big ones are limited by memory bandwidth.
+
+#include "matrix/Simd.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//! Returns bytes per second processed by func, which touches bytes on each call.
+template<typename Func>
+double Measure(Func func, const double bytes)
+{
+	const auto start = std::chrono::steady_clock::now();
+	size_t iterations = 0;
+	std::chrono::duration<double> elapsed{};
+	do
+	{
+		func();
+		++iterations;
+		elapsed = std::chrono::steady_clock::now() - start;
+	} while (elapsed.count() < 0.2);
+
+	return bytes * iterations / elapsed.count();
+}
+
+template<typename T>
+void Run(const std::string& typeName, const size_t n)
+{
+	std::vector<T> left(n, static_cast<T>(1));
+	std::vector<T> right(n, static_cast<T>(1));
+	std::vector<T> result(n);
+	const double bytes = static_cast<double>(n * sizeof(T));
+	volatile bool sink = false;
+	volatile T sum = 0;
+
+	for (int level = 0; level <= static_cast<int>(mtx::simd::GetSupportedIsa()); ++level)
+	{
+		const auto isa = static_cast<mtx::simd::Isa>(level);
+		mtx::simd::SetIsaLimit(isa);
+
+		const double add = Measure(
+			[&] { mtx::simd::Add(left.data(), right.data(), result.data(), n); }, 3 * bytes);
+		const double equal = Measure(
+			[&] { sink = mtx::simd::Equal(left.data(), right.data(), n); }, 2 * bytes);
+		const double reduce = Measure(
+			[&] { sum = mtx::simd::Sum(left.data(), n, static_cast<T>(0)); }, bytes);
+		const double negative = Measure(
+			[&] { sink = mtx::simd::AnyNegative(left.data(), n); }, bytes);
+
+		std::cout << std::setw(8) << typeName
+			<< std::setw(10) << n
+			<< std::setw(9) << mtx::simd::GetIsaName(isa)
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(10) << add * 1e-9
+			<< std::setw(10) << equal * 1e-9
+			<< std::setw(10) << reduce * 1e-9
+			<< std::setw(10) << negative * 1e-9 << std::endl;
+	}
+
+	mtx::simd::SetIsaLimit(mtx::simd::Isa::Avx512);
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t bigSize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t{ 1 } << 24);
+	const size_t smallSize = 2048;
+
+	std::cout << "Throughput in GB/s\n"
+		<< std::setw(8) << "type"
+		<< std::setw(10) << "elements"
+		<< std::setw(9) << "isa"
+		<< std::setw(10) << "add"
+		<< std::setw(10) << "equal"
+		<< std::setw(10) << "sum"
+		<< std::setw(10) << "negative" << '\n';
+
+	for (const size_t n : { smallSize, bigSize })
+	{
+		Run<float>("float", n);
+		Run<double>("double", n);
+		Run<int>("int32", n);
+		Run<long long>("int64", n);
+	}
+
+	return 0;
+}
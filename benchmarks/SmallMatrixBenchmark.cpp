@@ -0,0 +1,96 @@
+// Compares Matrix2D with FixedMatrix2D on many small matrices.
+// Usage: SmallMatrixBenchmark [count = 100000]
+// Every line multiplies and adds count pairs of square matrices of the size,
+// Matrix2D allocates every result while FixedMatrix2D keeps elements inside the object.
+
+#include "matrix/FixedMatrix.h"
+#include "matrix/Matrix.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+template<typename T, size_t N>
+void Run(const std::string& typeName, const size_t count)
+{
+	std::mt19937 generator;
+	std::uniform_real_distribution<double> distribution(-1, 1);
+	std::vector<mtx::FixedMatrix2D<T, N, N>> fixed(count);
+	for (auto& mat : fixed)
+	{
+		for (auto it = mat.Begin(); it != mat.End(); ++it) {
+			*it = static_cast<T>(distribution(generator));
+		}
+	}
+	std::vector<mtx::Matrix2D<T>> dynamic;
+	dynamic.reserve(count);
+	for (const auto& mat : fixed) {
+		dynamic.push_back(mat.ToMatrix2D());
+	}
+
+	std::vector<mtx::Matrix2D<T>> dynamicResults(count);
+	const double dynamicTime = Measure([&]
+	{
+		for (size_t i = 0; i + 1 < count; ++i)
+		{
+			const mtx::Matrix2D<T> product = dynamic[i] * dynamic[i + 1];
+			dynamicResults[i] = product + dynamic[i];
+		}
+	});
+	std::vector<mtx::FixedMatrix2D<T, N, N>> fixedResults(count);
+	const double fixedTime = Measure([&]
+	{
+		for (size_t i = 0; i + 1 < count; ++i) {
+			fixedResults[i] = fixed[i] * fixed[i + 1] + fixed[i];
+		}
+	});
+
+	std::cout << std::setw(8) << typeName
+		<< std::setw(4) << N << "x" << std::setw(2) << std::left << N << std::right
+		<< std::setw(12) << std::fixed << std::setprecision(2) << dynamicTime * 1e3 << "ms"
+		<< std::setw(12) << fixedTime * 1e3 << "ms"
+		<< std::setw(8) << std::setprecision(1) << dynamicTime / fixedTime << "x\n";
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+	std::cout << std::setw(15) << "size" << std::setw(14) << "Matrix2D" << std::setw(14) << "FixedMatrix2D"
+		<< std::setw(9) << "speedup\n";
+	Run<float, 2>("float", count);
+	Run<float, 4>("float", count);
+	Run<float, 8>("float", count);
+	Run<double, 2>("double", count);
+	Run<double, 4>("double", count);
+	Run<double, 8>("double", count);
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+// Compares the stencil kernel of CountLocalMinimums with the per-element check it replaced.
+// Usage: StencilBenchmark [size = 4096]
+// The per-element check looks at every neighbor through bounds-checked accesses of the view,
+// the kernel compares whole rows at once with every supported instruction set.
+// The last line runs the kernel in parallel by bands of rows on the default scheduler.
+
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+#include "matrix/Simd.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+//! Checks the element with branches for every neighbor, as CountLocalMinimums did before the kernel.
+template<typename T>
+bool CheckNeighbors(const mtx::Matrix2DView<const T>& view, const size_t r, const size_t c)
+{
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
+	const T& current = view(r, c);
+	for (size_t nr = r > 0 ? r - 1 : r; nr <= r + 1 && nr < rows; ++nr)
+	{
+		for (size_t nc = c > 0 ? c - 1 : c; nc <= c + 1 && nc < columns; ++nc)
+		{
+			if ((nr != r || nc != c) && view(nr, nc) <= current) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+int CountLocalMinimumsPerElement(const mtx::Matrix2DView<const T>& view)
+{
+	int counter = 0;
+	for (size_t r = 0; r < view.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < view.GetColumns(); ++c)
+		{
+			if (CheckNeighbors(view, r, c)) {
+				++counter;
+			}
+		}
+	}
+
+	return counter;
+}
+
+//! Prints time and speedup relative to the per-element check.
+void Print(const std::string& name, const double time, const double baseline)
+{
+	std::cout << std::setw(24) << std::left << name << std::right
+		<< std::setw(10) << std::fixed << std::setprecision(2) << time * 1e3 << "ms"
+		<< std::setw(8) << std::setprecision(1) << baseline / time << "x\n";
+}
+
+template<typename T>
+void Run(const std::string& typeName, const size_t size)
+{
+	mtx::Matrix2D<T> mat(size, size);
+	std::mt19937 generator;
+	std::uniform_int_distribution<int> distribution(0, 1000);
+	for (auto it = mat.Begin(); it != mat.End(); ++it) {
+		*it = static_cast<T>(distribution(generator));
+	}
+	const mtx::Matrix2DView<const T> view = mat.GetView();
+	volatile int minimums = 0;
+
+	std::cout << typeName << ' ' << size << "x" << size << '\n';
+	const double baseline = Measure([&] { minimums = CountLocalMinimumsPerElement(view); });
+	Print("per element", baseline, baseline);
+
+	for (int level = 0; level <= static_cast<int>(mtx::simd::GetSupportedIsa()); ++level)
+	{
+		const auto isa = static_cast<mtx::simd::Isa>(level);
+		mtx::simd::SetIsaLimit(isa);
+		const double time = Measure([&] { minimums = mtx::Matrix2DAdapter<T>::CountLocalMinimums(view); });
+		Print(std::string("stencil ") + mtx::simd::GetIsaName(isa), time, baseline);
+	}
+	mtx::simd::SetIsaLimit(mtx::simd::Isa::Avx512);
+
+	const double parallel = Measure([&]
+	{
+		minimums = mtx::Matrix2DAdapter<T>::CountLocalMinimums(mtx::execution::par, view);
+	});
+	Print("stencil parallel", parallel, baseline);
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+
+	Run<float>("float", size);
+	Run<double>("double", size);
+	Run<int>("int", size);
+	Run<long long>("long long", size);
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+// Compares throughput of the text format with printing by PrintMatrix2D and reading by operator>>.
+// Usage: TextFormatBenchmark [size = 2000]
+// Matrices size x size are written to and read from memory streams, throughput is
+// the size of the text divided by the time of the call.
+
+#include "matrix/Matrix.h"
+#include "matrix/Parallel.h"
+#include "matrix/TextFormat.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+//! Returns time of the call in seconds, the best of several runs.
+template<typename Func>
+double Measure(Func func)
+{
+	double best = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best) {
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+void Print(const std::string& name, const size_t bytes, const double time)
+{
+	std::cout << std::setw(28) << std::left << name << std::right
+		<< std::setw(10) << std::fixed << std::setprecision(1) << time * 1e3 << "ms"
+		<< std::setw(10) << static_cast<double>(bytes) / time / 1e6 << " MB/s\n";
+}
+
+template<typename T>
+void Run(const std::string& type, const size_t size)
+{
+	std::cout << type << '\n';
+	const auto mat = mtx::CreateRandomMatrix2D<T>(mtx::execution::par, size, size, 1);
+
+	// PrintMatrix2D writes to std::cout, which is redirected to the memory stream.
+	std::ostringstream printed;
+	const double printTime = Measure([&]
+	{
+		printed.str(std::string());
+		auto* const buffer = std::cout.rdbuf(printed.rdbuf());
+		mtx::PrintMatrix2D(mat);
+		std::cout.rdbuf(buffer);
+	});
+	Print("PrintMatrix2D", printed.str().size(), printTime);
+
+	std::ostringstream saved;
+	const double saveTime = Measure([&]
+	{
+		saved.str(std::string());
+		mtx::SaveText(mat.GetView(), saved);
+	});
+	Print("SaveText", saved.str().size(), saveTime);
+	const double parallelSaveTime = Measure([&]
+	{
+		saved.str(std::string());
+		mtx::SaveText(mtx::execution::par, mat.GetView(), saved);
+	});
+	Print("SaveText par", saved.str().size(), parallelSaveTime);
+
+	const std::string text = saved.str();
+	const double extractTime = Measure([&]
+	{
+		std::istringstream stream(text);
+		mtx::Matrix2D<T> read(size, size);
+		char separator;
+		for (size_t r = 0; r < size; ++r)
+		{
+			for (size_t c = 0; c < size; ++c)
+			{
+				stream >> read(r, c);
+				if (c + 1 < size) {
+					stream >> separator;
+				}
+			}
+		}
+	});
+	Print("operator>>", text.size(), extractTime);
+
+	bool equal = true;
+	const double loadTime = Measure([&]
+	{
+		std::istringstream stream(text);
+		equal = mtx::LoadText<T>(stream) == mat && equal;
+	});
+	Print("LoadText", text.size(), loadTime);
+	const double parallelLoadTime = Measure([&]
+	{
+		std::istringstream stream(text);
+		equal = mtx::LoadText<T>(mtx::execution::par, stream) == mat && equal;
+	});
+	Print("LoadText par", text.size(), parallelLoadTime);
+
+	if (!equal) {
+		std::cout << "error: matrix read back differs\n";
+	}
+}
+
+}	// namespace
+
+int main(int argc, char* argv[])
+{
+	const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+	std::cout << "size " << size << "x" << size << ", " << mtx::detail::GetThreadsNumber() << " threads\n";
+	Run<int>("int", size);
+	Run<double>("double", size);
+
+	return 0;
+}
@@ -0,0 +1,404 @@
+#pragma once
+
+#include "matrix/Instrumentation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mtx
+{
+
+//! Alignment of the matrix storage by default, it is the size of a cache line
+//! and of the widest vector register.
+constexpr size_t defaultAlignment = 64;
+
+//! Standard allocator which places arrays at addresses aligned to Alignment bytes.
+template<typename T, size_t Alignment = defaultAlignment>
+class AlignedAllocator
+{
+	static_assert(Alignment >= alignof(void*) && (Alignment & (Alignment - 1)) == 0,
+		"AlignedAllocator: alignment must be a power of two not less than pointer alignment.");
+
+	//
+	// Alias declaration.
+	//
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	AlignedAllocator() = default;
+	//! Converting constructor.
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Allocates storage for n elements.
+	T* allocate(const size_t n);
+	//! Deallocates storage returned by allocate.
+	void deallocate(T* ptr, const size_t n) noexcept;
+};
+
+template<typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+	return true;
+}
+
+template<typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+	return false;
+}
+
+template<typename T, size_t Alignment>
+template<typename U>
+AlignedAllocator<T, Alignment>::AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+{
+}
+
+template<typename T, size_t Alignment>
+T* AlignedAllocator<T, Alignment>::allocate(const size_t n)
+{
+	if (n > (std::numeric_limits<size_t>::max() - Alignment - sizeof(void*)) / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+
+	// Over-allocate and keep the original pointer right before the aligned block.
+	void* raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void*));
+	const auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+	const auto aligned = (address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+	reinterpret_cast<void**>(aligned)[-1] = raw;
+
+	return reinterpret_cast<T*>(aligned);
+}
+
+template<typename T, size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(T* ptr, const size_t) noexcept
+{
+	if (ptr != nullptr) {
+		::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+	}
+}
+
+//! Monotonic memory resource: memory is taken from big chunks by bumping a pointer
+//! and is freed all at once by Release or by destructor. Deallocation of separate blocks
+//! does nothing, so short-lived intermediate matrices cost nothing to free.
+//! Arena isn't thread safe and must outlive everything allocated from it.
+class Arena
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, chunkSize is the minimum size in bytes of the memory chunks.
+	explicit Arena(const size_t chunkSize = 1 << 20);
+	//! Destructor.
+	~Arena() noexcept;
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns memory block of specified size and alignment.
+	void* Allocate(const size_t bytes, const size_t alignment);
+	//! Frees all blocks at once, the first chunk is kept for reuse.
+	void Release() noexcept;
+	//! Returns number of bytes given out since the last release.
+	size_t GetUsedBytes() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Minimum size of the chunk.
+	size_t chunkSize_;
+	//! Chunks of memory, the last one is the current.
+	std::vector<std::pair<unsigned char*, size_t>> chunks_;
+	//! Offset of the free space in the current chunk.
+	size_t offset_ = { 0 };
+	//! Number of bytes given out since the last release.
+	size_t usedBytes_ = { 0 };
+};
+
+inline Arena::Arena(const size_t chunkSize)
+	: chunkSize_{ std::max<size_t>(chunkSize, 1) }
+{
+}
+
+inline Arena::~Arena() noexcept
+{
+	for (const auto& chunk : chunks_) {
+		::operator delete(chunk.first);
+	}
+}
+
+inline void* Arena::Allocate(const size_t bytes, const size_t alignment)
+{
+	if (!chunks_.empty())
+	{
+		const auto& chunk = chunks_.back();
+		const auto base = reinterpret_cast<std::uintptr_t>(chunk.first);
+		const auto aligned = (base + offset_ + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+		if (aligned + bytes <= base + chunk.second)
+		{
+			offset_ = aligned + bytes - base;
+			usedBytes_ += bytes;
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+
+	if (bytes > std::numeric_limits<size_t>::max() - alignment) {
+		throw std::bad_alloc();
+	}
+
+	const size_t size = std::max(chunkSize_, bytes + alignment);
+	chunks_.reserve(chunks_.size() + 1);
+	chunks_.emplace_back(static_cast<unsigned char*>(::operator new(size)), size);
+	offset_ = 0;
+
+	return Allocate(bytes, alignment);
+}
+
+inline void Arena::Release() noexcept
+{
+	for (size_t i = 1; i < chunks_.size(); ++i) {
+		::operator delete(chunks_[i].first);
+	}
+	if (chunks_.size() > 1) {
+		chunks_.resize(1);
+	}
+	offset_ = 0;
+	usedBytes_ = 0;
+}
+
+inline size_t Arena::GetUsedBytes() const noexcept
+{
+	return usedBytes_;
+}
+
+//! Standard allocator which takes memory from the Arena, deallocation does nothing.
+//! Allocator is propagated together with the container content, so matrices which
+//! are moved or swapped keep using the arena their memory belongs to.
+template<typename T, size_t Alignment = defaultAlignment>
+class ArenaAllocator
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = ArenaAllocator<U, Alignment>;
+	};
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, allocator without arena throws std::bad_alloc on allocation.
+	ArenaAllocator() = default;
+	//! Constructor.
+	ArenaAllocator(Arena& arena) noexcept;
+	//! Converting constructor.
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U, Alignment>& other) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Allocates storage for n elements.
+	T* allocate(const size_t n);
+	//! Does nothing, memory is freed by the arena.
+	void deallocate(T* ptr, const size_t n) noexcept;
+	//! Returns arena used by the allocator.
+	Arena* GetArena() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Source of the memory.
+	Arena* arena_ = { nullptr };
+};
+
+template<typename T, typename U, size_t Alignment>
+bool operator==(const ArenaAllocator<T, Alignment>& left, const ArenaAllocator<U, Alignment>& right) noexcept
+{
+	return left.GetArena() == right.GetArena();
+}
+
+template<typename T, typename U, size_t Alignment>
+bool operator!=(const ArenaAllocator<T, Alignment>& left, const ArenaAllocator<U, Alignment>& right) noexcept
+{
+	return !(left == right);
+}
+
+template<typename T, size_t Alignment>
+ArenaAllocator<T, Alignment>::ArenaAllocator(Arena& arena) noexcept
+	: arena_{ &arena }
+{
+}
+
+template<typename T, size_t Alignment>
+template<typename U>
+ArenaAllocator<T, Alignment>::ArenaAllocator(const ArenaAllocator<U, Alignment>& other) noexcept
+	: arena_{ other.GetArena() }
+{
+}
+
+template<typename T, size_t Alignment>
+T* ArenaAllocator<T, Alignment>::allocate(const size_t n)
+{
+	if (arena_ == nullptr || n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+
+	return static_cast<T*>(arena_->Allocate(n * sizeof(T), std::max(Alignment, alignof(T))));
+}
+
+template<typename T, size_t Alignment>
+void ArenaAllocator<T, Alignment>::deallocate(T*, const size_t) noexcept
+{
+}
+
+template<typename T, size_t Alignment>
+Arena* ArenaAllocator<T, Alignment>::GetArena() const noexcept
+{
+	return arena_;
+}
+
+namespace detail
+{
+
+//! Adaptor of the allocator which default-initializes elements constructed
+//! without arguments instead of value-initializing them, so resizing a vector
+//! of trivial elements doesn't write to the memory at all.
+//! All other operations are forwarded to the adapted allocator.
+template<typename A>
+class DefaultInitAllocator
+	: public A
+{
+	//
+	// Alias declaration.
+	//
+public:
+	template<typename U>
+	struct rebind
+	{
+		using other = DefaultInitAllocator<typename std::allocator_traits<A>::template rebind_alloc<U>>;
+	};
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	DefaultInitAllocator() = default;
+	//! Constructor.
+	DefaultInitAllocator(const A& alloc) noexcept;
+	//! Converting constructor.
+	template<typename B>
+	DefaultInitAllocator(const DefaultInitAllocator<B>& other) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Default-initializes the element.
+	template<typename U>
+	void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value);
+	//! Constructs the element with the arguments using the adapted allocator.
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args);
+	//! Allocates storage using the adapted allocator, the allocation is counted by instrumentation.
+	typename std::allocator_traits<A>::pointer allocate(const size_t n);
+	//! Releases storage using the adapted allocator.
+	void deallocate(const typename std::allocator_traits<A>::pointer ptr, const size_t n);
+};
+
+template<typename A>
+DefaultInitAllocator<A>::DefaultInitAllocator(const A& alloc) noexcept
+	: A(alloc)
+{
+}
+
+template<typename A>
+template<typename B>
+DefaultInitAllocator<A>::DefaultInitAllocator(const DefaultInitAllocator<B>& other) noexcept
+	: A(static_cast<const B&>(other))
+{
+}
+
+template<typename A>
+template<typename U>
+void DefaultInitAllocator<A>::construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+{
+	::new(static_cast<void*>(ptr)) U;
+}
+
+template<typename A>
+template<typename U, typename... Args>
+void DefaultInitAllocator<A>::construct(U* ptr, Args&&... args)
+{
+	std::allocator_traits<A>::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+}
+
+template<typename A>
+typename std::allocator_traits<A>::pointer DefaultInitAllocator<A>::allocate(const size_t n)
+{
+	MTX_INSTRUMENT_ALLOCATION(n * sizeof(typename std::allocator_traits<A>::value_type));
+	return std::allocator_traits<A>::allocate(static_cast<A&>(*this), n);
+}
+
+template<typename A>
+void DefaultInitAllocator<A>::deallocate(const typename std::allocator_traits<A>::pointer ptr, const size_t n)
+{
+	MTX_INSTRUMENT_DEALLOCATION(n * sizeof(typename std::allocator_traits<A>::value_type));
+	std::allocator_traits<A>::deallocate(static_cast<A&>(*this), ptr, n);
+}
+
+template<typename A, typename B>
+bool operator==(const DefaultInitAllocator<A>& left, const DefaultInitAllocator<B>& right) noexcept
+{
+	return static_cast<const A&>(left) == static_cast<const B&>(right);
+}
+
+template<typename A, typename B>
+bool operator!=(const DefaultInitAllocator<A>& left, const DefaultInitAllocator<B>& right) noexcept
+{
+	return !(left == right);
+}
+
+}	// namespace detail
+
+}	// namespace mtx
\ No newline at end of file
@@ -0,0 +1,476 @@
+#pragma once
+
+#include "matrix/Allocator.h"
+#include "matrix/Instrumentation.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace mtx
+{
+
+//! Batch of matrices of the same sizes kept in a single buffer. Element (r, c) of all matrices
+//! forms a plane: planes follow each other in order of rows and element (r, c) of matrix b
+//! is element b of plane (r, c). Operations on the batch process a plane by a loop over
+//! matrices with the unit stride, so thousands of small matrices are processed by vector
+//! instructions without an allocation or a pointer per matrix.
+//! Planes are padded to the cache line, padding elements are value-initialized.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+class BatchedMatrix2D
+{
+	//
+	// Alias declaration.
+	//
+public:
+	//! Storage of the elements, see Matrix2D::Storage.
+	using Storage = std::vector<T, detail::DefaultInitAllocator<Alloc>>;
+	using AllocatorType = Alloc;
+	//! Non-owning views of a matrix of the batch.
+	using View = Matrix2DView<T>;
+	using ConstView = Matrix2DView<const T>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	BatchedMatrix2D() = default;
+	//! Constructor, all elements of count matrices rows x columns are set to defVal.
+	BatchedMatrix2D(
+		const size_t count,
+		const size_t rows,
+		const size_t columns,
+		const T& defVal = T(),
+		const Alloc& alloc = Alloc());
+	//! Constructor, elements are default-initialized, values of trivial types are indeterminate.
+	BatchedMatrix2D(
+		const size_t count,
+		const size_t rows,
+		const size_t columns,
+		UninitializedTag,
+		const Alloc& alloc = Alloc());
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of matrices.
+	size_t GetCount() const noexcept;
+	//! Returns number of rows of every matrix.
+	size_t GetRows() const noexcept;
+	//! Returns number of columns of every matrix.
+	size_t GetColumns() const noexcept;
+	//! Returns distance in elements between beginnings of two neighboring planes.
+	size_t GetPlaneStride() const noexcept;
+	//! Returns allocator of the storage.
+	Alloc GetAllocator() const;
+	//! Provides access to the element of the matrix.
+	T& operator()(const size_t matrix, const size_t row, const size_t column);
+	const T& operator()(const size_t matrix, const size_t row, const size_t column) const;
+	//! Returns pointer to element (row, column) of the first matrix, the same element
+	//! of the next matrices follows it.
+	T* Plane(const size_t row, const size_t column) noexcept;
+	const T* Plane(const size_t row, const size_t column) const noexcept;
+	//! Returns non-owning view of the matrix, so the matrix can be passed to functions
+	//! working on views of Matrix2D.
+	View GetView(const size_t matrix);
+	ConstView GetView(const size_t matrix) const;
+	//! Copies elements of the view into the matrix, sizes of the view must match.
+	void Set(const size_t matrix, const Matrix2DView<const T>& view);
+	//! Returns Matrix2D with copy of elements of the matrix.
+	Matrix2D<T, Alloc> ToMatrix2D(const size_t matrix) const;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Number of matrices.
+	size_t count_ = { 0 };
+	//! Number of rows of every matrix.
+	size_t rows_ = { 0 };
+	//! Number of columns of every matrix.
+	size_t columns_ = { 0 };
+	//! Distance in elements between beginnings of two neighboring planes.
+	size_t stride_ = { 0 };
+	//! Storage for elements of all matrices.
+	Storage elems_;
+};
+
+template<typename T, typename Alloc>
+BatchedMatrix2D<T, Alloc>::BatchedMatrix2D(
+	const size_t count,
+	const size_t rows,
+	const size_t columns,
+	const T& defVal,
+	const Alloc& alloc)
+	: count_{ count }
+	, rows_{ rows }
+	, columns_{ columns }
+	, stride_{ detail::PaddedRowLength(count, SimdRowPadding<T>()) }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, count_ * rows_ * columns_);
+	elems_.resize(rows_ * columns_ * stride_, T());
+	for (size_t i = 0; i < rows_ * columns_; ++i) {
+		std::fill_n(elems_.begin() + static_cast<std::ptrdiff_t>(i * stride_), count_, defVal);
+	}
+}
+
+template<typename T, typename Alloc>
+BatchedMatrix2D<T, Alloc>::BatchedMatrix2D(
+	const size_t count,
+	const size_t rows,
+	const size_t columns,
+	UninitializedTag,
+	const Alloc& alloc)
+	: count_{ count }
+	, rows_{ rows }
+	, columns_{ columns }
+	, stride_{ detail::PaddedRowLength(count, SimdRowPadding<T>()) }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, rows_ * columns_ * (stride_ - count_));
+	elems_.resize(rows_ * columns_ * stride_);
+	if (stride_ == count_) {
+		return;
+	}
+
+	for (size_t i = 0; i < rows_ * columns_; ++i)
+	{
+		const auto planeBegin = elems_.begin() + static_cast<std::ptrdiff_t>(i * stride_);
+		std::fill(planeBegin + static_cast<std::ptrdiff_t>(count_), planeBegin + static_cast<std::ptrdiff_t>(stride_), T());
+	}
+}
+
+template<typename T, typename Alloc>
+size_t BatchedMatrix2D<T, Alloc>::GetCount() const noexcept
+{
+	return count_;
+}
+
+template<typename T, typename Alloc>
+size_t BatchedMatrix2D<T, Alloc>::GetRows() const noexcept
+{
+	return rows_;
+}
+
+template<typename T, typename Alloc>
+size_t BatchedMatrix2D<T, Alloc>::GetColumns() const noexcept
+{
+	return columns_;
+}
+
+template<typename T, typename Alloc>
+size_t BatchedMatrix2D<T, Alloc>::GetPlaneStride() const noexcept
+{
+	return stride_;
+}
+
+template<typename T, typename Alloc>
+Alloc BatchedMatrix2D<T, Alloc>::GetAllocator() const
+{
+	return elems_.get_allocator();
+}
+
+template<typename T, typename Alloc>
+T& BatchedMatrix2D<T, Alloc>::operator()(const size_t matrix, const size_t row, const size_t column)
+{
+	return elems_[(row * columns_ + column) * stride_ + matrix];
+}
+
+template<typename T, typename Alloc>
+const T& BatchedMatrix2D<T, Alloc>::operator()(const size_t matrix, const size_t row, const size_t column) const
+{
+	return elems_[(row * columns_ + column) * stride_ + matrix];
+}
+
+template<typename T, typename Alloc>
+T* BatchedMatrix2D<T, Alloc>::Plane(const size_t row, const size_t column) noexcept
+{
+	return elems_.data() + (row * columns_ + column) * stride_;
+}
+
+template<typename T, typename Alloc>
+const T* BatchedMatrix2D<T, Alloc>::Plane(const size_t row, const size_t column) const noexcept
+{
+	return elems_.data() + (row * columns_ + column) * stride_;
+}
+
+template<typename T, typename Alloc>
+typename BatchedMatrix2D<T, Alloc>::View BatchedMatrix2D<T, Alloc>::GetView(const size_t matrix)
+{
+	if (matrix >= count_) {
+		throw std::out_of_range("BatchedMatrix2D::GetView: argument is out of range.");
+	}
+
+	return View(
+		elems_.data() + matrix,
+		rows_,
+		columns_,
+		static_cast<std::ptrdiff_t>(columns_ * stride_),
+		static_cast<std::ptrdiff_t>(stride_));
+}
+
+template<typename T, typename Alloc>
+typename BatchedMatrix2D<T, Alloc>::ConstView BatchedMatrix2D<T, Alloc>::GetView(const size_t matrix) const
+{
+	if (matrix >= count_) {
+		throw std::out_of_range("BatchedMatrix2D::GetView: argument is out of range.");
+	}
+
+	return ConstView(
+		elems_.data() + matrix,
+		rows_,
+		columns_,
+		static_cast<std::ptrdiff_t>(columns_ * stride_),
+		static_cast<std::ptrdiff_t>(stride_));
+}
+
+template<typename T, typename Alloc>
+void BatchedMatrix2D<T, Alloc>::Set(const size_t matrix, const Matrix2DView<const T>& view)
+{
+	if (view.GetRows() != rows_ || view.GetColumns() != columns_) {
+		throw std::length_error("BatchedMatrix2D::Set: sizes of matrices don't match.");
+	}
+
+	const auto destination = GetView(matrix);
+	for (size_t r = 0; r < rows_; ++r)
+	{
+		for (size_t c = 0; c < columns_; ++c) {
+			destination(r, c) = view(r, c);
+		}
+	}
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> BatchedMatrix2D<T, Alloc>::ToMatrix2D(const size_t matrix) const
+{
+	const auto source = GetView(matrix);
+	Matrix2D<T, Alloc> mat(rows_, columns_, GetAllocator());
+	for (size_t r = 0; r < rows_; ++r)
+	{
+		for (size_t c = 0; c < columns_; ++c) {
+			mat(r, c) = source(r, c);
+		}
+	}
+
+	return mat;
+}
+
+//! Provides "equal to" operator for batches, padding of planes isn't compared.
+template<typename T, typename Alloc>
+bool operator==(const BatchedMatrix2D<T, Alloc>& left, const BatchedMatrix2D<T, Alloc>& right)
+{
+	if (left.GetCount() != right.GetCount()
+		|| left.GetRows() != right.GetRows()
+		|| left.GetColumns() != right.GetColumns())
+	{
+		return false;
+	}
+
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < left.GetColumns(); ++c)
+		{
+			if (!detail::EqualRange(left.Plane(r, c), right.Plane(r, c), left.GetCount())) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename T, typename Alloc>
+bool operator!=(const BatchedMatrix2D<T, Alloc>& left, const BatchedMatrix2D<T, Alloc>& right)
+{
+	return !(left == right);
+}
+
+//! Writes results of TransformMatrices for every pair of matrices of the batches into
+//! the existing result batch, doesn't allocate. Planes are transformed by vectorized loops,
+//! blocks of planes are processed according to the policy.
+template<typename Policy, typename T, typename Alloc, typename BinaryOp>
+detail::EnableIfPolicy<Policy> TransformMatrices(
+	const Policy& policy,
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BatchedMatrix2D<T, Alloc>& result,
+	BinaryOp func)
+{
+	bool sizesMismatch =
+		left.GetCount() != right.GetCount()
+		|| left.GetRows() != right.GetRows()
+		|| left.GetColumns() != right.GetColumns()
+		|| left.GetCount() != result.GetCount()
+		|| left.GetRows() != result.GetRows()
+		|| left.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(TransformMatrices, 3 * left.GetCount() * left.GetRows() * left.GetColumns());
+	const size_t columns = left.GetColumns();
+	const size_t count = left.GetCount();
+	detail::ParallelFor(
+		policy,
+		0,
+		left.GetRows() * columns,
+		detail::RowsPerBlock(count),
+		[&] (const size_t first, const size_t last)
+		{
+			for (size_t i = first; i < last; ++i)
+			{
+				const size_t r = i / columns;
+				const size_t c = i % columns;
+				detail::TransformRange(left.Plane(r, c), right.Plane(r, c), result.Plane(r, c), count, func);
+			}
+		});
+}
+
+//! Same as above, the batches are processed by the calling thread.
+template<typename T, typename Alloc, typename BinaryOp>
+void TransformMatrices(
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BatchedMatrix2D<T, Alloc>& result,
+	BinaryOp func)
+{
+	TransformMatrices(execution::seq, left, right, result, func);
+}
+
+//! Returns batch of results of TransformMatrices for every pair of matrices of the batches,
+//! blocks of planes are processed according to the policy.
+template<typename Policy, typename T, typename Alloc, typename BinaryOp>
+detail::EnableIfPolicy<Policy, BatchedMatrix2D<T, Alloc>> TransformMatrices(
+	const Policy& policy,
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BinaryOp func)
+{
+	BatchedMatrix2D<T, Alloc> result(
+		left.GetCount(),
+		left.GetRows(),
+		left.GetColumns(),
+		uninitialized,
+		left.GetAllocator());
+	TransformMatrices(policy, left, right, result, func);
+
+	return result;
+}
+
+//! Same as above, the batches are processed by the calling thread.
+template<typename T, typename Alloc, typename BinaryOp>
+BatchedMatrix2D<T, Alloc> TransformMatrices(
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BinaryOp func)
+{
+	return TransformMatrices(execution::seq, left, right, func);
+}
+
+//! Writes products of every pair of matrices of the batches into the existing result batch,
+//! doesn't allocate. Result must not overlap with arguments. Every plane of the result
+//! accumulates products of planes of the arguments, so the innermost loop runs over matrices.
+//! Rows of the result are processed according to the policy.
+template<typename Policy, typename T, typename Alloc>
+detail::EnableIfPolicy<Policy> Multiply(
+	const Policy& policy,
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BatchedMatrix2D<T, Alloc>& result)
+{
+	bool sizesMismatch =
+		left.GetCount() != right.GetCount()
+		|| left.GetColumns() != right.GetRows()
+		|| left.GetCount() != result.GetCount()
+		|| left.GetRows() != result.GetRows()
+		|| right.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("Multiply: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(
+		Multiply,
+		left.GetCount()
+			* (left.GetRows() * left.GetColumns() + right.GetRows() * right.GetColumns() + left.GetRows() * right.GetColumns()));
+	const size_t count = left.GetCount();
+	const size_t depth = left.GetColumns();
+	const size_t columns = right.GetColumns();
+	detail::ParallelFor(
+		policy,
+		0,
+		left.GetRows(),
+		detail::RowsPerBlock(count * columns * std::max<size_t>(depth, 1)),
+		[&] (const size_t first, const size_t last)
+		{
+			for (size_t r = first; r < last; ++r)
+			{
+				for (size_t c = 0; c < columns; ++c)
+				{
+					T* product = result.Plane(r, c);
+					std::fill(product, product + count, T());
+					for (size_t k = 0; k < depth; ++k)
+					{
+						const T* leftPlane = left.Plane(r, k);
+						const T* rightPlane = right.Plane(k, c);
+						for (size_t b = 0; b < count; ++b) {
+							product[b] += leftPlane[b] * rightPlane[b];
+						}
+					}
+				}
+			}
+		});
+}
+
+//! Same as above, the batches are multiplied by the calling thread.
+template<typename T, typename Alloc>
+void Multiply(
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right,
+	BatchedMatrix2D<T, Alloc>& result)
+{
+	Multiply(execution::seq, left, right, result);
+}
+
+//! Returns batch of products of every pair of matrices of the batches,
+//! rows of the result are processed according to the policy.
+template<typename Policy, typename T, typename Alloc>
+detail::EnableIfPolicy<Policy, BatchedMatrix2D<T, Alloc>> Multiply(
+	const Policy& policy,
+	const BatchedMatrix2D<T, Alloc>& left,
+	const BatchedMatrix2D<T, Alloc>& right)
+{
+	BatchedMatrix2D<T, Alloc> result(
+		left.GetCount(),
+		left.GetRows(),
+		right.GetColumns(),
+		uninitialized,
+		left.GetAllocator());
+	Multiply(policy, left, right, result);
+
+	return result;
+}
+
+//! Same as above, the batches are multiplied by the calling thread.
+template<typename T, typename Alloc>
+BatchedMatrix2D<T, Alloc> Multiply(const BatchedMatrix2D<T, Alloc>& left, const BatchedMatrix2D<T, Alloc>& right)
+{
+	return Multiply(execution::seq, left, right);
+}
+
+//! Returns batch of products of every pair of matrices of the batches.
+template<typename T, typename Alloc>
+BatchedMatrix2D<T, Alloc> operator*(const BatchedMatrix2D<T, Alloc>& left, const BatchedMatrix2D<T, Alloc>& right)
+{
+	return Multiply(left, right);
+}
+
+}	// namespace mtx
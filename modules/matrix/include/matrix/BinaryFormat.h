@@ -0,0 +1,285 @@
+#pragma once
+
+#include "matrix/Allocator.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mtx
+{
+
+//! Type of elements stored in the binary file.
+enum class ElementType : std::uint32_t
+{
+	Int8 = 1,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Int64,
+	UInt64,
+	Float32,
+	Float64
+};
+
+//! Header of the binary file with a matrix, it takes 64 bytes at the beginning of the file
+//! and is followed by rows of elements starting at dataOffset_. Every row takes rowStride_
+//! elements, elements after the last column are padding. All fields and elements are
+//! stored in byte order of the machine which wrote the file, see byteOrder_.
+struct BinaryHeader
+{
+	//! Identifies the format.
+	char magic_[8] = { 'M', 'T', 'X', '2', 'D', 'B', 'I', 'N' };
+	//! Version of the format.
+	std::uint32_t version_ = { 1 };
+	//! Type of elements.
+	ElementType elementType_ = { ElementType::Int8 };
+	//! Size of an element in bytes.
+	std::uint32_t elementSize_ = { 0 };
+	//! Written as 0x01020304, so the value shows whether byte order of the file is native.
+	std::uint32_t byteOrder_ = { 0x01020304 };
+	//! Data offset is a multiple of the alignment, so rows of a mapped file are aligned.
+	std::uint32_t alignment_ = { static_cast<std::uint32_t>(defaultAlignment) };
+	//! Padding of rows of the saved matrix, see RowPadding.
+	std::uint32_t rowPadding_ = { 1 };
+	//! Number of rows.
+	std::uint64_t rows_ = { 0 };
+	//! Number of columns.
+	std::uint64_t columns_ = { 0 };
+	//! Distance in elements between beginnings of two neighboring rows.
+	std::uint64_t rowStride_ = { 0 };
+	//! Offset of the first element from the beginning of the file in bytes.
+	std::uint64_t dataOffset_ = { 64 };
+};
+
+static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader: unexpected size of the header.");
+
+namespace detail
+{
+
+//! Maps type of elements to the type tag of the binary format.
+template<typename T>
+constexpr ElementType GetElementType() noexcept
+{
+	static_assert(
+		(std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8)
+		|| std::is_same<T, float>::value
+		|| std::is_same<T, double>::value,
+		"Binary format supports integral types except bool, float and double.");
+
+	return std::is_same<T, float>::value ? ElementType::Float32
+		: std::is_same<T, double>::value ? ElementType::Float64
+		: sizeof(T) == 1 ? (std::is_signed<T>::value ? ElementType::Int8 : ElementType::UInt8)
+		: sizeof(T) == 2 ? (std::is_signed<T>::value ? ElementType::Int16 : ElementType::UInt16)
+		: sizeof(T) == 4 ? (std::is_signed<T>::value ? ElementType::Int32 : ElementType::UInt32)
+		: (std::is_signed<T>::value ? ElementType::Int64 : ElementType::UInt64);
+}
+
+//! Reverses order of bytes of the value.
+template<typename T>
+void SwapBytes(T& value) noexcept
+{
+	auto* bytes = reinterpret_cast<unsigned char*>(&value);
+	std::reverse(bytes, bytes + sizeof(T));
+}
+
+//! Reverses order of bytes of all fields of the header.
+inline void SwapBytes(BinaryHeader& header) noexcept
+{
+	SwapBytes(header.version_);
+	SwapBytes(header.elementType_);
+	SwapBytes(header.elementSize_);
+	SwapBytes(header.byteOrder_);
+	SwapBytes(header.alignment_);
+	SwapBytes(header.rowPadding_);
+	SwapBytes(header.rows_);
+	SwapBytes(header.columns_);
+	SwapBytes(header.rowStride_);
+	SwapBytes(header.dataOffset_);
+}
+
+//! Returns header describing matrix of T with specified sizes and padding.
+template<typename T>
+BinaryHeader MakeBinaryHeader(const size_t rows, const size_t columns, const RowPadding padding)
+{
+	BinaryHeader header;
+	header.elementType_ = GetElementType<T>();
+	header.elementSize_ = sizeof(T);
+	header.rowPadding_ = static_cast<std::uint32_t>(std::max<size_t>(padding.multiple_, 1));
+	header.rows_ = rows;
+	header.columns_ = columns;
+	header.rowStride_ = PaddedRowLength(columns, padding);
+
+	return header;
+}
+
+//! Checks that the header describes matrix of T and returns size of its data in bytes.
+//! Fields of the header must be in native byte order.
+template<typename T>
+size_t CheckBinaryHeader(const BinaryHeader& header, const char* function)
+{
+	const BinaryHeader expected;
+	if (std::memcmp(header.magic_, expected.magic_, sizeof(expected.magic_)) != 0
+		|| header.version_ != expected.version_)
+	{
+		throw std::runtime_error(std::string(function) + ": unknown format of the file.");
+	}
+	if (header.elementType_ != GetElementType<T>() || header.elementSize_ != sizeof(T)) {
+		throw std::runtime_error(std::string(function) + ": type of elements doesn't match.");
+	}
+
+	const auto maxSize = std::numeric_limits<size_t>::max();
+	bool invalidSizes =
+		header.rowStride_ < header.columns_
+		|| header.dataOffset_ < sizeof(BinaryHeader)
+		|| header.rowPadding_ == 0
+		|| header.rowStride_ != PaddedRowLength(static_cast<size_t>(header.columns_), RowPadding{ header.rowPadding_ })
+		|| header.rows_ > maxSize
+		|| header.rowStride_ > maxSize
+		|| (header.rowStride_ != 0 && header.rows_ > maxSize / sizeof(T) / header.rowStride_);
+
+	if (invalidSizes) {
+		throw std::runtime_error(std::string(function) + ": header of the file is corrupted.");
+	}
+
+	return static_cast<size_t>(header.rows_ * header.rowStride_ * sizeof(T));
+}
+
+}	// namespace detail
+
+//! Writes matrix viewed by view to the stream in the binary format.
+//! Rows are padded with zeros as requested by padding.
+template<typename T>
+void Save(const Matrix2DView<T>& view, std::ostream& stream, const RowPadding padding = RowPadding{})
+{
+	using ValueType = std::remove_const_t<T>;
+	const auto header = detail::MakeBinaryHeader<ValueType>(view.GetRows(), view.GetColumns(), padding);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// Rows are gathered into a buffer, so views with any strides are written the same way.
+	const size_t stride = static_cast<size_t>(header.rowStride_);
+	std::vector<ValueType> row(stride, ValueType());
+	for (size_t r = 0; r < view.GetRows(); ++r)
+	{
+		const auto rowView = view.Row(r);
+		std::copy(rowView.Begin(), rowView.End(), row.begin());
+		stream.write(
+			reinterpret_cast<const char*>(row.data()),
+			static_cast<std::streamsize>(stride * sizeof(ValueType)));
+	}
+
+	if (!stream) {
+		throw std::runtime_error("Save: failed to write the matrix.");
+	}
+}
+
+//! Writes the matrix to the stream in the binary format, padding of rows is kept.
+//! Files keep rows one by one, so column-major matrices are written through the view.
+template<typename T, typename Alloc>
+void Save(const Matrix2D<T, Alloc>& mat, std::ostream& stream)
+{
+	if (mat.GetLayout() != Layout::RowMajor)
+	{
+		Save(mat.GetView(), stream);
+		return;
+	}
+
+	const auto header = detail::MakeBinaryHeader<T>(mat.GetRows(), mat.GetColumns(), mat.GetRowPadding());
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	// Storage has the same layout as the file, padding elements are value-initialized.
+	const auto size = static_cast<std::streamsize>(mat.GetRows() * mat.GetRowStride() * sizeof(T));
+	if (size > 0) {
+		stream.write(reinterpret_cast<const char*>(mat.GetView().Data()), size);
+	}
+
+	if (!stream) {
+		throw std::runtime_error("Save: failed to write the matrix.");
+	}
+}
+
+//! Writes the matrix to the file in the binary format, the file is overwritten.
+template<typename T, typename Alloc>
+void Save(const Matrix2D<T, Alloc>& mat, const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("Save: file can't be opened.");
+	}
+
+	Save(mat, file);
+}
+
+//! Reads header of the binary file and converts it to native byte order.
+//! Returns true if elements are stored in the foreign byte order.
+inline bool ReadBinaryHeader(std::istream& stream, BinaryHeader& header)
+{
+	if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		throw std::runtime_error("Load: unexpected end of the file.");
+	}
+
+	const BinaryHeader expected;
+	if (header.byteOrder_ == expected.byteOrder_) {
+		return false;
+	}
+
+	detail::SwapBytes(header);
+	if (header.byteOrder_ != expected.byteOrder_) {
+		throw std::runtime_error("Load: unknown format of the file.");
+	}
+
+	return true;
+}
+
+//! Reads matrix of T written by Save from the stream, padding of rows is restored.
+//! Files written on machines with different byte order are converted.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+Matrix2D<T, Alloc> Load(std::istream& stream, const Alloc& alloc = Alloc())
+{
+	BinaryHeader header;
+	const bool swapped = ReadBinaryHeader(stream, header);
+	const size_t bytes = detail::CheckBinaryHeader<T>(header, "Load");
+	stream.ignore(static_cast<std::streamsize>(header.dataOffset_ - sizeof(header)));
+
+	Matrix2D<T, Alloc> mat(
+		typename Matrix2D<T, Alloc>::Dimension{
+			static_cast<size_t>(header.rows_),
+			static_cast<size_t>(header.columns_) },
+		RowPadding{ header.rowPadding_ },
+		uninitialized,
+		alloc);
+	if (bytes > 0 && !stream.read(reinterpret_cast<char*>(mat.GetView().Data()), static_cast<std::streamsize>(bytes))) {
+		throw std::runtime_error("Load: unexpected end of the file.");
+	}
+
+	if (swapped) {
+		std::for_each(mat.Begin(), mat.End(), [] (T& value) { detail::SwapBytes(value); });
+	}
+
+	return mat;
+}
+
+//! Reads matrix of T written by Save from the file.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+Matrix2D<T, Alloc> Load(const std::string& path, const Alloc& alloc = Alloc())
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Load: file can't be opened.");
+	}
+
+	return Load<T, Alloc>(file, alloc);
+}
+
+}	// namespace mtx
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "matrix/Allocator.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mtx
+{
+
+namespace detail
+{
+
+//! Returns array of results of func(left[i], right[i]), the pack expansion unrolls the loop.
+template<typename T, size_t N, typename BinaryOp, size_t... I>
+constexpr std::array<T, N> TransformArrays(
+	const std::array<T, N>& left,
+	const std::array<T, N>& right,
+	BinaryOp func,
+	std::index_sequence<I...>)
+{
+	return std::array<T, N>{ { func(left[I], right[I])... } };
+}
+
+//! Returns array of N copies of the value.
+template<typename T, size_t N, size_t... I>
+constexpr std::array<T, N> FilledArray(const T& value, std::index_sequence<I...>)
+{
+	return std::array<T, N>{ { (static_cast<void>(I), value)... } };
+}
+
+//! Returns elements of the identity matrix with C columns stored by rows.
+template<typename T, size_t C, size_t... I>
+constexpr std::array<T, sizeof...(I)> IdentityArray(std::index_sequence<I...>)
+{
+	return std::array<T, sizeof...(I)>{ { (I / C == I % C ? static_cast<T>(1) : T())... } };
+}
+
+//! Returns element (r, c) of the product of left R x K and right K x C matrices stored by rows.
+template<typename T, size_t K, size_t C, size_t LeftSize, size_t RightSize>
+constexpr T RowByColumn(
+	const std::array<T, LeftSize>& left,
+	const std::array<T, RightSize>& right,
+	const size_t r,
+	const size_t c)
+{
+	T sum = T();
+	for (size_t k = 0; k < K; ++k) {
+		sum += left[r * K + k] * right[k * C + c];
+	}
+
+	return sum;
+}
+
+//! Returns product of left R x K and right K x C matrices stored by rows,
+//! elements of the result are expanded from the pack.
+template<typename T, size_t K, size_t C, size_t LeftSize, size_t RightSize, size_t... I>
+constexpr std::array<T, sizeof...(I)> MultiplyArrays(
+	const std::array<T, LeftSize>& left,
+	const std::array<T, RightSize>& right,
+	std::index_sequence<I...>)
+{
+	return std::array<T, sizeof...(I)>{ { RowByColumn<T, K, C>(left, right, I / C, I % C)... } };
+}
+
+}	// namespace detail
+
+//! Matrix with sizes known at compile time, elements are stored by rows inside the object,
+//! so small matrices don't allocate and live on the stack or inside other objects.
+//! Arithmetic is constexpr and loops over elements are unrolled, operations on matrices
+//! of different sizes are rejected at compile time.
+template<typename T, size_t R, size_t C>
+class FixedMatrix2D
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using Storage = std::array<T, R * C>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, elements are value-initialized.
+	constexpr FixedMatrix2D() noexcept(std::is_nothrow_default_constructible<T>::value);
+	//! Constructor from elements in order of rows.
+	constexpr explicit FixedMatrix2D(const Storage& elements);
+	//! Constructor from R * C elements in order of rows.
+	template<typename... Args, typename = std::enable_if_t<sizeof...(Args) == R * C && (R * C > 1)>>
+	constexpr FixedMatrix2D(const Args&... elements);
+	//! Constructor, copies elements of the view, sizes of the view must match.
+	explicit FixedMatrix2D(const Matrix2DView<const T>& view);
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns matrix with all elements equal to the value.
+	static constexpr FixedMatrix2D Filled(const T& value);
+	//! Returns identity matrix.
+	static constexpr FixedMatrix2D Identity();
+	//! Returns number of rows.
+	static constexpr size_t GetRows() noexcept;
+	//! Returns number of columns.
+	static constexpr size_t GetColumns() noexcept;
+	//! Returns number of elements.
+	static constexpr size_t GetSize() noexcept;
+	//! Returns the element.
+	constexpr const T& operator()(const size_t row, const size_t column) const;
+	T& operator()(const size_t row, const size_t column);
+	//! Returns elements in order of rows.
+	constexpr const Storage& GetElements() const noexcept;
+	//! Returns iterators over elements in order of rows.
+	T* Begin() noexcept;
+	T* End() noexcept;
+	const T* Begin() const noexcept;
+	const T* End() const noexcept;
+	//! Returns view of the elements, so the matrix can be passed to functions working
+	//! on views of Matrix2D.
+	Matrix2DView<T> GetView() noexcept;
+	Matrix2DView<const T> GetView() const noexcept;
+	//! Returns Matrix2D with copy of the elements.
+	template<typename Alloc = AlignedAllocator<T>>
+	Matrix2D<T, Alloc> ToMatrix2D(const Alloc& alloc = Alloc()) const;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Elements in order of rows.
+	Storage elements_;
+};
+
+template<typename T, size_t R, size_t C>
+constexpr FixedMatrix2D<T, R, C>::FixedMatrix2D() noexcept(std::is_nothrow_default_constructible<T>::value)
+	: elements_{}
+{
+}
+
+template<typename T, size_t R, size_t C>
+constexpr FixedMatrix2D<T, R, C>::FixedMatrix2D(const Storage& elements)
+	: elements_(elements)
+{
+}
+
+template<typename T, size_t R, size_t C>
+template<typename... Args, typename>
+constexpr FixedMatrix2D<T, R, C>::FixedMatrix2D(const Args&... elements)
+	: elements_{ { static_cast<T>(elements)... } }
+{
+}
+
+template<typename T, size_t R, size_t C>
+FixedMatrix2D<T, R, C>::FixedMatrix2D(const Matrix2DView<const T>& view)
+	: elements_{}
+{
+	if (view.GetRows() != R || view.GetColumns() != C) {
+		throw std::length_error("FixedMatrix2D: sizes of matrices don't match.");
+	}
+
+	for (size_t r = 0; r < R; ++r)
+	{
+		for (size_t c = 0; c < C; ++c) {
+			elements_[r * C + c] = view(r, c);
+		}
+	}
+}
+
+template<typename T, size_t R, size_t C>
+constexpr FixedMatrix2D<T, R, C> FixedMatrix2D<T, R, C>::Filled(const T& value)
+{
+	return FixedMatrix2D(detail::FilledArray<T, R * C>(value, std::make_index_sequence<R * C>()));
+}
+
+template<typename T, size_t R, size_t C>
+constexpr FixedMatrix2D<T, R, C> FixedMatrix2D<T, R, C>::Identity()
+{
+	return FixedMatrix2D(detail::IdentityArray<T, C>(std::make_index_sequence<R * C>()));
+}
+
+template<typename T, size_t R, size_t C>
+constexpr size_t FixedMatrix2D<T, R, C>::GetRows() noexcept
+{
+	return R;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr size_t FixedMatrix2D<T, R, C>::GetColumns() noexcept
+{
+	return C;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr size_t FixedMatrix2D<T, R, C>::GetSize() noexcept
+{
+	return R * C;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr const T& FixedMatrix2D<T, R, C>::operator()(const size_t row, const size_t column) const
+{
+	return elements_[row * C + column];
+}
+
+template<typename T, size_t R, size_t C>
+T& FixedMatrix2D<T, R, C>::operator()(const size_t row, const size_t column)
+{
+	return elements_[row * C + column];
+}
+
+template<typename T, size_t R, size_t C>
+constexpr const typename FixedMatrix2D<T, R, C>::Storage& FixedMatrix2D<T, R, C>::GetElements() const noexcept
+{
+	return elements_;
+}
+
+template<typename T, size_t R, size_t C>
+T* FixedMatrix2D<T, R, C>::Begin() noexcept
+{
+	return elements_.data();
+}
+
+template<typename T, size_t R, size_t C>
+T* FixedMatrix2D<T, R, C>::End() noexcept
+{
+	return elements_.data() + R * C;
+}
+
+template<typename T, size_t R, size_t C>
+const T* FixedMatrix2D<T, R, C>::Begin() const noexcept
+{
+	return elements_.data();
+}
+
+template<typename T, size_t R, size_t C>
+const T* FixedMatrix2D<T, R, C>::End() const noexcept
+{
+	return elements_.data() + R * C;
+}
+
+template<typename T, size_t R, size_t C>
+Matrix2DView<T> FixedMatrix2D<T, R, C>::GetView() noexcept
+{
+	return Matrix2DView<T>(elements_.data(), R, C, static_cast<std::ptrdiff_t>(C));
+}
+
+template<typename T, size_t R, size_t C>
+Matrix2DView<const T> FixedMatrix2D<T, R, C>::GetView() const noexcept
+{
+	return Matrix2DView<const T>(elements_.data(), R, C, static_cast<std::ptrdiff_t>(C));
+}
+
+template<typename T, size_t R, size_t C>
+template<typename Alloc>
+Matrix2D<T, Alloc> FixedMatrix2D<T, R, C>::ToMatrix2D(const Alloc& alloc) const
+{
+	Matrix2D<T, Alloc> mat(R, C, alloc);
+	for (size_t r = 0; r < R; ++r)
+	{
+		for (size_t c = 0; c < C; ++c) {
+			mat(r, c) = elements_[r * C + c];
+		}
+	}
+
+	return mat;
+}
+
+//! Returns matrix where elements are results of resultMat(r, c) = func(left(r, c), right(r, c)).
+//! The result is constexpr if func is.
+template<typename T, size_t R, size_t C, size_t OtherR, size_t OtherC, typename BinaryOp>
+constexpr FixedMatrix2D<T, R, C> TransformMatrices(
+	const FixedMatrix2D<T, R, C>& left,
+	const FixedMatrix2D<T, OtherR, OtherC>& right,
+	BinaryOp func)
+{
+	static_assert(R == OtherR && C == OtherC, "TransformMatrices: sizes of matrices don't match.");
+
+	return FixedMatrix2D<T, R, C>(detail::TransformArrays(
+		left.GetElements(),
+		right.GetElements(),
+		func,
+		std::make_index_sequence<R * C>()));
+}
+
+template<typename T, size_t R, size_t C, size_t OtherR, size_t OtherC>
+constexpr FixedMatrix2D<T, R, C> operator+(
+	const FixedMatrix2D<T, R, C>& left,
+	const FixedMatrix2D<T, OtherR, OtherC>& right)
+{
+	static_assert(R == OtherR && C == OtherC, "operator+: sizes of matrices don't match.");
+
+	return TransformMatrices(left, right, std::plus<T>());
+}
+
+template<typename T, size_t R, size_t C, size_t OtherR, size_t OtherC>
+constexpr FixedMatrix2D<T, R, C> operator-(
+	const FixedMatrix2D<T, R, C>& left,
+	const FixedMatrix2D<T, OtherR, OtherC>& right)
+{
+	static_assert(R == OtherR && C == OtherC, "operator-: sizes of matrices don't match.");
+
+	return TransformMatrices(left, right, std::minus<T>());
+}
+
+//! Returns product of matrices, number of columns of the left matrix must be equal
+//! to number of rows of the right one.
+template<typename T, size_t R, size_t K, size_t OtherK, size_t C>
+constexpr FixedMatrix2D<T, R, C> Multiply(
+	const FixedMatrix2D<T, R, K>& left,
+	const FixedMatrix2D<T, OtherK, C>& right)
+{
+	static_assert(K == OtherK, "Multiply: sizes of matrices don't match.");
+
+	return FixedMatrix2D<T, R, C>(detail::MultiplyArrays<T, K, C>(
+		left.GetElements(),
+		right.GetElements(),
+		std::make_index_sequence<R * C>()));
+}
+
+template<typename T, size_t R, size_t K, size_t OtherK, size_t C>
+constexpr FixedMatrix2D<T, R, C> operator*(
+	const FixedMatrix2D<T, R, K>& left,
+	const FixedMatrix2D<T, OtherK, C>& right)
+{
+	return Multiply(left, right);
+}
+
+template<typename T, size_t R, size_t C>
+constexpr bool operator==(const FixedMatrix2D<T, R, C>& left, const FixedMatrix2D<T, R, C>& right)
+{
+	for (size_t i = 0; i < R * C; ++i)
+	{
+		if (!(left.GetElements()[i] == right.GetElements()[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr bool operator!=(const FixedMatrix2D<T, R, C>& left, const FixedMatrix2D<T, R, C>& right)
+{
+	return !(left == right);
+}
+
+}	// namespace mtx
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace mtx
+{
+namespace detail
+{
+
+//! Blocking parameters of the matrix multiplication kernel.
+//! Micro-kernel computes kernelRows x kernelColumns block of the result in registers,
+//! packed panel of the right matrix (depthBlock x columnsBlock) is meant to stay in L3,
+//! packed block of the left matrix (rowsBlock x depthBlock) is meant to stay in L2.
+template<typename T>
+struct GemmBlocking
+{
+	static constexpr size_t kernelRows = 4;
+	static constexpr size_t kernelColumns = sizeof(T) >= 8 ? 4 : 8;
+	static constexpr size_t rowsBlock = 96;
+	static constexpr size_t depthBlock = 256;
+	static constexpr size_t columnsBlock = 2048;
+};
+
+//! Copies rows x depth block of the left matrix into panels of kernelRows rows,
+//! panel is stored column by column. Missing rows of the last panel are filled with zeros.
+template<typename T>
+void PackLeft(const Matrix2DView<const T>& left, const size_t rows, const size_t depth, T* packed)
+{
+	constexpr size_t mr = GemmBlocking<T>::kernelRows;
+	for (size_t i0 = 0; i0 < rows; i0 += mr)
+	{
+		const size_t panelRows = std::min(mr, rows - i0);
+		for (size_t k = 0; k < depth; ++k)
+		{
+			for (size_t i = 0; i < panelRows; ++i) {
+				packed[i] = left(i0 + i, k);
+			}
+			for (size_t i = panelRows; i < mr; ++i) {
+				packed[i] = T{};
+			}
+			packed += mr;
+		}
+	}
+}
+
+//! Copies depth x columns block of the right matrix into panels of kernelColumns columns,
+//! panel is stored row by row. Missing columns of the last panel are filled with zeros.
+template<typename T>
+void PackRight(const Matrix2DView<const T>& right, const size_t depth, const size_t columns, T* packed)
+{
+	constexpr size_t nr = GemmBlocking<T>::kernelColumns;
+	for (size_t j0 = 0; j0 < columns; j0 += nr)
+	{
+		const size_t panelColumns = std::min(nr, columns - j0);
+		for (size_t k = 0; k < depth; ++k)
+		{
+			for (size_t j = 0; j < panelColumns; ++j) {
+				packed[j] = right(k, j0 + j);
+			}
+			for (size_t j = panelColumns; j < nr; ++j) {
+				packed[j] = T{};
+			}
+			packed += nr;
+		}
+	}
+}
+
+//! Multiplies packed panels and adds rows x columns part of the product to the result.
+template<typename T>
+void GemmMicroKernel(
+	const size_t depth,
+	const T* packedLeft,
+	const T* packedRight,
+	const Matrix2DView<T>& result,
+	const size_t rows,
+	const size_t columns)
+{
+	constexpr size_t mr = GemmBlocking<T>::kernelRows;
+	constexpr size_t nr = GemmBlocking<T>::kernelColumns;
+
+	T acc[mr][nr] = {};
+	for (size_t k = 0; k < depth; ++k)
+	{
+		for (size_t i = 0; i < mr; ++i)
+		{
+			const T leftVal = packedLeft[i];
+			for (size_t j = 0; j < nr; ++j) {
+				acc[i][j] += leftVal * packedRight[j];
+			}
+		}
+		packedLeft += mr;
+		packedRight += nr;
+	}
+
+	for (size_t i = 0; i < rows; ++i)
+	{
+		for (size_t j = 0; j < columns; ++j) {
+			result(i, j) += acc[i][j];
+		}
+	}
+}
+
+//! Calculates result = left * right. Result must not overlap with arguments.
+//! Work is split between threads by blocks of rows of the result.
+template<typename T>
+void Gemm(
+	const Matrix2DView<const T>& left,
+	const Matrix2DView<const T>& right,
+	const Matrix2DView<T>& result)
+{
+	using Blocking = GemmBlocking<T>;
+	constexpr size_t mr = Blocking::kernelRows;
+	constexpr size_t nr = Blocking::kernelColumns;
+
+	const size_t rows = left.GetRows();
+	const size_t depth = left.GetColumns();
+	const size_t columns = right.GetColumns();
+
+	if (rows == 0 || columns == 0) {
+		return;
+	}
+
+	// Make blocks of rows smaller for small matrices so every thread gets some work.
+	const size_t rowsPerThread = (rows + GetThreadsNumber() - 1) / GetThreadsNumber();
+	const size_t rowsBlock = std::min(Blocking::rowsBlock, (rowsPerThread + mr - 1) / mr * mr);
+	const size_t rowBlocksNumber = (rows + rowsBlock - 1) / rowsBlock;
+
+	// Result is zeroed by the same threads which accumulate into its rows later,
+	// so fresh pages of an uninitialized result are first touched where they are used.
+	ParallelFor(0, rowBlocksNumber, 1, [&] (const size_t first, const size_t last)
+	{
+		for (size_t r = first * rowsBlock; r < std::min(last * rowsBlock, rows); ++r)
+		{
+			for (size_t c = 0; c < columns; ++c) {
+				result(r, c) = T{};
+			}
+		}
+	});
+	if (depth == 0) {
+		return;
+	}
+
+	std::vector<T> packedRight(
+		Blocking::depthBlock * ((std::min(Blocking::columnsBlock, columns) + nr - 1) / nr * nr));
+	for (size_t jc = 0; jc < columns; jc += Blocking::columnsBlock)
+	{
+		const size_t nc = std::min(Blocking::columnsBlock, columns - jc);
+		for (size_t pc = 0; pc < depth; pc += Blocking::depthBlock)
+		{
+			const size_t kc = std::min(Blocking::depthBlock, depth - pc);
+			PackRight(right.Block(pc, jc, kc, nc), kc, nc, packedRight.data());
+
+			ParallelFor(0, rowBlocksNumber, 1, [&] (const size_t first, const size_t last)
+			{
+				std::vector<T> packedLeft(rowsBlock * kc);
+				for (size_t block = first; block < last; ++block)
+				{
+					const size_t ic = block * rowsBlock;
+					const size_t mc = std::min(rowsBlock, rows - ic);
+					PackLeft(left.Block(ic, pc, mc, kc), mc, kc, packedLeft.data());
+
+					for (size_t jr = 0; jr < nc; jr += nr)
+					{
+						const size_t panelColumns = std::min(nr, nc - jr);
+						for (size_t ir = 0; ir < mc; ir += mr)
+						{
+							const size_t panelRows = std::min(mr, mc - ir);
+							GemmMicroKernel(
+								kc,
+								packedLeft.data() + ir * kc,
+								packedRight.data() + jr * kc,
+								result.Block(ic + ir, jc + jr, panelRows, panelColumns),
+								panelRows,
+								panelColumns);
+						}
+					}
+				}
+			});
+		}
+	}
+}
+
+}	// namespace detail
+}	// namespace mtx
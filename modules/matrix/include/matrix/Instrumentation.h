@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Define MTX_ENABLE_INSTRUMENTATION to record calls, touched elements, time and allocations
+// of matrix operations. Without it instrumentation macros expand to nothing and their
+// arguments aren't evaluated, so operations don't pay anything. The snapshot API stays
+// available and returns zeros, so code scraping the counters compiles in both builds.
+
+namespace mtx
+{
+namespace instrumentation
+{
+
+//! Instrumented operations.
+enum class Operation : unsigned
+{
+	Construction = 0,
+	Copy,
+	Slice,
+	TransformMatrices,
+	Equal,
+	Multiply,
+	CountLocalMinimums,
+	LongestIdenticalSet,
+	NonNegativeRowsMultiplication,
+	SumOverMainDiagonal,
+	CyclicShift,
+	Analyze,
+	Transpose
+};
+
+//! Number of instrumented operations.
+constexpr size_t operationsNumber = static_cast<size_t>(Operation::Transpose) + 1;
+//! Bucket i of the histogram counts calls which took [2^i, 2^(i+1)) nanoseconds,
+//! the last bucket also counts all longer calls.
+constexpr size_t histogramBuckets = 40;
+
+//! Statistics of an operation.
+struct OperationStats
+{
+	//! Number of finished calls.
+	std::uint64_t calls_ = { 0 };
+	//! Number of elements read or written by the calls.
+	std::uint64_t elements_ = { 0 };
+	//! Total wall time of the calls.
+	std::uint64_t nanoseconds_ = { 0 };
+	//! Histogram of wall times of the calls, see histogramBuckets.
+	std::array<std::uint64_t, histogramBuckets> histogram_ = {};
+};
+
+//! Copy of all counters taken at some moment.
+struct Snapshot
+{
+	//! Returns statistics of the operation.
+	const OperationStats& operator[](const Operation operation) const noexcept
+	{
+		return operations_[static_cast<size_t>(operation)];
+	}
+
+	//! Statistics of operations in order of Operation.
+	std::array<OperationStats, operationsNumber> operations_ = {};
+	//! Number of allocations of storage of matrices.
+	std::uint64_t allocations_ = { 0 };
+	//! Bytes requested by the allocations.
+	std::uint64_t bytesAllocated_ = { 0 };
+	//! Number of deallocations of storage of matrices.
+	std::uint64_t deallocations_ = { 0 };
+	//! Bytes released by the deallocations.
+	std::uint64_t bytesDeallocated_ = { 0 };
+};
+
+//! Returns true if the library is built with instrumentation.
+constexpr bool IsEnabled() noexcept
+{
+#if defined(MTX_ENABLE_INSTRUMENTATION)
+	return true;
+#else
+	return false;
+#endif
+}
+
+//! Returns name of the operation.
+inline const char* GetName(const Operation operation) noexcept
+{
+	static const char* const names[operationsNumber] = {
+		"Construction",
+		"Copy",
+		"Slice",
+		"TransformMatrices",
+		"Equal",
+		"Multiply",
+		"CountLocalMinimums",
+		"LongestIdenticalSet",
+		"NonNegativeRowsMultiplication",
+		"SumOverMainDiagonal",
+		"CyclicShift",
+		"Analyze",
+		"Transpose"
+	};
+
+	return names[static_cast<size_t>(operation)];
+}
+
+namespace detail
+{
+
+//! Counters of an operation, every operation takes its own cache lines,
+//! so threads running different operations don't share them.
+struct alignas(64) OperationCounters
+{
+	std::atomic<std::uint64_t> calls_;
+	std::atomic<std::uint64_t> elements_;
+	std::atomic<std::uint64_t> nanoseconds_;
+	std::array<std::atomic<std::uint64_t>, histogramBuckets> histogram_;
+};
+
+//! All counters of the process.
+struct Counters
+{
+	std::array<OperationCounters, operationsNumber> operations_;
+	alignas(64) std::atomic<std::uint64_t> allocations_;
+	std::atomic<std::uint64_t> bytesAllocated_;
+	std::atomic<std::uint64_t> deallocations_;
+	std::atomic<std::uint64_t> bytesDeallocated_;
+};
+
+//! Returns counters of the process, they are zero-initialized before any use.
+inline Counters& GetCounters() noexcept
+{
+	static Counters counters{};
+	return counters;
+}
+
+//! Returns bucket of the histogram for the duration.
+inline size_t GetHistogramBucket(std::uint64_t nanoseconds) noexcept
+{
+	size_t bucket = 0;
+	while (nanoseconds > 1 && bucket + 1 < histogramBuckets)
+	{
+		nanoseconds >>= 1;
+		++bucket;
+	}
+
+	return bucket;
+}
+
+//! Records the finished call of the operation.
+inline void RecordCall(const Operation operation, const size_t elements, const std::uint64_t nanoseconds) noexcept
+{
+	auto& counters = GetCounters().operations_[static_cast<size_t>(operation)];
+	counters.calls_.fetch_add(1, std::memory_order_relaxed);
+	counters.elements_.fetch_add(elements, std::memory_order_relaxed);
+	counters.nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+	counters.histogram_[GetHistogramBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+//! Records allocation of bytes of storage.
+inline void RecordAllocation(const size_t bytes) noexcept
+{
+	auto& counters = GetCounters();
+	counters.allocations_.fetch_add(1, std::memory_order_relaxed);
+	counters.bytesAllocated_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+//! Records deallocation of bytes of storage.
+inline void RecordDeallocation(const size_t bytes) noexcept
+{
+	auto& counters = GetCounters();
+	counters.deallocations_.fetch_add(1, std::memory_order_relaxed);
+	counters.bytesDeallocated_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+}	// namespace detail
+
+//! Measures the call of the operation from construction till destruction, use MTX_INSTRUMENT.
+class ScopedOperation
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, starts measurement of the call touching the number of elements.
+	ScopedOperation(const Operation operation, const size_t elements) noexcept;
+	//! Destructor, records the call.
+	~ScopedOperation() noexcept;
+	ScopedOperation(const ScopedOperation&) = delete;
+	ScopedOperation& operator=(const ScopedOperation&) = delete;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Measured operation.
+	Operation operation_;
+	//! Number of touched elements.
+	size_t elements_;
+	//! Start of the call.
+	std::chrono::steady_clock::time_point start_;
+};
+
+inline ScopedOperation::ScopedOperation(const Operation operation, const size_t elements) noexcept
+	: operation_{ operation }
+	, elements_{ elements }
+	, start_{ std::chrono::steady_clock::now() }
+{
+}
+
+inline ScopedOperation::~ScopedOperation() noexcept
+{
+	const auto elapsed = std::chrono::steady_clock::now() - start_;
+	detail::RecordCall(
+		operation_,
+		elements_,
+		static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+//! Returns copy of the counters. Counters are read one by one while other threads
+//! may update them, so the snapshot of a busy process isn't atomic as a whole.
+inline Snapshot GetSnapshot() noexcept
+{
+	const auto& counters = detail::GetCounters();
+	Snapshot snapshot;
+	for (size_t i = 0; i < operationsNumber; ++i)
+	{
+		const auto& source = counters.operations_[i];
+		auto& stats = snapshot.operations_[i];
+		stats.calls_ = source.calls_.load(std::memory_order_relaxed);
+		stats.elements_ = source.elements_.load(std::memory_order_relaxed);
+		stats.nanoseconds_ = source.nanoseconds_.load(std::memory_order_relaxed);
+		for (size_t b = 0; b < histogramBuckets; ++b) {
+			stats.histogram_[b] = source.histogram_[b].load(std::memory_order_relaxed);
+		}
+	}
+	snapshot.allocations_ = counters.allocations_.load(std::memory_order_relaxed);
+	snapshot.bytesAllocated_ = counters.bytesAllocated_.load(std::memory_order_relaxed);
+	snapshot.deallocations_ = counters.deallocations_.load(std::memory_order_relaxed);
+	snapshot.bytesDeallocated_ = counters.bytesDeallocated_.load(std::memory_order_relaxed);
+
+	return snapshot;
+}
+
+//! Sets all counters to zero.
+inline void Reset() noexcept
+{
+	auto& counters = detail::GetCounters();
+	for (auto& operation : counters.operations_)
+	{
+		operation.calls_.store(0, std::memory_order_relaxed);
+		operation.elements_.store(0, std::memory_order_relaxed);
+		operation.nanoseconds_.store(0, std::memory_order_relaxed);
+		for (auto& bucket : operation.histogram_) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+	counters.allocations_.store(0, std::memory_order_relaxed);
+	counters.bytesAllocated_.store(0, std::memory_order_relaxed);
+	counters.deallocations_.store(0, std::memory_order_relaxed);
+	counters.bytesDeallocated_.store(0, std::memory_order_relaxed);
+}
+
+//! Writes the snapshot in the text exposition format of Prometheus: counters of calls,
+//! elements and allocations and a cumulative histogram of times in seconds per operation.
+//! Operations which weren't called are skipped.
+inline void WriteMetrics(std::ostream& stream, const Snapshot& snapshot)
+{
+	stream << "# TYPE mtx_operation_calls_total counter\n"
+		<< "# TYPE mtx_operation_elements_total counter\n"
+		<< "# TYPE mtx_operation_seconds histogram\n";
+	for (size_t i = 0; i < operationsNumber; ++i)
+	{
+		const auto& stats = snapshot.operations_[i];
+		if (stats.calls_ == 0) {
+			continue;
+		}
+
+		const char* name = GetName(static_cast<Operation>(i));
+		stream << "mtx_operation_calls_total{operation=\"" << name << "\"} " << stats.calls_ << '\n'
+			<< "mtx_operation_elements_total{operation=\"" << name << "\"} " << stats.elements_ << '\n';
+		std::uint64_t cumulative = 0;
+		for (size_t b = 0; b + 1 < histogramBuckets; ++b)
+		{
+			cumulative += stats.histogram_[b];
+			// Upper bound of the bucket b is 2^(b + 1) nanoseconds.
+			stream << "mtx_operation_seconds_bucket{operation=\"" << name << "\",le=\""
+				<< static_cast<double>(std::uint64_t{ 2 } << b) * 1e-9 << "\"} " << cumulative << '\n';
+		}
+		stream << "mtx_operation_seconds_bucket{operation=\"" << name << "\",le=\"+Inf\"} " << stats.calls_ << '\n'
+			<< "mtx_operation_seconds_sum{operation=\"" << name << "\"} "
+			<< static_cast<double>(stats.nanoseconds_) * 1e-9 << '\n'
+			<< "mtx_operation_seconds_count{operation=\"" << name << "\"} " << stats.calls_ << '\n';
+	}
+	stream << "# TYPE mtx_allocations_total counter\n"
+		<< "mtx_allocations_total " << snapshot.allocations_ << '\n'
+		<< "# TYPE mtx_allocated_bytes_total counter\n"
+		<< "mtx_allocated_bytes_total " << snapshot.bytesAllocated_ << '\n'
+		<< "# TYPE mtx_deallocations_total counter\n"
+		<< "mtx_deallocations_total " << snapshot.deallocations_ << '\n'
+		<< "# TYPE mtx_deallocated_bytes_total counter\n"
+		<< "mtx_deallocated_bytes_total " << snapshot.bytesDeallocated_ << '\n';
+}
+
+}	// namespace instrumentation
+}	// namespace mtx
+
+#if defined(MTX_ENABLE_INSTRUMENTATION)
+//! Measures the rest of the enclosing scope as a call of the operation touching the elements.
+#define MTX_INSTRUMENT(operation, elements) \
+	const ::mtx::instrumentation::ScopedOperation mtxInstrumentedScope( \
+		::mtx::instrumentation::Operation::operation, \
+		static_cast<size_t>(elements))
+//! Records allocation and deallocation of storage of bytes.
+#define MTX_INSTRUMENT_ALLOCATION(bytes) ::mtx::instrumentation::detail::RecordAllocation(bytes)
+#define MTX_INSTRUMENT_DEALLOCATION(bytes) ::mtx::instrumentation::detail::RecordDeallocation(bytes)
+#else
+#define MTX_INSTRUMENT(operation, elements) static_cast<void>(0)
+#define MTX_INSTRUMENT_ALLOCATION(bytes) static_cast<void>(0)
+#define MTX_INSTRUMENT_DEALLOCATION(bytes) static_cast<void>(0)
+#endif
@@ -0,0 +1,480 @@
+#pragma once
+
+#include "matrix/BinaryFormat.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mtx
+{
+
+//! Access to the mapped file.
+enum class MapMode
+{
+	ReadOnly,
+	ReadWrite
+};
+
+//! File mapped to the memory as a whole. Pages are read from the disk lazily on the first
+//! access, modified pages of the writable mapping are written back by the system.
+class MappedFile
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	MappedFile() = default;
+	//! Constructor, maps existing file.
+	MappedFile(const std::string& path, const MapMode mode);
+	//! Destructor.
+	~MappedFile() noexcept;
+	//! Move constructor.
+	MappedFile(MappedFile&& other) noexcept;
+	//! Move assignment operator.
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Creates or truncates the file, sets its size filling it with zeros and maps it for writing.
+	static MappedFile Create(const std::string& path, const size_t size);
+	//! Returns address of the first byte of the file.
+	unsigned char* Data() const noexcept;
+	//! Returns size of the file in bytes.
+	size_t GetSize() const noexcept;
+	//! Returns access to the mapping.
+	MapMode GetMode() const noexcept;
+	//! Writes modified pages to the disk and waits for completion.
+	void Flush();
+
+	//
+	// Private methods.
+	//
+private:
+	//! Releases the mapping.
+	void Unmap() noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Address of the mapping.
+	unsigned char* data_ = { nullptr };
+	//! Size of the file.
+	size_t size_ = { 0 };
+	//! Access to the mapping.
+	MapMode mode_ = { MapMode::ReadOnly };
+};
+
+inline MappedFile::MappedFile(const std::string& path, const MapMode mode)
+	: mode_{ mode }
+{
+	const bool writable = mode == MapMode::ReadWrite;
+#ifdef _WIN32
+	HANDLE file = ::CreateFileA(
+		path.c_str(),
+		GENERIC_READ | (writable ? GENERIC_WRITE : 0),
+		FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("MappedFile: file can't be opened.");
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!::GetFileSizeEx(file, &fileSize))
+	{
+		::CloseHandle(file);
+		throw std::runtime_error("MappedFile: size of the file is unknown.");
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	if (size_ == 0)
+	{
+		::CloseHandle(file);
+		return;
+	}
+
+	// View keeps the mapping alive, so handles aren't needed after the view is created.
+	HANDLE mapping = ::CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(file);
+	if (mapping == nullptr) {
+		throw std::runtime_error("MappedFile: file can't be mapped.");
+	}
+	void* data = ::MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mapping);
+	if (data == nullptr) {
+		throw std::runtime_error("MappedFile: file can't be mapped.");
+	}
+#else
+	const int descriptor = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+	if (descriptor < 0) {
+		throw std::runtime_error("MappedFile: file can't be opened.");
+	}
+
+	struct stat info;
+	if (::fstat(descriptor, &info) != 0)
+	{
+		::close(descriptor);
+		throw std::runtime_error("MappedFile: size of the file is unknown.");
+	}
+	size_ = static_cast<size_t>(info.st_size);
+	if (size_ == 0)
+	{
+		::close(descriptor);
+		return;
+	}
+
+	// Mapping stays valid after the descriptor is closed.
+	void* data = ::mmap(nullptr, size_, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, descriptor, 0);
+	::close(descriptor);
+	if (data == MAP_FAILED) {
+		throw std::runtime_error("MappedFile: file can't be mapped.");
+	}
+#endif
+	data_ = static_cast<unsigned char*>(data);
+}
+
+inline MappedFile::~MappedFile() noexcept
+{
+	Unmap();
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+	: data_{ other.data_ }
+	, size_{ other.size_ }
+	, mode_{ other.mode_ }
+{
+	other.data_ = nullptr;
+	other.size_ = 0;
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	std::swap(data_, other.data_);
+	std::swap(size_, other.size_);
+	std::swap(mode_, other.mode_);
+
+	return *this;
+}
+
+inline MappedFile MappedFile::Create(const std::string& path, const size_t size)
+{
+#ifdef _WIN32
+	HANDLE file = ::CreateFileA(
+		path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		0,
+		nullptr,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("MappedFile::Create: file can't be created.");
+	}
+
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = static_cast<LONGLONG>(size);
+	const bool resized = ::SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) && ::SetEndOfFile(file);
+	::CloseHandle(file);
+#else
+	const int descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0) {
+		throw std::runtime_error("MappedFile::Create: file can't be created.");
+	}
+
+	const bool resized = ::ftruncate(descriptor, static_cast<off_t>(size)) == 0;
+	::close(descriptor);
+#endif
+	if (!resized) {
+		throw std::runtime_error("MappedFile::Create: size of the file can't be set.");
+	}
+
+	return MappedFile(path, MapMode::ReadWrite);
+}
+
+inline unsigned char* MappedFile::Data() const noexcept
+{
+	return data_;
+}
+
+inline size_t MappedFile::GetSize() const noexcept
+{
+	return size_;
+}
+
+inline MapMode MappedFile::GetMode() const noexcept
+{
+	return mode_;
+}
+
+inline void MappedFile::Flush()
+{
+	if (data_ == nullptr || mode_ != MapMode::ReadWrite) {
+		return;
+	}
+
+#ifdef _WIN32
+	const bool flushed = ::FlushViewOfFile(data_, 0) != 0;
+#else
+	const bool flushed = ::msync(data_, size_, MS_SYNC) == 0;
+#endif
+	if (!flushed) {
+		throw std::runtime_error("MappedFile::Flush: pages can't be written.");
+	}
+}
+
+inline void MappedFile::Unmap() noexcept
+{
+	if (data_ == nullptr) {
+		return;
+	}
+
+#ifdef _WIN32
+	::UnmapViewOfFile(data_);
+#else
+	::munmap(data_, size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+//! Matrix whose elements stay in the mapped file of the binary format, see BinaryFormat.h.
+//! Opening doesn't read elements, pages are loaded on the first access, so huge files
+//! open instantly. Matrix provides views of its elements, so it works with algorithms
+//! taking views: TransformMatrices, Multiply, expressions and analyses of Matrix2DAdapter.
+//! Files must have native byte order, use Load to convert foreign files.
+template<typename T>
+class MappedMatrix2D
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	MappedMatrix2D() = default;
+	//! Constructor, maps the file written by Save or created by Create.
+	explicit MappedMatrix2D(const std::string& path, const MapMode mode = MapMode::ReadOnly);
+	//! Destructor.
+	~MappedMatrix2D() noexcept = default;
+	//! Move constructor.
+	MappedMatrix2D(MappedMatrix2D&& other) noexcept;
+	//! Move assignment operator.
+	MappedMatrix2D& operator=(MappedMatrix2D&& other) noexcept;
+	MappedMatrix2D(const MappedMatrix2D&) = delete;
+	MappedMatrix2D& operator=(const MappedMatrix2D&) = delete;
+
+	//
+	// Alias declaration.
+	//
+public:
+	using View = Matrix2DView<T>;
+	using ConstView = Matrix2DView<const T>;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Creates the file for the matrix of specified size filled with zeros and maps it for writing.
+	static MappedMatrix2D Create(
+		const std::string& path,
+		const size_t rows,
+		const size_t columns,
+		const RowPadding padding = RowPadding{});
+	//! Returns number of columns.
+	size_t GetColumns() const noexcept;
+	//! Returns number of rows.
+	size_t GetRows() const noexcept;
+	//! Returns distance in elements between beginnings of two neighboring rows.
+	size_t GetRowStride() const noexcept;
+	//! Returns true if elements may be modified.
+	bool IsWritable() const noexcept;
+	//! Provides read access to the elements.
+	const T& operator()(const size_t row, const size_t column) const;
+	//! Returns read only view of the elements, also of the matrix mapped for writing.
+	ConstView GetView() const noexcept;
+	//! Returns view of the elements for writing, throws std::runtime_error if the matrix is mapped read only.
+	View GetWritableView();
+	//! Writes modified elements to the disk.
+	void Flush();
+
+	//
+	// Private methods.
+	//
+private:
+	//! Constructor, checks the header of the mapped file.
+	explicit MappedMatrix2D(MappedFile file);
+
+	//
+	// Private data members.
+	//
+private:
+	//! Mapping of the whole file.
+	MappedFile file_;
+	//! Header of the file.
+	BinaryHeader header_;
+	//! The first element in the mapping.
+	T* data_ = { nullptr };
+};
+
+template<typename T>
+MappedMatrix2D<T>::MappedMatrix2D(const std::string& path, const MapMode mode)
+	: MappedMatrix2D(MappedFile(path, mode))
+{
+}
+
+template<typename T>
+MappedMatrix2D<T>::MappedMatrix2D(MappedFile file)
+	: file_{ std::move(file) }
+{
+	if (file_.GetSize() < sizeof(header_)) {
+		throw std::runtime_error("MappedMatrix2D: unexpected end of the file.");
+	}
+
+	std::memcpy(&header_, file_.Data(), sizeof(header_));
+	if (header_.byteOrder_ != BinaryHeader().byteOrder_) {
+		throw std::runtime_error("MappedMatrix2D: byte order of the file isn't native.");
+	}
+
+	const size_t bytes = detail::CheckBinaryHeader<T>(header_, "MappedMatrix2D");
+	bool truncated =
+		header_.dataOffset_ > file_.GetSize()
+		|| bytes > file_.GetSize() - static_cast<size_t>(header_.dataOffset_);
+
+	if (truncated) {
+		throw std::runtime_error("MappedMatrix2D: unexpected end of the file.");
+	}
+	if (header_.dataOffset_ % alignof(T) != 0) {
+		throw std::runtime_error("MappedMatrix2D: elements of the file are misaligned.");
+	}
+
+	data_ = reinterpret_cast<T*>(file_.Data() + header_.dataOffset_);
+}
+
+template<typename T>
+MappedMatrix2D<T>::MappedMatrix2D(MappedMatrix2D&& other) noexcept
+	: file_{ std::move(other.file_) }
+	, header_{ other.header_ }
+	, data_{ other.data_ }
+{
+	other.header_ = BinaryHeader();
+	other.data_ = nullptr;
+}
+
+template<typename T>
+MappedMatrix2D<T>& MappedMatrix2D<T>::operator=(MappedMatrix2D&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	std::swap(file_, other.file_);
+	std::swap(header_, other.header_);
+	std::swap(data_, other.data_);
+
+	return *this;
+}
+
+template<typename T>
+MappedMatrix2D<T> MappedMatrix2D<T>::Create(
+	const std::string& path,
+	const size_t rows,
+	const size_t columns,
+	const RowPadding padding)
+{
+	const auto header = detail::MakeBinaryHeader<T>(rows, columns, padding);
+	const auto stride = static_cast<size_t>(header.rowStride_);
+	const auto maxSize = std::numeric_limits<size_t>::max() - static_cast<size_t>(header.dataOffset_);
+	if (stride != 0 && rows > maxSize / sizeof(T) / stride) {
+		throw std::length_error("MappedMatrix2D::Create: matrix is too big.");
+	}
+
+	auto file = MappedFile::Create(path, static_cast<size_t>(header.dataOffset_) + rows * stride * sizeof(T));
+	std::memcpy(file.Data(), &header, sizeof(header));
+
+	return MappedMatrix2D(std::move(file));
+}
+
+template<typename T>
+size_t MappedMatrix2D<T>::GetColumns() const noexcept
+{
+	return static_cast<size_t>(header_.columns_);
+}
+
+template<typename T>
+size_t MappedMatrix2D<T>::GetRows() const noexcept
+{
+	return static_cast<size_t>(header_.rows_);
+}
+
+template<typename T>
+size_t MappedMatrix2D<T>::GetRowStride() const noexcept
+{
+	return static_cast<size_t>(header_.rowStride_);
+}
+
+template<typename T>
+bool MappedMatrix2D<T>::IsWritable() const noexcept
+{
+	return file_.GetMode() == MapMode::ReadWrite;
+}
+
+template<typename T>
+const T& MappedMatrix2D<T>::operator()(const size_t row, const size_t column) const
+{
+	return data_[row * GetRowStride() + column];
+}
+
+template<typename T>
+typename MappedMatrix2D<T>::ConstView MappedMatrix2D<T>::GetView() const noexcept
+{
+	return ConstView(data_, GetRows(), GetColumns(), static_cast<std::ptrdiff_t>(GetRowStride()));
+}
+
+template<typename T>
+typename MappedMatrix2D<T>::View MappedMatrix2D<T>::GetWritableView()
+{
+	if (!IsWritable()) {
+		throw std::runtime_error("MappedMatrix2D::GetWritableView: matrix is mapped read only.");
+	}
+
+	return View(data_, GetRows(), GetColumns(), static_cast<std::ptrdiff_t>(GetRowStride()));
+}
+
+template<typename T>
+void MappedMatrix2D<T>::Flush()
+{
+	file_.Flush();
+}
+
+}	// namespace mtx
@@ -1,6 +1,18 @@
 #pragma once
 
+#include "matrix/Allocator.h"
+#include "matrix/Gemm.h"
+#include "matrix/Instrumentation.h"
+#include "matrix/MatrixExpression.h"
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+#include "matrix/Random.h"
+#include "matrix/Simd.h"
+#include "matrix/Transpose.h"
+
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <random>
@@ -12,7 +24,57 @@
 namespace mtx
 {
 
+//! Requests padding of every row to a multiple of the specified number of elements.
+//! Rows of the padded matrix start at aligned addresses if the multiple times size
+//! of the element is a multiple of the storage alignment, see SimdRowPadding.
+struct RowPadding
+{
+	//! Number of elements in the row is rounded up to a multiple of this number.
+	size_t multiple_ = { 1 };
+};
+
+//! Returns padding which makes every row of Matrix2D<T> start at the cache line boundary.
 template<typename T>
+constexpr RowPadding SimdRowPadding() noexcept
+{
+	return RowPadding{ defaultAlignment % sizeof(T) == 0 ? defaultAlignment / sizeof(T) : 1 };
+}
+
+//! Order of elements of the matrix in the storage.
+enum class Layout
+{
+	//! Rows follow each other, elements of a row are next to each other.
+	RowMajor,
+	//! Columns follow each other, elements of a column are next to each other,
+	//! so algorithms walking columns access memory with the unit stride.
+	ColumnMajor
+};
+
+//! Tag of constructors which leave elements of the matrix default-initialized.
+//! Elements of trivial types keep indeterminate values and must be written before
+//! they are read, so the buffer isn't zeroed just to be overwritten.
+struct UninitializedTag
+{
+};
+
+//! Requests construction of the matrix without initialization of elements.
+constexpr UninitializedTag uninitialized{};
+
+//! Tag of constructors which initialize rows of the matrix in parallel, row blocks are
+//! split between threads the same way as by parallel algorithms of the library, so memory
+//! pages are first touched by threads (and NUMA nodes) which will process them.
+struct FirstTouchTag
+{
+};
+
+//! Requests parallel initialization of elements of the matrix.
+constexpr FirstTouchTag firstTouch{};
+
+//! Two dimensional matrix which keeps all elements in a single buffer row by row
+//! or column by column, see Layout. Storage is allocated with Alloc, by default
+//! it is aligned to the cache line. Views of the matrix carry strides of the layout,
+//! so algorithms on views work with both layouts.
+template<typename T, typename Alloc = AlignedAllocator<T>>
 class Matrix2D
 {
 	//
@@ -35,13 +97,38 @@ public:
 	//! Constructor.
 	Matrix2D() = default;
 	//! Constructor.
-	Matrix2D(const size_t rows, const size_t columns);
+	Matrix2D(const size_t rows, const size_t columns, const Alloc& alloc = Alloc());
 	//! Constructor.
-	Matrix2D(const size_t rows, const size_t columns, const T& defVal);
+	Matrix2D(const size_t rows, const size_t columns, const T& defVal, const Alloc& alloc = Alloc());
 	//! Constructor.
-	Matrix2D(const Dimension& matSize);
+	Matrix2D(const Dimension& matSize, const Alloc& alloc = Alloc());
 	//! Constructor.
-	Matrix2D(const Dimension& matSize, const T& defVal);
+	Matrix2D(const Dimension& matSize, const T& defVal, const Alloc& alloc = Alloc());
+	//! Constructor, every row is padded as requested, padding elements are value-initialized.
+	Matrix2D(const Dimension& matSize, const RowPadding padding, const Alloc& alloc = Alloc());
+	//! Constructor, elements are default-initialized, values of trivial types are indeterminate.
+	Matrix2D(const Dimension& matSize, UninitializedTag, const Alloc& alloc = Alloc());
+	//! Constructor, every row is padded as requested, elements are default-initialized
+	//! and padding elements are value-initialized.
+	Matrix2D(
+		const Dimension& matSize,
+		const RowPadding padding,
+		UninitializedTag,
+		const Alloc& alloc = Alloc());
+	//! Constructor, elements are set to defVal by several threads, see FirstTouchTag.
+	Matrix2D(const Dimension& matSize, FirstTouchTag, const T& defVal = T(), const Alloc& alloc = Alloc());
+	//! Constructor, every row is padded as requested, elements are set to defVal
+	//! and padding elements are value-initialized by several threads, see FirstTouchTag.
+	Matrix2D(
+		const Dimension& matSize,
+		const RowPadding padding,
+		FirstTouchTag,
+		const T& defVal = T(),
+		const Alloc& alloc = Alloc());
+	//! Constructor, elements are placed according to the layout and set to defVal.
+	Matrix2D(const Dimension& matSize, const Layout layout, const T& defVal = T(), const Alloc& alloc = Alloc());
+	//! Constructor, elements are placed according to the layout and default-initialized.
+	Matrix2D(const Dimension& matSize, const Layout layout, UninitializedTag, const Alloc& alloc = Alloc());
 	//! Destructor.
 	~Matrix2D() noexcept = default;
 	//! Move constructor.
@@ -52,6 +139,13 @@ public:
 	Matrix2D(const Matrix2D& other);
 	//! Copy assignment operator.
 	Matrix2D& operator=(const Matrix2D& other);
+	//! Constructor, evaluates the expression, see MatrixExpression.
+	template<typename E>
+	Matrix2D(const MatrixExpression<E>& expr);
+	//! Assignment operator, evaluates the expression in a single pass.
+	//! Storage is reused if sizes of the matrix and the expression are equal.
+	template<typename E>
+	Matrix2D& operator=(const MatrixExpression<E>& expr);
 
 	//
 	// Alias declaration.
@@ -59,32 +153,87 @@ public:
 public:
 	//! Use vector as a result of Slice function.
 	using Row = std::vector<T>;
+	//! Storage of the elements, elements constructed without arguments are default-initialized,
+	//! so constructors which fill the matrix value-initialize it explicitly.
+	using Storage = std::vector<T, detail::DefaultInitAllocator<Alloc>>;
+	using Iterator = typename Storage::iterator;
+	using ConstIterator = typename Storage::const_iterator;
+	using AllocatorType = Alloc;
+	//! Non-owning views of the matrix elements.
+	using View = Matrix2DView<T>;
+	using ConstView = Matrix2DView<const T>;
+	using LineView = VectorView<T>;
+	using ConstLineView = VectorView<const T>;
 
 	//
 	// Public interface.
 	//
 public:
 	//! Returns an iterator pointing to the first element in the matrix.
-	typename Row::iterator Begin() noexcept;
-	typename Row::const_iterator Begin() const noexcept;
+	//! Iterators walk the whole storage in the order of the layout,
+	//! including padding of rows if there is any.
+	Iterator Begin() noexcept;
+	ConstIterator Begin() const noexcept;
 	//! Returns an iterator pointing to the past-the-end element in the matrix.
-	typename Row::iterator End() noexcept;
-	typename Row::const_iterator End() const noexcept;
+	Iterator End() noexcept;
+	ConstIterator End() const noexcept;
 	//! Returns number of columns.
 	size_t GetColumns() const;
 	//! Returns number of rows.
 	size_t GetRows() const;
 	//! Returns size structure of the matrix.
 	Dimension GetSize() const;
+	//! Returns distance in elements between beginnings of two neighboring rows.
+	size_t GetRowStride() const noexcept;
+	//! Returns distance in elements between beginnings of two neighboring columns.
+	size_t GetColumnStride() const noexcept;
+	//! Returns order of elements in the storage.
+	Layout GetLayout() const noexcept;
+	//! Returns padding of rows requested on construction.
+	RowPadding GetRowPadding() const noexcept;
+	//! Returns true if rows (or columns of column-major matrix) follow each other
+	//! without padding, so Begin() and End() iterate only over the elements of the matrix.
+	bool IsContiguous() const noexcept;
+	//! Returns allocator of the storage.
+	Alloc GetAllocator() const;
 	//! Provides access to the elements.
 	T& operator()(const size_t row, const size_t column);
 	const T& operator()(const size_t row, const size_t column) const;
-	//! Returns the row n.
+	//! Returns copy of the row n.
+	//! Prefer RowView when a copy is not required, it doesn't allocate.
 	Row Slice(const size_t n) const;
-	//! Returns slice of the row specified by arguments:
+	//! Returns copy of the slice of the row specified by arguments:
 	//! n - a number of row which need to be sliced
 	//! and first and last elements in this row.
 	Row Slice(const size_t n, const size_t first, const size_t last) const;
+	//! Returns non-owning view of the whole matrix.
+	View GetView() noexcept;
+	ConstView GetView() const noexcept;
+	//! Returns non-owning view of the row n.
+	LineView RowView(const size_t n);
+	ConstLineView RowView(const size_t n) const;
+	//! Returns non-owning view of the column n.
+	LineView ColumnView(const size_t n);
+	ConstLineView ColumnView(const size_t n) const;
+	//! Returns non-owning view of the rectangular part of the matrix
+	//! which starts at (row, column) and has specified number of rows and columns.
+	View BlockView(const size_t row, const size_t column, const size_t rows, const size_t columns);
+	ConstView BlockView(
+		const size_t row,
+		const size_t column,
+		const size_t rows,
+		const size_t columns) const;
+
+	//
+	// Private methods.
+	//
+private:
+	//! Value-initializes padding elements at the end of rows.
+	void ClearPadding();
+	//! Sets elements to defVal and padding elements to T() by several threads.
+	void FillInParallel(const T& defVal);
+	//! Returns index of the element in the storage.
+	size_t Index(const size_t row, const size_t column) const noexcept;
 
 	//
 	// Private data members.
@@ -92,141 +241,385 @@ public:
 private:
 	//! Size of the matrix.
 	Dimension sz_;
+	//! Requested padding of rows.
+	RowPadding padding_;
+	//! Order of elements in the storage.
+	Layout layout_ = { Layout::RowMajor };
+	//! Distance in elements between beginnings of two neighboring rows,
+	//! or columns if the matrix is column-major.
+	size_t stride_ = { 0 };
 	//! Storage for elements of the matrix.
 	//! All elements will be stored in a single vector.
-	std::vector<T> elems_;
+	Storage elems_;
 };
 
-template<typename T>
-Matrix2D<T>::Matrix2D(const size_t rows, const size_t columns)
+namespace detail
+{
+
+//! Matrix takes part in expressions through a view of its elements.
+template<typename T, typename Alloc>
+struct ExpressionOperand<Matrix2D<T, Alloc>>
+{
+	using Type = ViewExpression<T>;
+	static Type Make(const Matrix2D<T, Alloc>& mat) noexcept { return Type(mat.GetView()); }
+};
+
+//! Returns number of elements in the row rounded up to the multiple.
+inline size_t PaddedRowLength(const size_t columns, const RowPadding padding) noexcept
+{
+	const size_t multiple = padding.multiple_ == 0 ? 1 : padding.multiple_;
+	return (columns + multiple - 1) / multiple * multiple;
+}
+
+}	// namespace detail
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const size_t rows, const size_t columns, const Alloc& alloc)
 	: sz_{ rows, columns }
+	, stride_{ columns }
+	, elems_(alloc)
 {
-	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_);
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_, T());
 }
 
-template<typename T>
-Matrix2D<T>::Matrix2D(const size_t rows, const size_t columns, const T& defVal)
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const size_t rows, const size_t columns, const T& defVal, const Alloc& alloc)
 	: sz_{ rows, columns }
+	, stride_{ columns }
+	, elems_(alloc)
 {
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
 	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_, defVal);
 }
 
-template<typename T>
-Matrix2D<T>::Matrix2D(const Dimension& matSize)
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, const Alloc& alloc)
 	: sz_{ matSize }
+	, stride_{ matSize.colsNumber_ }
+	, elems_(alloc)
 {
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_, T());
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, const T& defVal, const Alloc& alloc)
+	: sz_{ matSize }
+	, stride_{ matSize.colsNumber_ }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_, defVal);
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, const RowPadding padding, const Alloc& alloc)
+	: sz_{ matSize }
+	, padding_{ padding }
+	, stride_{ detail::PaddedRowLength(matSize.colsNumber_, padding) }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * stride_);
+	elems_.resize(sz_.rowsNumber_ * stride_, T());
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, UninitializedTag, const Alloc& alloc)
+	: sz_{ matSize }
+	, stride_{ matSize.colsNumber_ }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, 0);
 	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_);
 }
 
-template<typename T>
-Matrix2D<T>::Matrix2D(const Dimension& matSize, const T& defVal)
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(
+	const Dimension& matSize,
+	const RowPadding padding,
+	UninitializedTag,
+	const Alloc& alloc)
+	: sz_{ matSize }
+	, padding_{ padding }
+	, stride_{ detail::PaddedRowLength(matSize.colsNumber_, padding) }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * (stride_ - sz_.colsNumber_));
+	elems_.resize(sz_.rowsNumber_ * stride_);
+	ClearPadding();
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, FirstTouchTag, const T& defVal, const Alloc& alloc)
 	: sz_{ matSize }
+	, stride_{ matSize.colsNumber_ }
+	, elems_(alloc)
 {
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_);
+	FillInParallel(defVal);
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(
+	const Dimension& matSize,
+	const RowPadding padding,
+	FirstTouchTag,
+	const T& defVal,
+	const Alloc& alloc)
+	: sz_{ matSize }
+	, padding_{ padding }
+	, stride_{ detail::PaddedRowLength(matSize.colsNumber_, padding) }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * stride_);
+	elems_.resize(sz_.rowsNumber_ * stride_);
+	FillInParallel(defVal);
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, const Layout layout, const T& defVal, const Alloc& alloc)
+	: sz_{ matSize }
+	, layout_{ layout }
+	, stride_{ layout == Layout::RowMajor ? matSize.colsNumber_ : matSize.rowsNumber_ }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
 	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_, defVal);
 }
 
-template<typename T>
-Matrix2D<T>::Matrix2D(const Matrix2D<T>& other)
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Dimension& matSize, const Layout layout, UninitializedTag, const Alloc& alloc)
+	: sz_{ matSize }
+	, layout_{ layout }
+	, stride_{ layout == Layout::RowMajor ? matSize.colsNumber_ : matSize.rowsNumber_ }
+	, elems_(alloc)
+{
+	MTX_INSTRUMENT(Construction, 0);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_);
+}
+
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(const Matrix2D& other)
 	: sz_{ other.sz_.rowsNumber_, other.sz_.colsNumber_ }
+	, padding_{ other.padding_ }
+	, layout_{ other.layout_ }
+	, stride_{ other.stride_ }
+	, elems_{ other.elems_ }
 {
-	elems_ = other.elems_;
+	MTX_INSTRUMENT(Copy, elems_.size());
 }
 
-template<typename T>
-Matrix2D<T>::Matrix2D(Matrix2D&& other) noexcept
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>::Matrix2D(Matrix2D&& other) noexcept
 	: sz_{ other.sz_.rowsNumber_, other.sz_.colsNumber_ }
+	, padding_{ other.padding_ }
+	, layout_{ other.layout_ }
+	, stride_{ other.stride_ }
+	, elems_{ std::move(other.elems_) }
 {
-	std::swap(elems_, other.elems_);
 }
 
-template<typename T>
-Matrix2D<T>& Matrix2D<T>::operator=(const Matrix2D& other)
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>& Matrix2D<T, Alloc>::operator=(const Matrix2D& other)
 {
 	if (this == &other) {
 		return *this;
 	}
 
+	MTX_INSTRUMENT(Copy, other.elems_.size());
 	sz_ = other.sz_;
+	padding_ = other.padding_;
+	layout_ = other.layout_;
+	stride_ = other.stride_;
 	elems_ = other.elems_;
 
 	return *this;
 }
 
-template<typename T>
-Matrix2D<T>& Matrix2D<T>::operator=(Matrix2D&& other) noexcept
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc>& Matrix2D<T, Alloc>::operator=(Matrix2D&& other) noexcept
 {
 	if (this == &other) {
 		return *this;
 	}
 
 	std::swap(sz_, other.sz_);
+	std::swap(padding_, other.padding_);
+	std::swap(layout_, other.layout_);
+	std::swap(stride_, other.stride_);
 	std::swap(elems_, other.elems_);
 
 	return *this;
 }
 
-template<typename T>
-typename Matrix2D<T>::Row::iterator Matrix2D<T>::Begin() noexcept
+template<typename T, typename Alloc>
+template<typename E>
+Matrix2D<T, Alloc>::Matrix2D(const MatrixExpression<E>& expr)
+	: sz_{ expr.GetRows(), expr.GetColumns() }
+	, stride_{ expr.GetColumns() }
+{
+	MTX_INSTRUMENT(Construction, sz_.rowsNumber_ * sz_.colsNumber_);
+	elems_.resize(sz_.rowsNumber_ * sz_.colsNumber_);
+	EvaluateInto(expr, GetView());
+}
+
+template<typename T, typename Alloc>
+template<typename E>
+Matrix2D<T, Alloc>& Matrix2D<T, Alloc>::operator=(const MatrixExpression<E>& expr)
+{
+	if (sz_.rowsNumber_ != expr.GetRows() || sz_.colsNumber_ != expr.GetColumns())
+	{
+		// Expression may refer to this matrix, so evaluate it before storage is replaced.
+		const Dimension size{ expr.GetRows(), expr.GetColumns() };
+		Matrix2D result = layout_ == Layout::RowMajor
+			? Matrix2D(size, padding_, uninitialized, GetAllocator())
+			: Matrix2D(size, layout_, uninitialized, GetAllocator());
+		EvaluateInto(expr, result.GetView());
+		*this = std::move(result);
+		return *this;
+	}
+
+	EvaluateInto(expr, GetView());
+
+	return *this;
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::Iterator Matrix2D<T, Alloc>::Begin() noexcept
 {
 	return elems_.begin();
 }
 
-template<typename T>
-typename Matrix2D<T>::Row::const_iterator Matrix2D<T>::Begin() const noexcept
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstIterator Matrix2D<T, Alloc>::Begin() const noexcept
 {
 	return elems_.begin();
 }
 
-template<typename T>
-typename Matrix2D<T>::Row::iterator Matrix2D<T>::End() noexcept
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::Iterator Matrix2D<T, Alloc>::End() noexcept
 {
 	return elems_.end();
 }
 
-template<typename T>
-typename Matrix2D<T>::Row::const_iterator Matrix2D<T>::End() const noexcept
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstIterator Matrix2D<T, Alloc>::End() const noexcept
 {
 	return elems_.end();
 }
 
-template<typename T>
-size_t Matrix2D<T>::GetColumns() const
+template<typename T, typename Alloc>
+size_t Matrix2D<T, Alloc>::GetColumns() const
 {
 	return sz_.colsNumber_;
 }
 
-template<typename T>
-size_t Matrix2D<T>::GetRows() const
+template<typename T, typename Alloc>
+size_t Matrix2D<T, Alloc>::GetRows() const
 {
 	return sz_.rowsNumber_;
 }
 
-template<typename T>
-typename Matrix2D<T>::Dimension Matrix2D<T>::GetSize() const
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::Dimension Matrix2D<T, Alloc>::GetSize() const
 {
 	return sz_;
 }
 
-template<typename T>
-T& Matrix2D<T>::operator()(const size_t row, const size_t column)
+template<typename T, typename Alloc>
+size_t Matrix2D<T, Alloc>::GetRowStride() const noexcept
 {
-	return elems_[row * sz_.colsNumber_ + column];
+	return layout_ == Layout::RowMajor ? stride_ : 1;
 }
 
-template<typename T>
-const T& Matrix2D<T>::operator()(const size_t row, const size_t column) const
+template<typename T, typename Alloc>
+size_t Matrix2D<T, Alloc>::GetColumnStride() const noexcept
 {
-	return elems_[row * sz_.colsNumber_ + column];
+	return layout_ == Layout::RowMajor ? 1 : stride_;
 }
 
-template<typename T>
-typename Matrix2D<T>::Row Matrix2D<T>::Slice(const size_t n) const
+template<typename T, typename Alloc>
+Layout Matrix2D<T, Alloc>::GetLayout() const noexcept
+{
+	return layout_;
+}
+
+template<typename T, typename Alloc>
+RowPadding Matrix2D<T, Alloc>::GetRowPadding() const noexcept
+{
+	return padding_;
+}
+
+template<typename T, typename Alloc>
+bool Matrix2D<T, Alloc>::IsContiguous() const noexcept
+{
+	return stride_ == (layout_ == Layout::RowMajor ? sz_.colsNumber_ : sz_.rowsNumber_);
+}
+
+template<typename T, typename Alloc>
+Alloc Matrix2D<T, Alloc>::GetAllocator() const
+{
+	return elems_.get_allocator();
+}
+
+template<typename T, typename Alloc>
+void Matrix2D<T, Alloc>::ClearPadding()
+{
+	if (stride_ == sz_.colsNumber_) {
+		return;
+	}
+
+	for (size_t r = 0; r < sz_.rowsNumber_; ++r)
+	{
+		const auto rowBegin = elems_.begin() + r * stride_;
+		std::fill(rowBegin + sz_.colsNumber_, rowBegin + stride_, T());
+	}
+}
+
+template<typename T, typename Alloc>
+void Matrix2D<T, Alloc>::FillInParallel(const T& defVal)
+{
+	// Small matrices are filled by the calling thread, starting threads costs more.
+	const size_t grain = std::max<size_t>(1, (size_t{ 1 } << 15) / std::max<size_t>(stride_, 1));
+	detail::ParallelFor(0, sz_.rowsNumber_, grain, [this, &defVal] (const size_t first, const size_t last)
+	{
+		for (size_t r = first; r < last; ++r)
+		{
+			const auto rowBegin = elems_.begin() + r * stride_;
+			std::fill(rowBegin, rowBegin + sz_.colsNumber_, defVal);
+			std::fill(rowBegin + sz_.colsNumber_, rowBegin + stride_, T());
+		}
+	});
+}
+
+template<typename T, typename Alloc>
+T& Matrix2D<T, Alloc>::operator()(const size_t row, const size_t column)
+{
+	return elems_[Index(row, column)];
+}
+
+template<typename T, typename Alloc>
+const T& Matrix2D<T, Alloc>::operator()(const size_t row, const size_t column) const
+{
+	return elems_[Index(row, column)];
+}
+
+template<typename T, typename Alloc>
+size_t Matrix2D<T, Alloc>::Index(const size_t row, const size_t column) const noexcept
+{
+	return layout_ == Layout::RowMajor ? row * stride_ + column : column * stride_ + row;
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::Row Matrix2D<T, Alloc>::Slice(const size_t n) const
 {
 	return Slice(n, 0, sz_.colsNumber_);
 }
 
-template<typename T>
-typename Matrix2D<T>::Row Matrix2D<T>::Slice(
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::Row Matrix2D<T, Alloc>::Slice(
 	const size_t n,
 	const size_t first,
 	const size_t last) const
@@ -243,14 +636,92 @@ typename Matrix2D<T>::Row Matrix2D<T>::Slice(
 		throw std::out_of_range("Matrix2D::Slice: arguments are out of range.");
 	}
 
+	MTX_INSTRUMENT(Slice, last > first ? last - first : 0);
 	Row tempRow = Row(last - first);
-	auto startPtr = elems_.begin() + n * sz_.colsNumber_ + first;
-	auto endPtr = elems_.begin() + n * sz_.colsNumber_ + last;
-	std::copy(startPtr, endPtr, tempRow.begin());
+	if (layout_ == Layout::RowMajor)
+	{
+		auto startPtr = elems_.begin() + n * stride_ + first;
+		auto endPtr = elems_.begin() + n * stride_ + last;
+		std::copy(startPtr, endPtr, tempRow.begin());
+	}
+	else
+	{
+		const auto row = GetView().Row(n);
+		std::copy(
+			row.Begin() + static_cast<std::ptrdiff_t>(first),
+			row.Begin() + static_cast<std::ptrdiff_t>(last),
+			tempRow.begin());
+	}
 
 	return tempRow;
 }
 
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::View Matrix2D<T, Alloc>::GetView() noexcept
+{
+	return View(
+		elems_.data(),
+		sz_.rowsNumber_,
+		sz_.colsNumber_,
+		static_cast<std::ptrdiff_t>(GetRowStride()),
+		static_cast<std::ptrdiff_t>(GetColumnStride()));
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstView Matrix2D<T, Alloc>::GetView() const noexcept
+{
+	return ConstView(
+		elems_.data(),
+		sz_.rowsNumber_,
+		sz_.colsNumber_,
+		static_cast<std::ptrdiff_t>(GetRowStride()),
+		static_cast<std::ptrdiff_t>(GetColumnStride()));
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::LineView Matrix2D<T, Alloc>::RowView(const size_t n)
+{
+	return GetView().Row(n);
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstLineView Matrix2D<T, Alloc>::RowView(const size_t n) const
+{
+	return GetView().Row(n);
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::LineView Matrix2D<T, Alloc>::ColumnView(const size_t n)
+{
+	return GetView().Column(n);
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstLineView Matrix2D<T, Alloc>::ColumnView(const size_t n) const
+{
+	return GetView().Column(n);
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::View Matrix2D<T, Alloc>::BlockView(
+	const size_t row,
+	const size_t column,
+	const size_t rows,
+	const size_t columns)
+{
+	return GetView().Block(row, column, rows, columns);
+}
+
+template<typename T, typename Alloc>
+typename Matrix2D<T, Alloc>::ConstView Matrix2D<T, Alloc>::BlockView(
+	const size_t row,
+	const size_t column,
+	const size_t rows,
+	const size_t columns) const
+{
+	return GetView().Block(row, column, rows, columns);
+}
+
 //
 // Utility functions.
 //
@@ -259,8 +730,8 @@ typename Matrix2D<T>::Row Matrix2D<T>::Slice(
 //! and distribution.
 //! Function does not modify explicitly generator and distribution, but requires these objects
 //! to be non-const.
-template<typename T, typename G, typename D>
-void RandomizeElements(Matrix2D<T>& mat, G& generator, D& distribution)
+template<typename T, typename Alloc, typename G, typename D>
+void RandomizeElements(Matrix2D<T, Alloc>& mat, G& generator, D& distribution)
 {
 	for (size_t r = 0; r < mat.GetRows(); ++r)
 	{
@@ -270,41 +741,73 @@ void RandomizeElements(Matrix2D<T>& mat, G& generator, D& distribution)
 	}
 }
 
+//! Same as above, blocks of rows are filled according to the policy. Every block has its own
+//! generator seeded with a value drawn from generator and a copy of distribution,
+//! so the result depends on the state of generator and sizes of the matrix, but not on
+//! the number of threads. Values differ from the ones of the sequential overload.
+template<typename Policy, typename T, typename Alloc, typename G, typename D>
+detail::EnableIfPolicy<Policy> RandomizeElements(
+	const Policy& policy,
+	Matrix2D<T, Alloc>& mat,
+	G& generator,
+	D& distribution)
+{
+	const size_t rows = mat.GetRows();
+	const size_t columns = mat.GetColumns();
+	const size_t rowsPerBlock = detail::RowsPerBlock(columns);
+	std::vector<typename G::result_type> seeds((rows + rowsPerBlock - 1) / rowsPerBlock);
+	for (auto& seed : seeds) {
+		seed = generator();
+	}
+
+	detail::ParallelFor(policy, 0, seeds.size(), 1, [&] (const size_t first, const size_t last)
+	{
+		for (size_t block = first; block < last; ++block)
+		{
+			G blockGenerator(seeds[block]);
+			D blockDistribution(distribution.param());
+			const size_t lastRow = std::min(rows, (block + 1) * rowsPerBlock);
+			for (size_t r = block * rowsPerBlock; r < lastRow; ++r)
+			{
+				for (size_t c = 0; c < columns; ++c) {
+					mat(r, c) = blockDistribution(blockGenerator);
+				}
+			}
+		}
+	});
+}
+
 //! Takes two arguments as sizes: number of rows and columns respectively.
-//! Returns Matrix2D object with specified size, matrix has randomized elements.
+//! Returns Matrix2D object with specified size, matrix has randomized elements
+//! from [0, 100] for integral types and from [0, 100) for floating point ones.
 //! Function works only with integral and floating point types, for allowed template
 //! parameters see std::is_floating_point and std::is_integral EXCEPT bool type,
 //! there is no support for bool.
 //! Checks type whether or not it is allowed at compile time.
-template<typename T>
-Matrix2D<typename std::enable_if_t<std::is_floating_point<T>::value, T>>
-CreateRandomMatrix2D(const size_t rows, const size_t columns)
+//! Elements are generated by CounterRng seeded with seed, blocks of rows are filled
+//! according to the policy and the result is the same for any policy, see RandomizeUniform.
+template<typename T, typename Policy>
+detail::EnableIfPolicy<Policy,
+	Matrix2D<typename std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, T>>>
+CreateRandomMatrix2D(const Policy& policy, const size_t rows, const size_t columns, const std::uint64_t seed = 0)
 {
-	std::default_random_engine generator;
-	std::uniform_real_distribution<T> distribution(static_cast<T>(0), static_cast<T>(100));
-
-	mtx::Matrix2D<T> tempMatrix{ rows, columns };
-	RandomizeElements(tempMatrix, generator, distribution);
+	mtx::Matrix2D<T> tempMatrix(typename Matrix2D<T>::Dimension{ rows, columns }, uninitialized);
+	RandomizeUniform(policy, tempMatrix.GetView(), seed, static_cast<T>(0), static_cast<T>(100));
 
 	return tempMatrix;
 }
 
+//! Same as above, blocks of rows are filled in parallel on the default scheduler.
 template<typename T>
-Matrix2D<typename std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value, T>>
-CreateRandomMatrix2D(const size_t rows, const size_t columns)
+Matrix2D<typename std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, T>>
+CreateRandomMatrix2D(const size_t rows, const size_t columns, const std::uint64_t seed = 0)
 {
-	std::default_random_engine generator;
-	std::uniform_int_distribution<T> distribution(static_cast<T>(0), static_cast<T>(100));
-
-	mtx::Matrix2D<T> tempMatrix{ rows, columns };
-	RandomizeElements(tempMatrix, generator, distribution);
-
-	return tempMatrix;
+	return CreateRandomMatrix2D<T>(execution::par, rows, columns, seed);
 }
 
 //! Prints elements of the specified matrix.
-template<typename T>
-void PrintMatrix2D(const Matrix2D<T>& mat)
+template<typename T, typename Alloc>
+void PrintMatrix2D(const Matrix2D<T, Alloc>& mat)
 {
 	const size_t rows = mat.GetRows();
 	const size_t columns = mat.GetColumns();
@@ -319,9 +822,40 @@ void PrintMatrix2D(const Matrix2D<T>& mat)
 	std::cout << "}\n";
 }
 
-//! Provides "equal to" operator for matrix.
+namespace detail
+{
+
+//! Returns true if all elements of views of the same sizes are equal.
+//! Views of column-major matrices are compared column by column.
 template<typename T>
-bool operator==(const Matrix2D<T>& left, const Matrix2D<T>& right)
+bool EqualViews(const Matrix2DView<const T>& left, const Matrix2DView<const T>& right)
+{
+	if (!(left.HasContiguousRows() && right.HasContiguousRows())
+		&& left.HasContiguousColumns() && right.HasContiguousColumns())
+	{
+		return EqualViews(left.Transposed(), right.Transposed());
+	}
+
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		const auto leftRow = left.Row(r);
+		const auto rightRow = right.Row(r);
+		const bool equal = leftRow.IsContiguous() && rightRow.IsContiguous()
+			? EqualRange(leftRow.Data(), rightRow.Data(), left.GetColumns())
+			: std::equal(leftRow.Begin(), leftRow.End(), rightRow.Begin());
+		if (!equal) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+}	// namespace detail
+
+//! Provides "equal to" operator for matrix.
+template<typename T, typename Alloc>
+bool operator==(const Matrix2D<T, Alloc>& left, const Matrix2D<T, Alloc>& right)
 {
 	if (&left == &right)
 	{
@@ -331,37 +865,318 @@ bool operator==(const Matrix2D<T>& left, const Matrix2D<T>& right)
 	{
 		return false;
 	}
-	
-	return std::equal(left.Begin(), left.End(), right.Begin());
+
+	// Comparison stops at the first mismatch, so the count is the upper bound of compared elements.
+	MTX_INSTRUMENT(Equal, 2 * left.GetRows() * left.GetColumns());
+	if (left.IsContiguous() && right.IsContiguous() && left.GetLayout() == right.GetLayout())
+	{
+		return detail::EqualRange(
+			left.GetView().Data(),
+			right.GetView().Data(),
+			left.GetRows() * left.GetColumns());
+	}
+
+	return detail::EqualViews(left.GetView(), right.GetView());
+}
+
+//! Compares matrices like operator==, blocks of rows are compared according to the policy.
+template<typename Policy, typename T, typename Alloc>
+detail::EnableIfPolicy<Policy, bool> Equal(
+	const Policy& policy,
+	const Matrix2D<T, Alloc>& left,
+	const Matrix2D<T, Alloc>& right)
+{
+	if (&left == &right)
+	{
+		return true;
+	}
+	else if (left.GetRows() != right.GetRows() || left.GetColumns() != right.GetColumns())
+	{
+		return false;
+	}
+
+	MTX_INSTRUMENT(Equal, 2 * left.GetRows() * left.GetColumns());
+	// Blocks after the first mismatch are skipped.
+	std::atomic<bool> mismatch{ false };
+	const size_t columns = left.GetColumns();
+	return detail::ParallelReduce(
+		policy,
+		0,
+		left.GetRows(),
+		detail::RowsPerBlock(columns),
+		true,
+		[&] (const size_t first, const size_t last)
+		{
+			if (mismatch.load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			const bool equal = detail::EqualViews(
+				left.BlockView(first, 0, last - first, columns),
+				right.BlockView(first, 0, last - first, columns));
+			if (!equal) {
+				mismatch.store(true, std::memory_order_relaxed);
+			}
+			return equal;
+		},
+		[] (const bool accumulated, const bool blockResult)
+		{
+			return accumulated && blockResult;
+		}) && !mismatch.load();
+}
+
+namespace detail
+{
+
+//! Returns matrix with sizes, layout, padding and allocator of mat and uninitialized elements.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> MakeUninitializedLike(const Matrix2D<T, Alloc>& mat)
+{
+	if (mat.GetLayout() == Layout::RowMajor) {
+		return Matrix2D<T, Alloc>(mat.GetSize(), mat.GetRowPadding(), uninitialized, mat.GetAllocator());
+	}
+
+	return Matrix2D<T, Alloc>(mat.GetSize(), mat.GetLayout(), uninitialized, mat.GetAllocator());
+}
+
+//! Writes result(r, c) = func(left(r, c), right(r, c)), sizes of views must match.
+template<typename L, typename R, typename O, typename BinaryOp>
+void TransformRows(
+	const Matrix2DView<L>& left,
+	const Matrix2DView<R>& right,
+	const Matrix2DView<O>& result,
+	BinaryOp func)
+{
+	const size_t rows = left.GetRows();
+	const size_t columns = left.GetColumns();
+	const bool contiguous =
+		left.HasContiguousRows() && right.HasContiguousRows() && result.HasContiguousRows();
+	// Views of column-major matrices are processed column by column.
+	if (!contiguous && left.HasContiguousColumns() && right.HasContiguousColumns() && result.HasContiguousColumns())
+	{
+		TransformRows(left.Transposed(), right.Transposed(), result.Transposed(), func);
+		return;
+	}
+
+	for (size_t r = 0; r < rows && columns > 0; ++r)
+	{
+		if (contiguous) {
+			detail::TransformRange(&left(r, 0), &right(r, 0), &result(r, 0), columns, func);
+		}
+		else
+		{
+			const auto leftRow = left.Row(r);
+			std::transform(leftRow.Begin(), leftRow.End(), right.Row(r).Begin(), result.Row(r).Begin(), func);
+		}
+	}
+}
+
+}	// namespace detail
+
+//! Writes result(r, c) = func(left(r, c), right(r, c)) into the existing storage
+//! viewed by result, doesn't allocate. Views may have arbitrary strides.
+template<typename L, typename R, typename O, typename BinaryOp>
+void TransformMatrices(
+	const Matrix2DView<L>& left,
+	const Matrix2DView<R>& right,
+	const Matrix2DView<O>& result,
+	BinaryOp func)
+{
+	bool sizesMismatch =
+		left.GetRows() != right.GetRows()
+		|| left.GetColumns() != right.GetColumns()
+		|| left.GetRows() != result.GetRows()
+		|| left.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(TransformMatrices, 3 * left.GetRows() * left.GetColumns());
+	detail::TransformRows(left, right, result, func);
+}
+
+//! Same as above, blocks of rows are processed according to the policy.
+template<typename Policy, typename L, typename R, typename O, typename BinaryOp>
+detail::EnableIfPolicy<Policy> TransformMatrices(
+	const Policy& policy,
+	const Matrix2DView<L>& left,
+	const Matrix2DView<R>& right,
+	const Matrix2DView<O>& result,
+	BinaryOp func)
+{
+	bool sizesMismatch =
+		left.GetRows() != right.GetRows()
+		|| left.GetColumns() != right.GetColumns()
+		|| left.GetRows() != result.GetRows()
+		|| left.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(TransformMatrices, 3 * left.GetRows() * left.GetColumns());
+	const size_t columns = left.GetColumns();
+	detail::ParallelFor(
+		policy,
+		0,
+		left.GetRows(),
+		detail::RowsPerBlock(columns),
+		[&] (const size_t first, const size_t last)
+		{
+			const size_t rows = last - first;
+			detail::TransformRows(
+				left.Block(first, 0, rows, columns),
+				right.Block(first, 0, rows, columns),
+				result.Block(first, 0, rows, columns),
+				func);
+		});
 }
 
 //! Returns matrix where elements are results of
 //! resultMat(r, c) = func(left(r, c), right(r, c)).
-template<typename T, typename BinaryOp>
-Matrix2D<T> TransformMatrices(const Matrix2D<T>& left, const Matrix2D<T>& right, BinaryOp func)
+//! Result has allocator and padding of rows of the left matrix.
+template<typename T, typename Alloc, typename BinaryOp>
+Matrix2D<T, Alloc> TransformMatrices(
+	const Matrix2D<T, Alloc>& left,
+	const Matrix2D<T, Alloc>& right,
+	BinaryOp func)
 {
 	if (left.GetRows() != right.GetRows() || left.GetColumns() != right.GetColumns()) {
 		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
 	}
 
-	Matrix2D<T> resultMat(left.GetSize());
-	std::transform(left.Begin(), left.End(), right.Begin(), resultMat.Begin(), func);
+	MTX_INSTRUMENT(TransformMatrices, 3 * left.GetRows() * left.GetColumns());
+	auto resultMat = detail::MakeUninitializedLike(left);
+	if (left.IsContiguous() && right.IsContiguous() && resultMat.IsContiguous() && left.GetLayout() == right.GetLayout())
+	{
+		detail::TransformRange(
+			left.GetView().Data(),
+			right.GetView().Data(),
+			resultMat.GetView().Data(),
+			left.GetRows() * left.GetColumns(),
+			func);
+	}
+	else {
+		detail::TransformRows(left.GetView(), right.GetView(), resultMat.GetView(), func);
+	}
 
 	return resultMat;
 }
 
-//! Returns the sum of two matrices.
-template<typename T>
-Matrix2D<T> operator+(const Matrix2D<T>& left, const Matrix2D<T>& right)
+//! Same as above, blocks of rows are processed according to the policy.
+//! Pages of the result are first touched by threads which calculate them.
+template<typename Policy, typename T, typename Alloc, typename BinaryOp>
+detail::EnableIfPolicy<Policy, Matrix2D<T, Alloc>> TransformMatrices(
+	const Policy& policy,
+	const Matrix2D<T, Alloc>& left,
+	const Matrix2D<T, Alloc>& right,
+	BinaryOp func)
 {
-	return TransformMatrices(left, right, std::plus<T>());
+	if (left.GetRows() != right.GetRows() || left.GetColumns() != right.GetColumns()) {
+		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
+	}
+
+	auto resultMat = detail::MakeUninitializedLike(left);
+	TransformMatrices(policy, left.GetView(), right.GetView(), resultMat.GetView(), func);
+
+	return resultMat;
 }
 
-//! Returns the difference of two matrices.
-template<typename T>
-Matrix2D<T> operator-(const Matrix2D<T>& left, const Matrix2D<T>& right)
+//! Returns matrix with evaluated elements of the expression.
+//! Sum, difference and scalar operators for matrices are lazy, see MatrixExpression.h.
+template<typename E>
+Matrix2D<typename E::ValueType> Evaluate(const MatrixExpression<E>& expr)
+{
+	return Matrix2D<typename E::ValueType>(expr);
+}
+
+//! Writes product of left and right matrices into the existing storage viewed by result,
+//! doesn't allocate the result. Result must not overlap with arguments.
+//! Uses cache-blocked kernel on packed panels, work is split between all cores.
+template<typename L, typename R, typename T>
+void Multiply(
+	const Matrix2DView<L>& left,
+	const Matrix2DView<R>& right,
+	const Matrix2DView<T>& result)
+{
+	bool sizesMismatch =
+		left.GetColumns() != right.GetRows()
+		|| left.GetRows() != result.GetRows()
+		|| right.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("Multiply: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(Multiply, left.GetRows() * left.GetColumns() + right.GetRows() * right.GetColumns() + result.GetRows() * result.GetColumns());
+	detail::Gemm<T>(left, right, result);
+}
+
+//! Returns product of two matrices, result has allocator and padding of rows of the left matrix.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> Multiply(const Matrix2D<T, Alloc>& left, const Matrix2D<T, Alloc>& right)
+{
+	if (left.GetColumns() != right.GetRows()) {
+		throw std::length_error("Multiply: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(
+		Multiply,
+		left.GetRows() * left.GetColumns() + right.GetRows() * right.GetColumns() + left.GetRows() * right.GetColumns());
+	Matrix2D<T, Alloc> resultMat(
+		typename Matrix2D<T, Alloc>::Dimension{ left.GetRows(), right.GetColumns() },
+		left.GetRowPadding(),
+		uninitialized,
+		left.GetAllocator());
+	detail::Gemm<T>(left.GetView(), right.GetView(), resultMat.GetView());
+
+	return resultMat;
+}
+
+//! Returns product of two matrices.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> operator*(const Matrix2D<T, Alloc>& left, const Matrix2D<T, Alloc>& right)
+{
+	return Multiply(left, right);
+}
+
+//! Returns transposed matrix with the layout and allocator of mat,
+//! blocks of rows of mat are transposed according to the policy.
+template<typename Policy, typename T, typename Alloc>
+detail::EnableIfPolicy<Policy, Matrix2D<T, Alloc>> Transpose(const Policy& policy, const Matrix2D<T, Alloc>& mat)
 {
-	return TransformMatrices(left, right, std::minus<T>());
+	Matrix2D<T, Alloc> resultMat(
+		typename Matrix2D<T, Alloc>::Dimension{ mat.GetColumns(), mat.GetRows() },
+		mat.GetLayout(),
+		uninitialized,
+		mat.GetAllocator());
+	Transpose(policy, mat.GetView(), resultMat.GetView());
+
+	return resultMat;
+}
+
+//! Returns transposed matrix, uses all cores.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> Transpose(const Matrix2D<T, Alloc>& mat)
+{
+	return Transpose(execution::par, mat);
+}
+
+//! Returns copy of the matrix with elements placed according to the layout.
+//! Change of the layout is a transposition of the storage, so it uses the blocked transpose.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> ConvertLayout(const Matrix2D<T, Alloc>& mat, const Layout layout)
+{
+	if (mat.GetLayout() == layout && mat.IsContiguous()) {
+		return mat;
+	}
+
+	Matrix2D<T, Alloc> resultMat(mat.GetSize(), layout, uninitialized, mat.GetAllocator());
+	// Element (r, c) of the source becomes element (c, r) of the transposed view of the result.
+	Transpose(execution::par, mat.GetView(), resultMat.GetView().Transposed());
+
+	return resultMat;
 }
 
 }	// namespace mtx
\ No newline at end of file
@@ -1,20 +1,296 @@
 #pragma once
 
+#include "matrix/BatchedMatrix.h"
 #include "matrix/Matrix.h"
+#include "matrix/Parallel.h"
+#include "matrix/Simd.h"
+#include "matrix/SparseMatrix.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <functional>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mtx
 {
+namespace detail
+{
+
+//! Random access iterator over the ring of the view: elements of its first and last rows
+//! and columns in clockwise order starting from the element (0, 0).
+//! The view must have at least two rows and two columns.
+template<typename T>
+class RingIterator
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	RingIterator() = default;
+	//! Constructor, position is the index in the ring.
+	RingIterator(const Matrix2DView<T>& view, const std::ptrdiff_t position) noexcept
+		: view_{ &view }
+		, position_{ position }
+	{
+	}
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of elements in the ring of the view.
+	static size_t GetLength(const Matrix2DView<T>& view) noexcept
+	{
+		return 2 * (view.GetRows() - 1) + 2 * (view.GetColumns() - 1);
+	}
+
+	reference operator*() const noexcept { return (*this)[0]; }
+	pointer operator->() const noexcept { return &(*this)[0]; }
+	reference operator[](const difference_type n) const noexcept
+	{
+		const auto width = static_cast<std::ptrdiff_t>(view_->GetColumns()) - 1;
+		const auto height = static_cast<std::ptrdiff_t>(view_->GetRows()) - 1;
+		auto k = position_ + n;
+		if (k < width) {
+			return (*view_)(0, static_cast<size_t>(k));
+		}
+		k -= width;
+		if (k < height) {
+			return (*view_)(static_cast<size_t>(k), static_cast<size_t>(width));
+		}
+		k -= height;
+		if (k < width) {
+			return (*view_)(static_cast<size_t>(height), static_cast<size_t>(width - k));
+		}
+		k -= width;
+		return (*view_)(static_cast<size_t>(height - k), 0);
+	}
+
+	RingIterator& operator++() noexcept { ++position_; return *this; }
+	RingIterator operator++(int) noexcept { auto tmp = *this; ++position_; return tmp; }
+	RingIterator& operator--() noexcept { --position_; return *this; }
+	RingIterator operator--(int) noexcept { auto tmp = *this; --position_; return tmp; }
+	RingIterator& operator+=(const difference_type n) noexcept { position_ += n; return *this; }
+	RingIterator& operator-=(const difference_type n) noexcept { position_ -= n; return *this; }
+
+	friend RingIterator operator+(RingIterator it, const difference_type n) noexcept { return it += n; }
+	friend RingIterator operator+(const difference_type n, RingIterator it) noexcept { return it += n; }
+	friend RingIterator operator-(RingIterator it, const difference_type n) noexcept { return it -= n; }
+	friend difference_type operator-(const RingIterator& l, const RingIterator& r) noexcept
+	{
+		return l.position_ - r.position_;
+	}
+
+	friend bool operator==(const RingIterator& l, const RingIterator& r) noexcept { return l.position_ == r.position_; }
+	friend bool operator!=(const RingIterator& l, const RingIterator& r) noexcept { return l.position_ != r.position_; }
+	friend bool operator<(const RingIterator& l, const RingIterator& r) noexcept { return l.position_ < r.position_; }
+	friend bool operator>(const RingIterator& l, const RingIterator& r) noexcept { return r < l; }
+	friend bool operator<=(const RingIterator& l, const RingIterator& r) noexcept { return !(r < l); }
+	friend bool operator>=(const RingIterator& l, const RingIterator& r) noexcept { return !(l < r); }
+
+	//
+	// Private data members.
+	//
+private:
+	//! View of the ring, the iterator doesn't own it.
+	const Matrix2DView<T>* view_ = { nullptr };
+	//! Index of the current element in the ring.
+	std::ptrdiff_t position_ = { 0 };
+};
+
+}	// namespace detail
+
+//! Analyses of Matrix2DAdapter which may be requested together by Analyze.
+enum class Analysis : unsigned
+{
+	None = 0,
+	CountLocalMinimums = 1 << 0,
+	LongestIdenticalSet = 1 << 1,
+	NonNegativeRowsMultiplication = 1 << 2,
+	SumOverMainDiagonal = 1 << 3,
+	All = (1 << 4) - 1
+};
+
+constexpr Analysis operator|(const Analysis left, const Analysis right) noexcept
+{
+	return static_cast<Analysis>(static_cast<unsigned>(left) | static_cast<unsigned>(right));
+}
+
+constexpr Analysis operator&(const Analysis left, const Analysis right) noexcept
+{
+	return static_cast<Analysis>(static_cast<unsigned>(left) & static_cast<unsigned>(right));
+}
+
+//! Results of analyses requested from Analyze, fields of analyses which weren't
+//! requested keep their default values.
+template<typename T>
+struct AnalysisResult
+{
+	//! Result of CountLocalMinimums.
+	int localMinimums_ = { 0 };
+	//! Result of LongestIdenticalSet.
+	int longestIdenticalSet_ = { -1 };
+	//! Result of NonNegativeRowsMultiplication.
+	T nonNegativeRowsMultiplication_ = { 1 };
+	//! Result of SumOverMainDiagonal.
+	T sumOverMainDiagonal_ = { 0 };
+};
+
+//! The longest set of identical neighboring elements of a row.
+struct IdenticalRun
+{
+	//! Number of elements in the set, it is 1 if the row has no identical neighbors.
+	size_t length_ = { 1 };
+	//! Column of the first element of the set.
+	size_t column_ = { 0 };
+};
+
+inline bool operator==(const IdenticalRun& left, const IdenticalRun& right) noexcept
+{
+	return left.length_ == right.length_ && left.column_ == right.column_;
+}
+
+inline bool operator!=(const IdenticalRun& left, const IdenticalRun& right) noexcept
+{
+	return !(left == right);
+}
 
 template<typename T>
 class Matrix2DAdapter
 	: private Matrix2D<T>
 {
+	//
+	// Nested types.
+	//
+private:
+	//! Partial results of rows of an analysis and rows changed since they were computed.
+	template<typename Partial>
+	struct RowPartials
+	{
+		//! Marks all rows of the matrix with specified number of rows as changed.
+		void Reset(const size_t rows)
+		{
+			partials_.assign(rows, Partial());
+			changed_.assign(rows, 1);
+			changedRows_.resize(rows);
+			std::iota(changedRows_.begin(), changedRows_.end(), size_t{ 0 });
+			combined_ = false;
+		}
+
+		void MarkChanged(const size_t row)
+		{
+			if (!changed_[row])
+			{
+				changed_[row] = 1;
+				changedRows_.push_back(row);
+			}
+		}
+
+		//! Recomputes partials of changed rows by computeRow(row), returns false
+		//! if nothing changed since the previous update, so the result is still valid.
+		template<typename Func>
+		bool Update(Func computeRow)
+		{
+			if (changedRows_.empty() && combined_) {
+				return false;
+			}
+			for (const size_t row : changedRows_)
+			{
+				partials_[row] = computeRow(row);
+				changed_[row] = 0;
+			}
+			changedRows_.clear();
+			combined_ = true;
+
+			return true;
+		}
+
+		std::vector<Partial> partials_;
+		std::vector<char> changed_;
+		std::vector<size_t> changedRows_;
+		//! True if the result is combined from the current partials.
+		bool combined_ = { false };
+	};
+
+	//! Partial results of a block of rows for Analyze.
+	struct AnalysisPartials
+	{
+		int localMinimums_;
+		std::pair<size_t, size_t> longestIdenticalSet_;
+		T nonNegativeRowsMultiplication_;
+		T sumOverMainDiagonal_;
+	};
+
+	//! Modes of the cache, see EnableCache and EnableConcurrentReaders.
+	enum Mode : unsigned
+	{
+		CachedPartials = 1 << 0,
+		ConcurrentReaders = 1 << 1
+	};
+
+	//! Cached partial results and snapshots for concurrent readers shared by all adapters of the matrix.
+	//! It is created by the first call of EnableCache or EnableConcurrentReaders.
+	struct Cache
+	{
+		~Cache()
+		{
+			if (modes_.load() != 0) {
+				--ActiveCaches();
+			}
+		}
+
+		//! Enabled modes, they are changed by SetMode.
+		std::atomic<unsigned> modes_ = { 0 };
+		std::mutex mutex_;
+		//! True if partials belong to the matrix with the storage and sizes below,
+		//! partials are reset when the matrix is resized or reallocated.
+		bool valid_ = { false };
+		const T* data_ = { nullptr };
+		size_t rows_ = { 0 };
+		size_t columns_ = { 0 };
+		//! Partials and results combined from them. Lengths of identical sets are kept per row,
+		//! products and sums per block of blockRows_ rows, as blocks of the overloads with
+		//! execution policy, so floating point results are the same with and without the cache.
+		RowPartials<size_t> identicalSets_;
+		int longestSet_ = { -1 };
+		size_t blockRows_ = { 1 };
+		RowPartials<T> products_;
+		T product_ = { 1 };
+		RowPartials<T> diagonalSums_;
+		T diagonalSum_ = { 0 };
+		//! Serializes writes of adapters, it is locked before mutex_ if both are needed.
+		std::mutex writeMutex_;
+		//! The latest published copy of the matrix, it is accessed by atomic functions of shared_ptr.
+		std::shared_ptr<const Matrix2D<T>> snapshot_;
+		//! The previously published copy, its storage is reused by the next snapshot
+		//! once readers release it, then only rows changed by the last two writes are copied.
+		std::shared_ptr<Matrix2D<T>> spare_;
+		//! Rows [spareFirst_, spareLast_) of the spare differ from the latest snapshot.
+		size_t spareFirst_ = { 0 };
+		size_t spareLast_ = { 0 };
+	};
+
 	//
 	// Construction and destruction.
 	//
@@ -40,29 +316,203 @@ public:
 public:
 	//! Returns number of local minimums in the matrix.
 	int CountLocalMinimums() const;
-	//! Applies cyclic shift to the matrix.
+	//! Applies cyclic shift to the matrix: elements of every ring move step positions
+	//! clockwise. Rings are rotated in place without allocations.
 	void CyclicShift(const size_t step = 1);
-	//! Returns number of row with longest set of identical elements.
-	//! Returns -1 if matrix is empty.
+	//! Returns number of row with longest set of identical neighboring elements,
+	//! the first of such rows wins. Returns -1 if matrix is empty.
 	int LongestIdenticalSet() const;
+	//! Returns the longest set of identical neighboring elements of every row, element r
+	//! of the result belongs to the row r. Neighbors are compared by vector kernels
+	//! when the element type allows it.
+	std::vector<IdenticalRun> LongestIdenticalRuns() const;
 	//! Calculates multiplication of elements in rows with all non negative elements.
 	T NonNegativeRowsMultiplication() const;
 	//! Calculates sum of elements situated over the main diagonal.
 	T SumOverMainDiagonal() const;
+	//! Enables caching of partial results of rows for LongestIdenticalSet,
+	//! NonNegativeRowsMultiplication and SumOverMainDiagonal, so repeated calls recompute
+	//! only rows changed since the previous call. The cache is shared by all adapters
+	//! of the matrix. Elements must be changed with SetElement, ModifyRows or CyclicShift
+	//! of an adapter, other writes must be reported with MarkRowsDirty.
+	//! Products and sums are cached by blocks of rows and the whole block of a changed row
+	//! is recomputed, so results are equal to the ones without the cache.
+	//! Modes of the cache must not be enabled while other threads write the matrix.
+	void EnableCache();
+	//! Disables caching for all adapters of the matrix and frees cached partials.
+	void DisableCache();
+	//! Returns true if analyses use cached partials.
+	bool IsCacheEnabled() const;
+	//! Enables concurrent readers for all adapters of the matrix. Writes of adapters
+	//! (CyclicShift, SetElement and ModifyRows) are serialized, every write publishes
+	//! a copy of the matrix when it finishes, rows of the previous copy are reused
+	//! once readers release it. Analyses read the latest copy without waiting for writers,
+	//! so every analysis sees the matrix as it was between two writes.
+	//! Every SetElement publishes a copy as well, it is a full copy of the matrix if a reader
+	//! still holds the previous one, so many elements should be written by a single ModifyRows.
+	//! Other writes must be reported with MarkRowsDirty, which publishes them.
+	//! Cached partials aren't used while readers are concurrent.
+	void EnableConcurrentReaders();
+	//! Disables concurrent readers for all adapters of the matrix and frees the copies.
+	void DisableConcurrentReaders();
+	//! Returns true if analyses read published copies of the matrix.
+	bool IsConcurrent() const;
+	//! Returns the matrix read by analyses: the latest published copy if readers are concurrent,
+	//! otherwise the matrix itself. Several analyses of the copy see the same state of the matrix.
+	std::shared_ptr<const Matrix2D<T>> GetSnapshot() const;
+	//! Sets the element and marks its row changed. Writes take locks of the cache
+	//! only while caching or concurrent readers are enabled for some matrix.
+	void SetElement(const size_t row, const size_t column, const T& value);
+	//! Calls func(view) with the view of rows [first, last) and marks them changed.
+	template<typename Func>
+	void ModifyRows(const size_t first, const size_t last, Func func);
+	//! Marks rows [first, last) changed, e.g. after they are written by another owner of the matrix.
+	void MarkRowsDirty(const size_t first, const size_t last);
+	//! Performs requested analyses in a single pass over rows of the matrix: every row
+	//! is processed by all analyses while it is in the cache. Results are equal to the
+	//! results of the overloads with execution policy. Cached partials aren't used.
+	AnalysisResult<T> Analyze(const Analysis analyses = Analysis::All) const;
+	//! Same analyses applied to an arbitrary view, e.g. a row band or a block
+	//! of a bigger matrix. They don't allocate and don't require an adapter object.
+	static int CountLocalMinimums(const Matrix2DView<const T>& view);
+	static int LongestIdenticalSet(const Matrix2DView<const T>& view);
+	static std::vector<IdenticalRun> LongestIdenticalRuns(const Matrix2DView<const T>& view);
+	static T NonNegativeRowsMultiplication(const Matrix2DView<const T>& view);
+	static T SumOverMainDiagonal(const Matrix2DView<const T>& view);
+	//! Applies cyclic shift to the view.
+	static void CyclicShift(const Matrix2DView<T>& view, const size_t step = 1);
+	static AnalysisResult<T> Analyze(const Matrix2DView<const T>& view, const Analysis analyses = Analysis::All);
+	//! Same analyses of the sparse matrix, results are equal to the ones of its dense matrix.
+	//! Zero elements are taken into account without visiting them, so the analyses take time
+	//! proportional to the number of non-zeros rather than the number of elements.
+	static int CountLocalMinimums(const SparseMatrix2D<T>& mat);
+	static int LongestIdenticalSet(const SparseMatrix2D<T>& mat);
+	static T NonNegativeRowsMultiplication(const SparseMatrix2D<T>& mat);
+	static T SumOverMainDiagonal(const SparseMatrix2D<T>& mat);
+	//! Same analyses of every matrix of the batch, element b of the result belongs to matrix b.
+	//! Planes of the batch are processed by loops over matrices, which are vectorized.
+	//! Results are equal to the ones of separate matrices, except sums of floating point elements
+	//! which are accumulated in order of elements and may differ in the last bits.
+	static std::vector<int> CountLocalMinimums(const BatchedMatrix2D<T>& batch);
+	static std::vector<int> LongestIdenticalSet(const BatchedMatrix2D<T>& batch);
+	static std::vector<T> NonNegativeRowsMultiplication(const BatchedMatrix2D<T>& batch);
+	static std::vector<T> SumOverMainDiagonal(const BatchedMatrix2D<T>& batch);
+	//! Same analyses where blocks of rows are processed according to the execution policy.
+	//! Partial results of blocks are combined in order of blocks, blocks don't depend
+	//! on the number of threads, so results are reproducible for any policy.
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, int> CountLocalMinimums(const Policy& policy) const;
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, int> LongestIdenticalSet(const Policy& policy) const;
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, std::vector<IdenticalRun>> LongestIdenticalRuns(const Policy& policy) const;
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, T> NonNegativeRowsMultiplication(const Policy& policy) const;
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, T> SumOverMainDiagonal(const Policy& policy) const;
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, int> CountLocalMinimums(
+		const Policy& policy,
+		const Matrix2DView<const T>& view);
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, AnalysisResult<T>> Analyze(
+		const Policy& policy,
+		const Analysis analyses = Analysis::All) const;
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, AnalysisResult<T>> Analyze(
+		const Policy& policy,
+		const Matrix2DView<const T>& view,
+		const Analysis analyses = Analysis::All);
+	//! Applies cyclic shift where independent rings are rotated according to the execution policy.
+	template<typename Policy>
+	detail::EnableIfPolicy<Policy, void> CyclicShift(const Policy& policy, const size_t step = 1);
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, void> CyclicShift(
+		const Policy& policy,
+		const Matrix2DView<T>& view,
+		const size_t step = 1);
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, int> LongestIdenticalSet(
+		const Policy& policy,
+		const Matrix2DView<const T>& view);
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, std::vector<IdenticalRun>> LongestIdenticalRuns(
+		const Policy& policy,
+		const Matrix2DView<const T>& view);
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, T> NonNegativeRowsMultiplication(
+		const Policy& policy,
+		const Matrix2DView<const T>& view);
+	template<typename Policy>
+	static detail::EnableIfPolicy<Policy, T> SumOverMainDiagonal(
+		const Policy& policy,
+		const Matrix2DView<const T>& view);
+	//! Parts of the analyses working on rows [first, last) of the view, they allow to process
+	//! a matrix by parts and to combine partial results in order of rows, e.g. when rows
+	//! are streamed from the disk.
+	//! Returns number of local minimums in rows [first, last), rows around them
+	//! are used as neighbors only.
+	static int CountLocalMinimums(const Matrix2DView<const T>& view, const size_t first, const size_t last);
+	//! Returns the longest set of identical elements in rows [first, last) and number of its row,
+	//! the set must be longer than one element, otherwise {1, first} is returned.
+	static std::pair<size_t, size_t> LongestIdenticalSet(
+		const Matrix2DView<const T>& view,
+		const size_t first,
+		const size_t last);
+	//! Multiplies init by elements of non negative rows in [first, last).
+	static T NonNegativeRowsMultiplication(
+		const Matrix2DView<const T>& view,
+		const size_t first,
+		const size_t last,
+		T init);
+	//! Adds to init elements of rows [first, last) situated to the right of the element (i, i)
+	//! of the row i.
+	static T SumOverMainDiagonal(const Matrix2DView<const T>& view, const size_t first, const size_t last, T init);
 
 	//
 	// Private methods.
 	//
 private:
-	//! Checks if the specified with row and column element is local minimum of the matrix.
-	bool CheckNeighbors(const size_t row, const size_t column) const;
-	//! Returns vector containing all elements situated n indexes from the edge.
-	//! Function doesn't check whether n is allowed number, you should
-	//! check it yourself (floor(smallerDimension/2)).
-	std::vector<T> GetCycle(const size_t n) const;
-	//! Replaces cycle n with given vector elements.
-	//! Doesn't check any of parameters.
-	void SetCycle(const size_t n, std::vector<T> elements);
+	//! Returns the longest set of identical neighboring elements of the row r.
+	static IdenticalRun LongestRun(const Matrix2DView<const T>& view, const size_t r);
+	static IdenticalRun LongestRun(const SparseMatrix2D<T>& mat, const size_t r);
+	//! Returns number of rows which have elements over the main diagonal.
+	static size_t RowsOverMainDiagonal(const Matrix2DView<const T>& view);
+	//! Checks if the specified with row and column element is local minimum of the view.
+	static bool CheckNeighbors(const Matrix2DView<const T>& view, const size_t row, const size_t column);
+	static bool CheckNeighbors(const SparseMatrix2D<T>& mat, const size_t row, const size_t column);
+	//! Calls write() while writes of other adapters of the matrix are blocked,
+	//! then marks rows [first, last) changed even if write throws.
+	//! Without active modes of the cache write() is called without locks.
+	template<typename Func>
+	void WriteRows(const size_t first, const size_t last, Func write);
+	//! Marks rows [first, last) changed and publishes them if readers are concurrent,
+	//! write mutex of the cache must be locked.
+	void RowsChanged(Cache& cache, const size_t first, const size_t last);
+	//! Publishes the copy of the matrix where rows [first, last) are changed since
+	//! the latest snapshot, write mutex of the cache must be locked.
+	void Publish(Cache& cache, const size_t first, const size_t last);
+	//! Returns cache of the matrix. If there is none, it is created if create is true,
+	//! otherwise null is returned. The cache is looked up only if there is an active cache
+	//! of some matrix or create is true, found cache is kept by the adapter.
+	std::shared_ptr<Cache> FindCache(const bool create) const;
+	//! Returns cache of the matrix if some of its modes are enabled, otherwise null.
+	//! It takes a single atomic load while no cache of any matrix is active.
+	std::shared_ptr<Cache> GetActiveCache() const;
+	//! Returns cache of the matrix if analyses use cached partials, otherwise null.
+	std::shared_ptr<Cache> GetPartialsCache() const;
+	//! Enables or disables the mode of the cache and counts active caches.
+	static void SetMode(Cache& cache, const Mode mode, const bool enabled);
+	//! Returns number of caches with enabled modes of all matrices of type T.
+	static std::atomic<size_t>& ActiveCaches() noexcept;
+	//! Resets cached partials if the matrix was resized or reallocated and returns
+	//! view of the matrix. Mutex of the cache must be locked.
+	Matrix2DView<const T> PrepareCache(Cache& cache) const;
+	//! Returns number of rings which are shifted, the middle row or column
+	//! of a view with odd smaller dimension isn't a ring.
+	static size_t RingsNumber(const Matrix2DView<T>& view) noexcept;
+	//! Rotates clockwise by step positions elements situated n indexes from the edge.
+	static void RotateRing(const Matrix2DView<T>& view, const size_t n, const size_t step);
 
 	//
 	// Private data members.
@@ -70,6 +520,9 @@ private:
 private:
 	//! Pointer to Matrix object for processing.
 	std::shared_ptr<Matrix2D<T>> matPtr_;
+	//! Cached partial results of the matrix, it is set by FindCache and accessed
+	//! by atomic functions of shared_ptr, since const methods may set it concurrently.
+	mutable std::shared_ptr<Cache> cache_;
 };
 
 template<typename T>
@@ -82,6 +535,7 @@ template<typename T>
 Matrix2DAdapter<T>::Matrix2DAdapter(Matrix2DAdapter<T>&& other) noexcept
 {
 	std::swap(matPtr_, other.matPtr_);
+	std::swap(cache_, other.cache_);
 }
 
 template<typename T>
@@ -92,13 +546,16 @@ Matrix2DAdapter<T>& Matrix2DAdapter<T>::operator=(Matrix2DAdapter<T>&& other) no
 	}
 
 	std::swap(matPtr_, other.matPtr_);
+	std::swap(cache_, other.cache_);
 
 	return *this;
 }
 
 template<typename T>
 Matrix2DAdapter<T>::Matrix2DAdapter(const Matrix2DAdapter<T>& other)
-	: matPtr_{ other.matPtr_ }
+	: Matrix2D<T>()
+	, matPtr_{ other.matPtr_ }
+	, cache_{ std::atomic_load(&other.cache_) }
 {
 }
 
@@ -110,22 +567,89 @@ Matrix2DAdapter<T>& Matrix2DAdapter<T>::operator=(const Matrix2DAdapter<T>& othe
 	}
 
 	matPtr_ = other.matPtr_;
+	cache_ = std::atomic_load(&other.cache_);
 
 	return *this;
 }
 
 template<typename T>
 int Matrix2DAdapter<T>::CountLocalMinimums() const
+{
+	const auto snapshot = GetSnapshot();
+	return CountLocalMinimums(snapshot->GetView());
+}
+
+template<typename T>
+int Matrix2DAdapter<T>::CountLocalMinimums(const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(CountLocalMinimums, view.GetRows() * view.GetColumns());
+	// Neighborhoods are symmetric, so columns of column-major matrices are scanned as rows.
+	if (!view.HasContiguousRows() && view.HasContiguousColumns()) {
+		return CountLocalMinimums(view.Transposed(), 0, view.GetColumns());
+	}
+
+	return CountLocalMinimums(view, 0, view.GetRows());
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, int> Matrix2DAdapter<T>::CountLocalMinimums(const Policy& policy) const
+{
+	const auto snapshot = GetSnapshot();
+	return CountLocalMinimums(policy, snapshot->GetView());
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, int> Matrix2DAdapter<T>::CountLocalMinimums(
+	const Policy& policy,
+	const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(CountLocalMinimums, view.GetRows() * view.GetColumns());
+	const bool columnMajor = !view.HasContiguousRows() && view.HasContiguousColumns();
+	const auto scanned = columnMajor ? view.Transposed() : view;
+	return detail::ParallelReduce(
+		policy,
+		0,
+		scanned.GetRows(),
+		detail::RowsPerBlock(scanned.GetColumns()),
+		0,
+		[&scanned] (const size_t first, const size_t last)
+		{
+			return CountLocalMinimums(scanned, first, last);
+		},
+		std::plus<int>());
+}
+
+template<typename T>
+int Matrix2DAdapter<T>::CountLocalMinimums(
+	const Matrix2DView<const T>& view,
+	const size_t first,
+	const size_t last)
 {
 	int counter = 0;
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
 
-	for (size_t r = 0; r < rows; ++r)
+	for (size_t r = first; r < last; ++r)
 	{
+		// Elements with all eight neighbors are checked by the stencil kernel,
+		// the first and the last rows and columns of the view have fewer neighbors.
+		if (r > 0 && r + 1 < rows && columns > 2 && view.HasContiguousRows())
+		{
+			counter += static_cast<int>(detail::CountRowMinimums(
+				view.Row(r - 1).Data(),
+				view.Row(r).Data(),
+				view.Row(r + 1).Data(),
+				columns));
+			counter += CheckNeighbors(view, r, 0) ? 1 : 0;
+			counter += CheckNeighbors(view, r, columns - 1) ? 1 : 0;
+			continue;
+		}
+
 		for (size_t c = 0; c < columns; ++c)
 		{
-			if (CheckNeighbors(r, c)) {
+			if (CheckNeighbors(view, r, c)) {
 				++counter;
 			}
 		}
@@ -137,223 +661,1292 @@ int Matrix2DAdapter<T>::CountLocalMinimums() const
 template<typename T>
 void Matrix2DAdapter<T>::CyclicShift(const size_t step)
 {
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	const size_t smallerDimension = (rows < columns) ? rows : columns;
+	// The outer ring passes through every row.
+	WriteRows(0, matPtr_->GetRows(), [this, step] { CyclicShift(matPtr_->GetView(), step); });
+}
 
-	const auto depth = static_cast<size_t>(smallerDimension/2);
-	for (size_t i = 0; i < depth; ++i) 
-	{
-		std::vector<T> cycleVec = GetCycle(i);
-		std::rotate(cycleVec.begin(), cycleVec.end() - step, cycleVec.end());
-		SetCycle(i, cycleVec);
+template<typename T>
+void Matrix2DAdapter<T>::CyclicShift(const Matrix2DView<T>& view, const size_t step)
+{
+	MTX_INSTRUMENT(CyclicShift, view.GetRows() * view.GetColumns());
+	const size_t depth = RingsNumber(view);
+	for (size_t i = 0; i < depth; ++i) {
+		RotateRing(view, i, step);
 	}
 }
 
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, void> Matrix2DAdapter<T>::CyclicShift(const Policy& policy, const size_t step)
+{
+	WriteRows(0, matPtr_->GetRows(), [this, &policy, step] { CyclicShift(policy, matPtr_->GetView(), step); });
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, void> Matrix2DAdapter<T>::CyclicShift(
+	const Policy& policy,
+	const Matrix2DView<T>& view,
+	const size_t step)
+{
+	MTX_INSTRUMENT(CyclicShift, view.GetRows() * view.GetColumns());
+	// Rings don't share elements, outer rings are longer, so every ring is a separate task.
+	detail::ParallelFor(policy, 0, RingsNumber(view), 1, [&view, step] (const size_t first, const size_t last)
+	{
+		for (size_t i = first; i < last; ++i) {
+			RotateRing(view, i, step);
+		}
+	});
+}
+
 template<typename T>
 int Matrix2DAdapter<T>::LongestIdenticalSet() const
 {
-	// If matrix is empty.
-	if (matPtr_->GetRows() == 0) {
-		return -1;
+	const auto cache = GetPartialsCache();
+	if (!cache)
+	{
+		const auto snapshot = GetSnapshot();
+		return LongestIdenticalSet(snapshot->GetView());
 	}
 
-	int number = 0;
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	size_t longestSet = 1;
-
-	// Check every row and look for identical elements.
-	for (size_t r = 0; r < rows; ++r)
+	std::lock_guard<std::mutex> lock(cache->mutex_);
+	const auto view = PrepareCache(*cache);
+	auto& sets = cache->identicalSets_;
+	// Only changed rows are scanned again.
+	MTX_INSTRUMENT(LongestIdenticalSet, sets.changedRows_.size() * view.GetColumns());
+	if (sets.Update([&view] (const size_t r) { return LongestRun(view, r).length_; }))
 	{
-		size_t currentLength = 1;
-		for (size_t c = 1; c < columns; ++c)
+		// The first of the longest sets wins as in the scan of all rows.
+		size_t number = 0;
+		size_t longestSet = 1;
+		for (size_t r = 0; r < sets.partials_.size(); ++r)
 		{
-			if ((*matPtr_)(r, c) == (*matPtr_)(r, c - 1)) {
-				++currentLength;
-			}
-
-			if (currentLength > longestSet)
+			if (sets.partials_[r] > longestSet)
 			{
-				longestSet = currentLength;
-				number = static_cast<int>(r);
+				longestSet = sets.partials_[r];
+				number = r;
 			}
 		}
+		cache->longestSet_ = static_cast<int>(number);
 	}
 
-	return number;
+	return view.GetRows() == 0 ? -1 : cache->longestSet_;
 }
 
 template<typename T>
-T Matrix2DAdapter<T>::NonNegativeRowsMultiplication() const
+int Matrix2DAdapter<T>::LongestIdenticalSet(const Matrix2DView<const T>& view)
 {
-	T multiplication = 1;
-	const size_t columns = matPtr_->GetColumns();
-	// Pointers to first and past-the-end elements in the row.
-	auto startOfRow = matPtr_->Begin();
-	const auto endOfVector = matPtr_->End();
-	while (startOfRow != endOfVector)
-	{
-		// Check if there are negative elements in the row.
-		bool hasNegativeElems = std::any_of(
-			startOfRow,
-			startOfRow + columns,
-			[] (const T& val)
-			{
-				return val < 0;
-			});
-		
-		if (!hasNegativeElems)
-		{
-			multiplication = std::accumulate(
-				startOfRow,
-				startOfRow + columns,
-				multiplication,
-				std::multiplies<T>());
-		}
-
-		startOfRow += columns;
+	MTX_INSTRUMENT(LongestIdenticalSet, view.GetRows() * view.GetColumns());
+	// If matrix is empty.
+	if (view.GetRows() == 0) {
+		return -1;
 	}
 
-	return multiplication;
+	return static_cast<int>(LongestIdenticalSet(view, 0, view.GetRows()).second);
 }
 
 template<typename T>
-T Matrix2DAdapter<T>::SumOverMainDiagonal() const
+std::vector<IdenticalRun> Matrix2DAdapter<T>::LongestIdenticalRuns() const
 {
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	if (rows == 0 || columns == 0) {
-		return 0;
-	}
-	if (rows == 1 || columns == 1) {
-		return (*matPtr_)(0, 0);
-	}
-	// Choose size of smaller dimension.
-	const size_t smallerDimension = (rows < columns) ? rows : columns;
-	T sumVal = 0;
-	// Sum elements from main diagonal (not including elements on main diagonal itself)
-	// to the end of i'th row until end of the vector is reached.
-	auto endOfRow = matPtr_->Begin() + columns;
-	const auto endOfVector = matPtr_->End();
-	for (size_t i = 0; i < smallerDimension; ++i)
-	{
-		sumVal += std::accumulate(endOfRow - columns + i + 1, endOfRow, 0);
-		if (endOfRow == endOfVector) {
-			break;
-		}
-		endOfRow += columns;
-	}
+	const auto snapshot = GetSnapshot();
+	return LongestIdenticalRuns(snapshot->GetView());
+}
 
-	return sumVal;
+template<typename T>
+std::vector<IdenticalRun> Matrix2DAdapter<T>::LongestIdenticalRuns(const Matrix2DView<const T>& view)
+{
+	return LongestIdenticalRuns(execution::seq, view);
 }
 
 template<typename T>
-bool Matrix2DAdapter<T>::CheckNeighbors(const size_t r, const size_t c) const
+template<typename Policy>
+detail::EnableIfPolicy<Policy, std::vector<IdenticalRun>> Matrix2DAdapter<T>::LongestIdenticalRuns(
+	const Policy& policy) const
 {
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	const T& currentElement = (*matPtr_)(r, c);
-	// Check neighbors to the left, to the right, above and under
-	// the given element respectively.
-	if (c > 0 && (*matPtr_)(r, c - 1) <= currentElement) {
-		return false;
-	}
+	const auto snapshot = GetSnapshot();
+	return LongestIdenticalRuns(policy, snapshot->GetView());
+}
 
-	if (c < columns - 1 && (*matPtr_)(r, c + 1) <= currentElement) {
-		return false;
-	}
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, std::vector<IdenticalRun>> Matrix2DAdapter<T>::LongestIdenticalRuns(
+	const Policy& policy,
+	const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(LongestIdenticalSet, view.GetRows() * view.GetColumns());
+	std::vector<IdenticalRun> runs(view.GetRows());
+	detail::ParallelFor(
+		policy,
+		0,
+		view.GetRows(),
+		detail::RowsPerBlock(view.GetColumns()),
+		[&view, &runs] (const size_t first, const size_t last)
+		{
+			for (size_t r = first; r < last; ++r) {
+				runs[r] = LongestRun(view, r);
+			}
+		});
 
-	if (r > 0 && (*matPtr_)(r - 1, c) <= currentElement) {
-		return false;
-	}
+	return runs;
+}
 
-	if (r < rows - 1 && (*matPtr_)(r + 1, c) <= currentElement) {
-		return false;
-	}
-	// Check neighbors on upper left, upper right, bottom left
-	// and bottom right corners of the given element.
-	if (r > 0 && c > 0 && (*matPtr_)(r - 1, c - 1) <= currentElement) {
-		return false;
-	} 
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, int> Matrix2DAdapter<T>::LongestIdenticalSet(const Policy& policy) const
+{
+	const auto snapshot = GetSnapshot();
+	return LongestIdenticalSet(policy, snapshot->GetView());
+}
 
-	if (r > 0 && c < columns - 1 && (*matPtr_)(r - 1, c + 1) <= currentElement) {
-		return false;
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, int> Matrix2DAdapter<T>::LongestIdenticalSet(
+	const Policy& policy,
+	const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(LongestIdenticalSet, view.GetRows() * view.GetColumns());
+	// If matrix is empty.
+	if (view.GetRows() == 0) {
+		return -1;
 	}
 
-	if (r < rows - 1 && c > 0 && (*matPtr_)(r + 1, c - 1) <= currentElement) {
-		return false;
-	}
+	// The first of the longest sets wins, so a block replaces the result only with a longer set.
+	const auto longest = detail::ParallelReduce(
+		policy,
+		0,
+		view.GetRows(),
+		detail::RowsPerBlock(view.GetColumns()),
+		std::make_pair(size_t{ 1 }, size_t{ 0 }),
+		[&view] (const size_t first, const size_t last)
+		{
+			return LongestIdenticalSet(view, first, last);
+		},
+		[] (const std::pair<size_t, size_t>& accumulated, const std::pair<size_t, size_t>& blockResult)
+		{
+			return blockResult.first > accumulated.first ? blockResult : accumulated;
+		});
 
-	if (r < rows - 1 && c < columns - 1 && (*matPtr_)(r + 1, c + 1) <= currentElement) {
-		return false;
-	}
+	return static_cast<int>(longest.second);
+}
 
-	return true;
+template<typename T>
+IdenticalRun Matrix2DAdapter<T>::LongestRun(const Matrix2DView<const T>& view, const size_t r)
+{
+	const size_t columns = view.GetColumns();
+	const auto run = view.HasContiguousRows() && columns > 0
+		? detail::LongestRunInRange(&view(r, 0), columns)
+		: simd::scalar::LongestRun<T>(view.Row(r).Begin(), columns);
+
+	return IdenticalRun{ run.first, run.second };
 }
 
 template<typename T>
-std::vector<T> Matrix2DAdapter<T>::GetCycle(const size_t n) const
+std::pair<size_t, size_t> Matrix2DAdapter<T>::LongestIdenticalSet(
+	const Matrix2DView<const T>& view,
+	const size_t first,
+	const size_t last)
 {
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	// Find out size of the slice, for example for n == 1
-	// and Matrix 3*3 it will be 8 elements.
-	std::vector<T> cycleVec;
-	cycleVec.reserve(2 * columns + 2 * (rows - 2));
-	// Copy upper edge.
-	for (size_t i = n; i < columns - n; ++i) {
-		cycleVec.push_back((*matPtr_)(n, i));
-	}
-	// Copy right edge.
-	for (size_t i = n + 1; i < rows - n - 1; ++i) {
-		cycleVec.push_back((*matPtr_)(i, columns - n - 1));
-	}
-	// Copy bottom edge.
-	for (size_t i = columns - n - 1; i >= n; --i)
+	size_t number = first;
+	size_t longestSet = 1;
+
+	// Check every row and look for identical elements.
+	for (size_t r = first; r < last; ++r)
 	{
-		cycleVec.push_back((*matPtr_)(rows - n - 1, i));
-		if (i == 0) {
-			break;
+		const size_t currentLength = LongestRun(view, r).length_;
+		if (currentLength > longestSet)
+		{
+			longestSet = currentLength;
+			number = r;
 		}
 	}
-	// Copy left edge.
-	for (size_t i = rows - n - 2; i >= n + 1; --i)
-	{
-		cycleVec.push_back((*matPtr_)(i, n));
-	}
 
-	return cycleVec;
+	return std::make_pair(longestSet, number);
 }
 
 template<typename T>
-void Matrix2DAdapter<T>::SetCycle(const size_t n, std::vector<T> elements)
+T Matrix2DAdapter<T>::NonNegativeRowsMultiplication() const
 {
-	const size_t rows = matPtr_->GetRows();
-	const size_t columns = matPtr_->GetColumns();
-	size_t vectorElem = 0;
-
-	// Copy upper edge.
-	for (size_t i = n; i < columns - n; ++i) {
-		(*matPtr_)(n, i) = elements[vectorElem++];
-	}
-	// Copy right edge.
-	for (size_t i = n + 1; i < rows - n - 1; ++i) {
-		(*matPtr_)(i, columns - n - 1) = elements[vectorElem++];
-	}
-	// Copy bottom edge.
-	for (size_t i = columns - n - 1; i >= n; --i)
+	const auto cache = GetPartialsCache();
+	if (!cache)
 	{
-		(*matPtr_)(rows - n - 1, i) = elements[vectorElem++];
-		if (i == 0) {
-			break;
-		}
+		// Blocks are combined as in the cached path.
+		const auto snapshot = GetSnapshot();
+		return NonNegativeRowsMultiplication(execution::seq, snapshot->GetView());
 	}
-	// Copy left edge.
-	for (size_t i = rows - n - 2; i >= n + 1; --i) 
+
+	std::lock_guard<std::mutex> lock(cache->mutex_);
+	const auto view = PrepareCache(*cache);
+	auto& products = cache->products_;
+	const size_t blockRows = cache->blockRows_;
+	MTX_INSTRUMENT(NonNegativeRowsMultiplication, products.changedRows_.size() * blockRows * view.GetColumns());
+	const bool changed = products.Update([&view, blockRows] (const size_t block)
+	{
+		const size_t first = block * blockRows;
+		return NonNegativeRowsMultiplication(view, first, std::min(first + blockRows, view.GetRows()), 1);
+	});
+	if (changed)
 	{
-		(*matPtr_)(i, n) = elements[vectorElem++];
+		cache->product_ = std::accumulate(
+			products.partials_.begin(),
+			products.partials_.end(),
+			static_cast<T>(1),
+			std::multiplies<T>());
 	}
+
+	return cache->product_;
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::NonNegativeRowsMultiplication(const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(NonNegativeRowsMultiplication, view.GetRows() * view.GetColumns());
+	return NonNegativeRowsMultiplication(view, 0, view.GetRows(), 1);
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, T> Matrix2DAdapter<T>::NonNegativeRowsMultiplication(const Policy& policy) const
+{
+	const auto snapshot = GetSnapshot();
+	return NonNegativeRowsMultiplication(policy, snapshot->GetView());
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, T> Matrix2DAdapter<T>::NonNegativeRowsMultiplication(
+	const Policy& policy,
+	const Matrix2DView<const T>& view)
+{
+	MTX_INSTRUMENT(NonNegativeRowsMultiplication, view.GetRows() * view.GetColumns());
+	return detail::ParallelReduce(
+		policy,
+		0,
+		view.GetRows(),
+		detail::RowsPerBlock(view.GetColumns()),
+		static_cast<T>(1),
+		[&view] (const size_t first, const size_t last)
+		{
+			return NonNegativeRowsMultiplication(view, first, last, 1);
+		},
+		std::multiplies<T>());
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::NonNegativeRowsMultiplication(
+	const Matrix2DView<const T>& view,
+	const size_t first,
+	const size_t last,
+	T init)
+{
+	T multiplication = init;
+	for (size_t r = first; r < last; ++r)
+	{
+		const auto row = view.Row(r);
+		// Check if there are negative elements in the row.
+		bool hasNegativeElems = view.HasContiguousRows()
+			? detail::AnyNegativeInRange(row.Data(), row.GetSize())
+			: std::any_of(
+				row.Begin(),
+				row.End(),
+				[] (const T& val)
+				{
+					return val < 0;
+				});
+		
+		if (!hasNegativeElems)
+		{
+			multiplication = std::accumulate(
+				row.Begin(),
+				row.End(),
+				multiplication,
+				std::multiplies<T>());
+		}
+	}
+
+	return multiplication;
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::SumOverMainDiagonal() const
+{
+	const size_t rows = matPtr_->GetRows();
+	const size_t columns = matPtr_->GetColumns();
+	const auto cache = rows > 1 && columns > 1 ? GetPartialsCache() : nullptr;
+	if (!cache)
+	{
+		// Blocks are combined as in the cached path.
+		const auto snapshot = GetSnapshot();
+		return SumOverMainDiagonal(execution::seq, snapshot->GetView());
+	}
+
+	std::lock_guard<std::mutex> lock(cache->mutex_);
+	const auto view = PrepareCache(*cache);
+	auto& sums = cache->diagonalSums_;
+	const size_t blockRows = cache->blockRows_;
+	MTX_INSTRUMENT(SumOverMainDiagonal, sums.changedRows_.size() * blockRows * view.GetColumns());
+	const size_t diagonalRows = RowsOverMainDiagonal(view);
+	const bool changed = sums.Update([&view, blockRows, diagonalRows] (const size_t block)
+	{
+		const size_t first = block * blockRows;
+		return first < diagonalRows
+			? SumOverMainDiagonal(view, first, std::min(first + blockRows, diagonalRows), 0)
+			: static_cast<T>(0);
+	});
+	if (changed)
+	{
+		// Only blocks with rows over the main diagonal are added, as in the overloads with policy.
+		const size_t diagonalBlocks = (diagonalRows + blockRows - 1) / blockRows;
+		cache->diagonalSum_ = std::accumulate(
+			sums.partials_.begin(),
+			sums.partials_.begin() + static_cast<std::ptrdiff_t>(diagonalBlocks),
+			static_cast<T>(0));
+	}
+
+	return cache->diagonalSum_;
+}
+
+template<typename T>
+AnalysisResult<T> Matrix2DAdapter<T>::Analyze(const Analysis analyses) const
+{
+	const auto snapshot = GetSnapshot();
+	return Analyze(execution::seq, snapshot->GetView(), analyses);
+}
+
+template<typename T>
+AnalysisResult<T> Matrix2DAdapter<T>::Analyze(const Matrix2DView<const T>& view, const Analysis analyses)
+{
+	return Analyze(execution::seq, view, analyses);
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, AnalysisResult<T>> Matrix2DAdapter<T>::Analyze(
+	const Policy& policy,
+	const Analysis analyses) const
+{
+	const auto snapshot = GetSnapshot();
+	return Analyze(policy, snapshot->GetView(), analyses);
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, AnalysisResult<T>> Matrix2DAdapter<T>::Analyze(
+	const Policy& policy,
+	const Matrix2DView<const T>& view,
+	const Analysis analyses)
+{
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
+	MTX_INSTRUMENT(Analyze, rows * columns);
+	const bool minimums = (analyses & Analysis::CountLocalMinimums) != Analysis::None;
+	const bool identicalSet = (analyses & Analysis::LongestIdenticalSet) != Analysis::None;
+	const bool multiplication = (analyses & Analysis::NonNegativeRowsMultiplication) != Analysis::None;
+	// Matrices with a single row or column have the special result of SumOverMainDiagonal.
+	const bool diagonalSum = (analyses & Analysis::SumOverMainDiagonal) != Analysis::None
+		&& rows > 1 && columns > 1;
+	const size_t diagonalRows = diagonalSum ? RowsOverMainDiagonal(view) : 0;
+
+	const AnalysisPartials identity{ 0, std::make_pair(size_t{ 1 }, size_t{ 0 }), 1, 0 };
+	const auto partials = detail::ParallelReduce(
+		policy,
+		0,
+		rows,
+		detail::RowsPerBlock(columns),
+		identity,
+		[&] (const size_t first, const size_t last)
+		{
+			auto block = identity;
+			block.longestIdenticalSet_.second = first;
+			for (size_t r = first; r < last; ++r)
+			{
+				if (minimums) {
+					block.localMinimums_ += CountLocalMinimums(view, r, r + 1);
+				}
+				if (identicalSet)
+				{
+					const size_t length = LongestRun(view, r).length_;
+					if (length > block.longestIdenticalSet_.first) {
+						block.longestIdenticalSet_ = std::make_pair(length, r);
+					}
+				}
+				if (multiplication)
+				{
+					block.nonNegativeRowsMultiplication_ =
+						NonNegativeRowsMultiplication(view, r, r + 1, block.nonNegativeRowsMultiplication_);
+				}
+				if (r < diagonalRows) {
+					block.sumOverMainDiagonal_ = SumOverMainDiagonal(view, r, r + 1, block.sumOverMainDiagonal_);
+				}
+			}
+
+			return block;
+		},
+		[] (AnalysisPartials accumulated, const AnalysisPartials& block)
+		{
+			accumulated.localMinimums_ += block.localMinimums_;
+			// The first of the longest sets wins.
+			if (block.longestIdenticalSet_.first > accumulated.longestIdenticalSet_.first) {
+				accumulated.longestIdenticalSet_ = block.longestIdenticalSet_;
+			}
+			accumulated.nonNegativeRowsMultiplication_ *= block.nonNegativeRowsMultiplication_;
+			accumulated.sumOverMainDiagonal_ += block.sumOverMainDiagonal_;
+
+			return accumulated;
+		});
+
+	AnalysisResult<T> result;
+	if (minimums) {
+		result.localMinimums_ = partials.localMinimums_;
+	}
+	if (identicalSet && rows > 0) {
+		result.longestIdenticalSet_ = static_cast<int>(partials.longestIdenticalSet_.second);
+	}
+	if (multiplication) {
+		result.nonNegativeRowsMultiplication_ = partials.nonNegativeRowsMultiplication_;
+	}
+	if ((analyses & Analysis::SumOverMainDiagonal) != Analysis::None) {
+		result.sumOverMainDiagonal_ = diagonalSum ? partials.sumOverMainDiagonal_ : SumOverMainDiagonal(view);
+	}
+
+	return result;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::EnableCache()
+{
+	const auto cache = FindCache(true);
+	std::lock_guard<std::mutex> lock(cache->mutex_);
+	if ((cache->modes_.load() & CachedPartials) == 0)
+	{
+		// Partials are computed by the first call of every analysis.
+		cache->valid_ = false;
+		SetMode(*cache, CachedPartials, true);
+	}
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::DisableCache()
+{
+	const auto cache = FindCache(false);
+	if (!cache) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(cache->mutex_);
+	SetMode(*cache, CachedPartials, false);
+	cache->valid_ = false;
+	cache->identicalSets_ = RowPartials<size_t>();
+	cache->products_ = RowPartials<T>();
+	cache->diagonalSums_ = RowPartials<T>();
+}
+
+template<typename T>
+bool Matrix2DAdapter<T>::IsCacheEnabled() const
+{
+	const auto cache = GetActiveCache();
+	return cache && (cache->modes_.load() & CachedPartials) != 0;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::EnableConcurrentReaders()
+{
+	const auto cache = FindCache(true);
+	std::lock_guard<std::mutex> lock(cache->writeMutex_);
+	if ((cache->modes_.load() & ConcurrentReaders) != 0) {
+		return;
+	}
+
+	cache->spare_.reset();
+	Publish(*cache, 0, matPtr_->GetRows());
+	SetMode(*cache, ConcurrentReaders, true);
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::DisableConcurrentReaders()
+{
+	const auto cache = FindCache(false);
+	if (!cache) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(cache->writeMutex_);
+	SetMode(*cache, ConcurrentReaders, false);
+	// Readers which have already taken the snapshot keep it alive.
+	std::atomic_store(&cache->snapshot_, std::shared_ptr<const Matrix2D<T>>());
+	cache->spare_.reset();
+}
+
+template<typename T>
+bool Matrix2DAdapter<T>::IsConcurrent() const
+{
+	const auto cache = GetActiveCache();
+	return cache && (cache->modes_.load() & ConcurrentReaders) != 0;
+}
+
+template<typename T>
+std::shared_ptr<const Matrix2D<T>> Matrix2DAdapter<T>::GetSnapshot() const
+{
+	const auto cache = GetActiveCache();
+	if (cache && (cache->modes_.load() & ConcurrentReaders) != 0)
+	{
+		auto snapshot = std::atomic_load(&cache->snapshot_);
+		// Readers may have been disabled since the check.
+		if (snapshot) {
+			return snapshot;
+		}
+	}
+
+	return matPtr_;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::SetElement(const size_t row, const size_t column, const T& value)
+{
+	if (row >= matPtr_->GetRows() || column >= matPtr_->GetColumns()) {
+		throw std::out_of_range("SetElement: element is out of range.");
+	}
+
+	WriteRows(row, row + 1, [this, row, column, &value] { (*matPtr_)(row, column) = value; });
+}
+
+template<typename T>
+template<typename Func>
+void Matrix2DAdapter<T>::ModifyRows(const size_t first, const size_t last, Func func)
+{
+	if (first > last || last > matPtr_->GetRows()) {
+		throw std::out_of_range("ModifyRows: rows are out of range.");
+	}
+
+	WriteRows(first, last, [this, first, last, &func]
+	{
+		func(matPtr_->BlockView(first, 0, last - first, matPtr_->GetColumns()));
+	});
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::MarkRowsDirty(const size_t first, const size_t last)
+{
+	if (first > last || last > matPtr_->GetRows()) {
+		throw std::out_of_range("MarkRowsDirty: rows are out of range.");
+	}
+
+	const auto cache = GetActiveCache();
+	if (!cache) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(cache->writeMutex_);
+	RowsChanged(*cache, first, last);
+}
+
+template<typename T>
+template<typename Func>
+void Matrix2DAdapter<T>::WriteRows(const size_t first, const size_t last, Func write)
+{
+	const auto cache = GetActiveCache();
+	if (!cache)
+	{
+		write();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(cache->writeMutex_);
+	// Rows are marked even if write throws, since they may be partially written.
+	struct Marker
+	{
+		~Marker() { adapter_.RowsChanged(cache_, first_, last_); }
+		Matrix2DAdapter& adapter_;
+		Cache& cache_;
+		size_t first_;
+		size_t last_;
+	} marker{ *this, *cache, first, last };
+
+	write();
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::RowsChanged(Cache& cache, const size_t first, const size_t last)
+{
+	if ((cache.modes_.load() & ConcurrentReaders) != 0) {
+		Publish(cache, first, last);
+	}
+
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	// Partials of another layout are reset anyway.
+	if ((cache.modes_.load() & CachedPartials) == 0
+		|| !cache.valid_
+		|| cache.data_ != matPtr_->GetView().Data()
+		|| cache.rows_ != matPtr_->GetRows()
+		|| cache.columns_ != matPtr_->GetColumns()
+		|| first >= last)
+	{
+		return;
+	}
+
+	for (size_t r = first; r < last; ++r) {
+		cache.identicalSets_.MarkChanged(r);
+	}
+	for (size_t block = first / cache.blockRows_; block <= (last - 1) / cache.blockRows_; ++block)
+	{
+		cache.products_.MarkChanged(block);
+		cache.diagonalSums_.MarkChanged(block);
+	}
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::SumOverMainDiagonal(const Matrix2DView<const T>& view)
+{
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
+	MTX_INSTRUMENT(SumOverMainDiagonal, rows * columns);
+	if (rows == 0 || columns == 0) {
+		return 0;
+	}
+	if (rows == 1 || columns == 1) {
+		return view(0, 0);
+	}
+
+	return SumOverMainDiagonal(view, 0, RowsOverMainDiagonal(view), 0);
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, T> Matrix2DAdapter<T>::SumOverMainDiagonal(const Policy& policy) const
+{
+	const auto snapshot = GetSnapshot();
+	return SumOverMainDiagonal(policy, snapshot->GetView());
+}
+
+template<typename T>
+template<typename Policy>
+detail::EnableIfPolicy<Policy, T> Matrix2DAdapter<T>::SumOverMainDiagonal(
+	const Policy& policy,
+	const Matrix2DView<const T>& view)
+{
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
+	MTX_INSTRUMENT(SumOverMainDiagonal, rows * columns);
+	if (rows == 0 || columns == 0) {
+		return 0;
+	}
+	if (rows == 1 || columns == 1) {
+		return view(0, 0);
+	}
+
+	return detail::ParallelReduce(
+		policy,
+		0,
+		RowsOverMainDiagonal(view),
+		detail::RowsPerBlock(columns),
+		static_cast<T>(0),
+		[&view] (const size_t first, const size_t last)
+		{
+			return SumOverMainDiagonal(view, first, last, 0);
+		},
+		std::plus<T>());
+}
+
+template<typename T>
+size_t Matrix2DAdapter<T>::RowsOverMainDiagonal(const Matrix2DView<const T>& view)
+{
+	// Choose size of smaller dimension, the last column has nothing to its right.
+	const size_t smallerDimension = std::min(view.GetRows(), view.GetColumns());
+	return std::min(smallerDimension, view.GetColumns() - 1);
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::SumOverMainDiagonal(
+	const Matrix2DView<const T>& view,
+	const size_t first,
+	const size_t last,
+	T init)
+{
+	const size_t columns = view.GetColumns();
+	T sumVal = init;
+	// Sum elements from main diagonal (not including elements on main diagonal itself)
+	// to the end of i'th row.
+	for (size_t i = first; i < last; ++i)
+	{
+		const auto row = view.Row(i);
+		sumVal = view.HasContiguousRows()
+			? detail::SumRange(row.Data() + i + 1, columns - i - 1, sumVal)
+			: std::accumulate(row.Begin() + i + 1, row.End(), sumVal);
+	}
+
+	return sumVal;
+}
+
+template<typename T>
+int Matrix2DAdapter<T>::CountLocalMinimums(const SparseMatrix2D<T>& mat)
+{
+	MTX_INSTRUMENT(CountLocalMinimums, mat.GetNonZeros());
+	const size_t rows = mat.GetRows();
+	const size_t columns = mat.GetColumns();
+	if (rows == 0 || columns == 0) {
+		return 0;
+	}
+	// The only element has no neighbors.
+	if (rows == 1 && columns == 1) {
+		return 1;
+	}
+
+	const auto& offsets = mat.GetRowOffsets();
+	const auto& columnIndices = mat.GetColumnIndices();
+	const auto& values = mat.GetValues();
+	int counter = 0;
+	// A zero element is local minimum only if all its neighbors are stored and greater than zero,
+	// so zeros around stored positive elements are the only zeros to check.
+	std::vector<std::pair<size_t, size_t>> zeros;
+	for (size_t r = 0; r < rows; ++r)
+	{
+		for (size_t i = offsets[r]; i < offsets[r + 1]; ++i)
+		{
+			const size_t c = columnIndices[i];
+			if (CheckNeighbors(mat, r, c)) {
+				++counter;
+			}
+			if (values[i] <= T()) {
+				continue;
+			}
+
+			for (size_t nr = r > 0 ? r - 1 : r; nr <= r + 1 && nr < rows; ++nr)
+			{
+				for (size_t nc = c > 0 ? c - 1 : c; nc <= c + 1 && nc < columns; ++nc)
+				{
+					if (mat.Find(nr, nc) == nullptr) {
+						zeros.emplace_back(nr, nc);
+					}
+				}
+			}
+		}
+	}
+
+	std::sort(zeros.begin(), zeros.end());
+	zeros.erase(std::unique(zeros.begin(), zeros.end()), zeros.end());
+	for (const auto& zero : zeros)
+	{
+		if (CheckNeighbors(mat, zero.first, zero.second)) {
+			++counter;
+		}
+	}
+
+	return counter;
+}
+
+template<typename T>
+int Matrix2DAdapter<T>::LongestIdenticalSet(const SparseMatrix2D<T>& mat)
+{
+	MTX_INSTRUMENT(LongestIdenticalSet, mat.GetNonZeros());
+	// If matrix is empty.
+	if (mat.GetRows() == 0) {
+		return -1;
+	}
+
+	size_t number = 0;
+	size_t longestSet = 1;
+	for (size_t r = 0; r < mat.GetRows(); ++r)
+	{
+		const size_t currentLength = LongestRun(mat, r).length_;
+		if (currentLength > longestSet)
+		{
+			longestSet = currentLength;
+			number = r;
+		}
+	}
+
+	return static_cast<int>(number);
+}
+
+template<typename T>
+IdenticalRun Matrix2DAdapter<T>::LongestRun(const SparseMatrix2D<T>& mat, const size_t r)
+{
+	const size_t columns = mat.GetColumns();
+	const auto& offsets = mat.GetRowOffsets();
+	const auto& columnIndices = mat.GetColumnIndices();
+	const auto& values = mat.GetValues();
+	// Gaps between stored elements are runs of zeros, stored elements never equal zeros,
+	// so only neighboring stored elements are compared.
+	IdenticalRun longest;
+	IdenticalRun current{ 0, 0 };
+	bool zeros = false;
+	const auto finishRun = [&longest, &current]
+	{
+		if (current.length_ > longest.length_) {
+			longest = current;
+		}
+	};
+	size_t column = 0;
+	for (size_t i = offsets[r]; i < offsets[r + 1]; ++i)
+	{
+		const size_t c = columnIndices[i];
+		if (c > column)
+		{
+			finishRun();
+			current = IdenticalRun{ c - column, column };
+			zeros = true;
+		}
+		// Without a gap the previous element is stored in the previous column.
+		if (!zeros && current.length_ > 0 && values[i - 1] == values[i]) {
+			++current.length_;
+		}
+		else
+		{
+			finishRun();
+			current = IdenticalRun{ 1, c };
+		}
+		zeros = false;
+		column = c + 1;
+	}
+	if (columns > column)
+	{
+		finishRun();
+		current = IdenticalRun{ columns - column, column };
+	}
+	finishRun();
+
+	return longest;
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::NonNegativeRowsMultiplication(const SparseMatrix2D<T>& mat)
+{
+	MTX_INSTRUMENT(NonNegativeRowsMultiplication, mat.GetNonZeros());
+	const auto& offsets = mat.GetRowOffsets();
+	const auto values = mat.GetValues().begin();
+	T multiplication = 1;
+	for (size_t r = 0; r < mat.GetRows(); ++r)
+	{
+		const auto rowBegin = values + static_cast<std::ptrdiff_t>(offsets[r]);
+		const auto rowEnd = values + static_cast<std::ptrdiff_t>(offsets[r + 1]);
+		if (std::any_of(rowBegin, rowEnd, [] (const T& val) { return val < 0; })) {
+			continue;
+		}
+
+		multiplication = std::accumulate(rowBegin, rowEnd, multiplication, std::multiplies<T>());
+		// Non negative row with zeros turns the product into zero.
+		if (offsets[r + 1] - offsets[r] < mat.GetColumns()) {
+			multiplication = multiplication * static_cast<T>(0);
+		}
+	}
+
+	return multiplication;
+}
+
+template<typename T>
+T Matrix2DAdapter<T>::SumOverMainDiagonal(const SparseMatrix2D<T>& mat)
+{
+	MTX_INSTRUMENT(SumOverMainDiagonal, mat.GetNonZeros());
+	const size_t rows = mat.GetRows();
+	const size_t columns = mat.GetColumns();
+	if (rows == 0 || columns == 0) {
+		return 0;
+	}
+	if (rows == 1 || columns == 1) {
+		return mat(0, 0);
+	}
+
+	const auto& offsets = mat.GetRowOffsets();
+	const auto& columnIndices = mat.GetColumnIndices();
+	const auto& values = mat.GetValues();
+	const size_t diagonalRows = std::min(rows, columns - 1);
+	T sumVal = 0;
+	for (size_t r = 0; r < diagonalRows; ++r)
+	{
+		const auto rowBegin = columnIndices.begin() + static_cast<std::ptrdiff_t>(offsets[r]);
+		const auto rowEnd = columnIndices.begin() + static_cast<std::ptrdiff_t>(offsets[r + 1]);
+		for (auto it = std::upper_bound(rowBegin, rowEnd, r); it != rowEnd; ++it) {
+			sumVal += values[static_cast<size_t>(it - columnIndices.begin())];
+		}
+	}
+
+	return sumVal;
+}
+
+template<typename T>
+bool Matrix2DAdapter<T>::CheckNeighbors(const SparseMatrix2D<T>& mat, const size_t r, const size_t c)
+{
+	const size_t rows = mat.GetRows();
+	const size_t columns = mat.GetColumns();
+	const T currentElement = mat(r, c);
+	for (size_t nr = r > 0 ? r - 1 : r; nr <= r + 1 && nr < rows; ++nr)
+	{
+		for (size_t nc = c > 0 ? c - 1 : c; nc <= c + 1 && nc < columns; ++nc)
+		{
+			if ((nr != r || nc != c) && mat(nr, nc) <= currentElement) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+std::vector<int> Matrix2DAdapter<T>::CountLocalMinimums(const BatchedMatrix2D<T>& batch)
+{
+	MTX_INSTRUMENT(CountLocalMinimums, batch.GetCount() * batch.GetRows() * batch.GetColumns());
+	const size_t count = batch.GetCount();
+	const size_t rows = batch.GetRows();
+	const size_t columns = batch.GetColumns();
+	std::vector<int> counters(count, 0);
+	// Flags of matrices whose element is still a candidate for the local minimum.
+	std::vector<unsigned char> minimums(count);
+	for (size_t r = 0; r < rows; ++r)
+	{
+		for (size_t c = 0; c < columns; ++c)
+		{
+			const T* current = batch.Plane(r, c);
+			std::fill(minimums.begin(), minimums.end(), static_cast<unsigned char>(1));
+			for (size_t nr = r > 0 ? r - 1 : r; nr <= r + 1 && nr < rows; ++nr)
+			{
+				for (size_t nc = c > 0 ? c - 1 : c; nc <= c + 1 && nc < columns; ++nc)
+				{
+					if (nr == r && nc == c) {
+						continue;
+					}
+
+					const T* neighbor = batch.Plane(nr, nc);
+					for (size_t b = 0; b < count; ++b) {
+						minimums[b] &= static_cast<unsigned char>(!(neighbor[b] <= current[b]));
+					}
+				}
+			}
+			for (size_t b = 0; b < count; ++b) {
+				counters[b] += minimums[b];
+			}
+		}
+	}
+
+	return counters;
+}
+
+template<typename T>
+std::vector<int> Matrix2DAdapter<T>::LongestIdenticalSet(const BatchedMatrix2D<T>& batch)
+{
+	MTX_INSTRUMENT(LongestIdenticalSet, batch.GetCount() * batch.GetRows() * batch.GetColumns());
+	const size_t count = batch.GetCount();
+	// If matrices are empty.
+	if (batch.GetRows() == 0) {
+		return std::vector<int>(count, -1);
+	}
+
+	std::vector<int> numbers(count, 0);
+	std::vector<size_t> longestSets(count, 1);
+	// Length of the current set and of the longest set of the row of every matrix.
+	std::vector<size_t> currentLengths(count);
+	std::vector<size_t> lengths(count);
+	for (size_t r = 0; r < batch.GetRows(); ++r)
+	{
+		std::fill(currentLengths.begin(), currentLengths.end(), size_t{ 1 });
+		std::fill(lengths.begin(), lengths.end(), size_t{ 1 });
+		for (size_t c = 1; c < batch.GetColumns(); ++c)
+		{
+			const T* previous = batch.Plane(r, c - 1);
+			const T* current = batch.Plane(r, c);
+			// The set is continued or restarted without branches, so the loop is vectorized.
+			for (size_t b = 0; b < count; ++b)
+			{
+				currentLengths[b] = static_cast<size_t>(current[b] == previous[b]) * currentLengths[b] + 1;
+				lengths[b] = std::max(lengths[b], currentLengths[b]);
+			}
+		}
+		for (size_t b = 0; b < count; ++b)
+		{
+			// The first of the longest sets wins as in the scan of a single matrix.
+			if (lengths[b] > longestSets[b])
+			{
+				longestSets[b] = lengths[b];
+				numbers[b] = static_cast<int>(r);
+			}
+		}
+	}
+
+	return numbers;
+}
+
+template<typename T>
+std::vector<T> Matrix2DAdapter<T>::NonNegativeRowsMultiplication(const BatchedMatrix2D<T>& batch)
+{
+	MTX_INSTRUMENT(NonNegativeRowsMultiplication, batch.GetCount() * batch.GetRows() * batch.GetColumns());
+	const size_t count = batch.GetCount();
+	std::vector<T> products(count, static_cast<T>(1));
+	std::vector<unsigned char> negative(count);
+	for (size_t r = 0; r < batch.GetRows(); ++r)
+	{
+		std::fill(negative.begin(), negative.end(), static_cast<unsigned char>(0));
+		for (size_t c = 0; c < batch.GetColumns(); ++c)
+		{
+			const T* plane = batch.Plane(r, c);
+			for (size_t b = 0; b < count; ++b) {
+				negative[b] |= static_cast<unsigned char>(plane[b] < 0);
+			}
+		}
+		// Elements are multiplied in the same order as in a single matrix, so results are equal.
+		for (size_t c = 0; c < batch.GetColumns(); ++c)
+		{
+			const T* plane = batch.Plane(r, c);
+			for (size_t b = 0; b < count; ++b) {
+				products[b] = negative[b] ? products[b] : products[b] * plane[b];
+			}
+		}
+	}
+
+	return products;
+}
+
+template<typename T>
+std::vector<T> Matrix2DAdapter<T>::SumOverMainDiagonal(const BatchedMatrix2D<T>& batch)
+{
+	MTX_INSTRUMENT(SumOverMainDiagonal, batch.GetCount() * batch.GetRows() * batch.GetColumns());
+	const size_t count = batch.GetCount();
+	const size_t rows = batch.GetRows();
+	const size_t columns = batch.GetColumns();
+	if (rows == 0 || columns == 0) {
+		return std::vector<T>(count, static_cast<T>(0));
+	}
+	if (rows == 1 || columns == 1) {
+		return std::vector<T>(batch.Plane(0, 0), batch.Plane(0, 0) + count);
+	}
+
+	std::vector<T> sums(count, static_cast<T>(0));
+	const size_t diagonalRows = std::min(rows, columns - 1);
+	for (size_t r = 0; r < diagonalRows; ++r)
+	{
+		for (size_t c = r + 1; c < columns; ++c)
+		{
+			const T* plane = batch.Plane(r, c);
+			for (size_t b = 0; b < count; ++b) {
+				sums[b] += plane[b];
+			}
+		}
+	}
+
+	return sums;
+}
+
+template<typename T>
+bool Matrix2DAdapter<T>::CheckNeighbors(
+	const Matrix2DView<const T>& view,
+	const size_t r,
+	const size_t c)
+{
+	const size_t rows = view.GetRows();
+	const size_t columns = view.GetColumns();
+	const T& currentElement = view(r, c);
+	// Check neighbors to the left, to the right, above and under
+	// the given element respectively.
+	if (c > 0 && view(r, c - 1) <= currentElement) {
+		return false;
+	}
+
+	if (c < columns - 1 && view(r, c + 1) <= currentElement) {
+		return false;
+	}
+
+	if (r > 0 && view(r - 1, c) <= currentElement) {
+		return false;
+	}
+
+	if (r < rows - 1 && view(r + 1, c) <= currentElement) {
+		return false;
+	}
+	// Check neighbors on upper left, upper right, bottom left
+	// and bottom right corners of the given element.
+	if (r > 0 && c > 0 && view(r - 1, c - 1) <= currentElement) {
+		return false;
+	} 
+
+	if (r > 0 && c < columns - 1 && view(r - 1, c + 1) <= currentElement) {
+		return false;
+	}
+
+	if (r < rows - 1 && c > 0 && view(r + 1, c - 1) <= currentElement) {
+		return false;
+	}
+
+	if (r < rows - 1 && c < columns - 1 && view(r + 1, c + 1) <= currentElement) {
+		return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::Publish(Cache& cache, const size_t first, const size_t last)
+{
+	auto& spare = cache.spare_;
+	const Matrix2D<T>& mat = *matPtr_;
+	std::shared_ptr<Matrix2D<T>> next;
+	const bool reusable =
+		spare
+		&& spare.use_count() == 1
+		&& spare->GetRows() == mat.GetRows()
+		&& spare->GetColumns() == mat.GetColumns()
+		&& spare->GetLayout() == mat.GetLayout()
+		&& spare->GetRowStride() == mat.GetRowStride();
+	if (reusable)
+	{
+		// Readers of the spare have released it, their reads must happen before our writes.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		next = std::move(spare);
+		const size_t copyFirst = std::min(first, cache.spareFirst_);
+		const size_t copyLast = std::max(last, cache.spareLast_);
+		MTX_INSTRUMENT(Copy, (copyLast - copyFirst) * mat.GetColumns());
+		const auto source = mat.GetView();
+		const auto target = next->GetView();
+		for (size_t r = copyFirst; r < copyLast; ++r) {
+			std::copy(source.Row(r).Begin(), source.Row(r).End(), target.Row(r).Begin());
+		}
+	}
+	else
+	{
+		next = std::make_shared<Matrix2D<T>>(mat);
+	}
+
+	auto previous = std::atomic_exchange(&cache.snapshot_, std::shared_ptr<const Matrix2D<T>>(std::move(next)));
+	spare = std::const_pointer_cast<Matrix2D<T>>(std::move(previous));
+	cache.spareFirst_ = first;
+	cache.spareLast_ = last;
+}
+
+template<typename T>
+std::shared_ptr<typename Matrix2DAdapter<T>::Cache> Matrix2DAdapter<T>::FindCache(const bool create) const
+{
+	auto cache = std::atomic_load(&cache_);
+	if (cache || (!create && ActiveCaches().load() == 0)) {
+		return cache;
+	}
+
+	if (!matPtr_)
+	{
+		if (!create) {
+			return nullptr;
+		}
+		cache = std::make_shared<Cache>();
+	}
+	else
+	{
+		// The cache lives while adapters which found it exist and they keep the matrix alive,
+		// so an expired entry belongs to a destroyed matrix and may be reused by a new matrix
+		// at the same address. Other expired entries are removed when the registry doubles
+		// since the previous removal, so the cost of the removal is spread over insertions.
+		static std::mutex mutex;
+		static std::map<const Matrix2D<T>*, std::weak_ptr<Cache>> caches;
+		static size_t sweepSize = 16;
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = caches.find(matPtr_.get());
+		if (it != caches.end()) {
+			cache = it->second.lock();
+		}
+		if (!cache)
+		{
+			if (!create) {
+				return nullptr;
+			}
+			cache = std::make_shared<Cache>();
+			if (it != caches.end()) {
+				it->second = cache;
+			}
+			else
+			{
+				caches.emplace(matPtr_.get(), cache);
+				if (caches.size() >= sweepSize)
+				{
+					for (auto entry = caches.begin(); entry != caches.end();) {
+						entry = entry->second.expired() ? caches.erase(entry) : std::next(entry);
+					}
+					sweepSize = std::max<size_t>(16, 2 * caches.size());
+				}
+			}
+		}
+	}
+
+	std::atomic_store(&cache_, cache);
+	return cache;
+}
+
+template<typename T>
+std::shared_ptr<typename Matrix2DAdapter<T>::Cache> Matrix2DAdapter<T>::GetActiveCache() const
+{
+	if (ActiveCaches().load() == 0) {
+		return nullptr;
+	}
+
+	auto cache = FindCache(false);
+	return cache && cache->modes_.load() != 0 ? cache : nullptr;
+}
+
+template<typename T>
+std::shared_ptr<typename Matrix2DAdapter<T>::Cache> Matrix2DAdapter<T>::GetPartialsCache() const
+{
+	// Cached partials aren't used while readers are concurrent.
+	auto cache = GetActiveCache();
+	return cache && cache->modes_.load() == CachedPartials ? cache : nullptr;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::SetMode(Cache& cache, const Mode mode, const bool enabled)
+{
+	const unsigned previous = enabled ? cache.modes_.fetch_or(mode) : cache.modes_.fetch_and(~static_cast<unsigned>(mode));
+	const unsigned current = enabled ? previous | mode : previous & ~static_cast<unsigned>(mode);
+	if (previous == 0 && current != 0) {
+		++ActiveCaches();
+	}
+	else if (previous != 0 && current == 0) {
+		--ActiveCaches();
+	}
+}
+
+template<typename T>
+std::atomic<size_t>& Matrix2DAdapter<T>::ActiveCaches() noexcept
+{
+	static std::atomic<size_t> active{ 0 };
+	return active;
+}
+
+template<typename T>
+Matrix2DView<const T> Matrix2DAdapter<T>::PrepareCache(Cache& cache) const
+{
+	const Matrix2DView<const T> view = matPtr_->GetView();
+	if (!cache.valid_
+		|| cache.data_ != view.Data()
+		|| cache.rows_ != view.GetRows()
+		|| cache.columns_ != view.GetColumns())
+	{
+		cache.valid_ = true;
+		cache.data_ = view.Data();
+		cache.rows_ = view.GetRows();
+		cache.columns_ = view.GetColumns();
+		cache.blockRows_ = std::max<size_t>(detail::RowsPerBlock(view.GetColumns()), 1);
+		const size_t blocks = (view.GetRows() + cache.blockRows_ - 1) / cache.blockRows_;
+		cache.identicalSets_.Reset(view.GetRows());
+		cache.products_.Reset(blocks);
+		cache.diagonalSums_.Reset(blocks);
+	}
+
+	return view;
+}
+
+template<typename T>
+size_t Matrix2DAdapter<T>::RingsNumber(const Matrix2DView<T>& view) noexcept
+{
+	return std::min(view.GetRows(), view.GetColumns()) / 2;
+}
+
+template<typename T>
+void Matrix2DAdapter<T>::RotateRing(const Matrix2DView<T>& view, const size_t n, const size_t step)
+{
+	const auto ring = view.Block(n, n, view.GetRows() - 2 * n, view.GetColumns() - 2 * n);
+	const size_t length = detail::RingIterator<T>::GetLength(ring);
+	const size_t shift = step % length;
+	if (shift == 0) {
+		return;
+	}
+
+	// Rotation of the ring iterators moves every element once and needs no buffer.
+	const detail::RingIterator<T> begin(ring, 0);
+	const auto end = begin + static_cast<std::ptrdiff_t>(length);
+	std::rotate(begin, end - static_cast<std::ptrdiff_t>(shift), end);
 }
 
 }	// namespace mtx
\ No newline at end of file
@@ -0,0 +1,500 @@
+#pragma once
+
+#include "matrix/MatrixView.h"
+#include "matrix/Simd.h"
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mtx
+{
+
+//! Base class of lazily evaluated element-wise expressions over matrices.
+//! Expression doesn't own any storage, it keeps views of the operands and computes
+//! element (r, c) on request. Whole expression is evaluated in a single loop
+//! when it is assigned to a Matrix2D or passed to EvaluateInto, so chains like
+//! a + b - c don't create temporary matrices.
+//! Operands must outlive the expression, so don't keep expressions built from temporaries.
+template<typename E>
+class MatrixExpression
+{
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of rows.
+	size_t GetRows() const;
+	//! Returns number of columns.
+	size_t GetColumns() const;
+	//! Computes the element (row, column) of the expression.
+	decltype(auto) operator()(const size_t row, const size_t column) const;
+	//! Returns reference to the derived expression.
+	const E& Self() const noexcept;
+};
+
+//! Leaf of the expression, reads elements of a matrix or a view.
+template<typename T>
+class ViewExpression
+	: public MatrixExpression<ViewExpression<T>>
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using ValueType = std::remove_cv_t<T>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	explicit ViewExpression(const Matrix2DView<const T>& view) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	size_t GetRows() const noexcept;
+	size_t GetColumns() const noexcept;
+	const T& operator()(const size_t row, const size_t column) const noexcept;
+	//! Returns view of the operand.
+	const Matrix2DView<const T>& GetView() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! View of the operand.
+	Matrix2DView<const T> view_;
+};
+
+//! Expression which applies func to every element of the operand.
+template<typename Operand, typename UnaryOp>
+class UnaryExpression
+	: public MatrixExpression<UnaryExpression<Operand, UnaryOp>>
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using ValueType = std::decay_t<decltype(
+		std::declval<const UnaryOp&>()(std::declval<typename Operand::ValueType>()))>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	UnaryExpression(Operand operand, UnaryOp func);
+
+	//
+	// Public interface.
+	//
+public:
+	size_t GetRows() const noexcept;
+	size_t GetColumns() const noexcept;
+	ValueType operator()(const size_t row, const size_t column) const;
+
+	//
+	// Private data members.
+	//
+private:
+	Operand operand_;
+	UnaryOp func_;
+};
+
+//! Expression which combines elements of two operands of the same size with func.
+template<typename Left, typename Right, typename BinaryOp>
+class BinaryExpression
+	: public MatrixExpression<BinaryExpression<Left, Right, BinaryOp>>
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using ValueType = std::decay_t<decltype(std::declval<const BinaryOp&>()(
+		std::declval<typename Left::ValueType>(),
+		std::declval<typename Right::ValueType>()))>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, throws std::length_error if sizes of operands don't match.
+	BinaryExpression(Left left, Right right, BinaryOp func);
+
+	//
+	// Public interface.
+	//
+public:
+	size_t GetRows() const noexcept;
+	size_t GetColumns() const noexcept;
+	ValueType operator()(const size_t row, const size_t column) const;
+	//! Returns operands and operation of the expression.
+	const Left& GetLeft() const noexcept;
+	const Right& GetRight() const noexcept;
+	const BinaryOp& GetOperation() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	Left left_;
+	Right right_;
+	BinaryOp func_;
+};
+
+template<typename E>
+size_t MatrixExpression<E>::GetRows() const
+{
+	return Self().GetRows();
+}
+
+template<typename E>
+size_t MatrixExpression<E>::GetColumns() const
+{
+	return Self().GetColumns();
+}
+
+template<typename E>
+decltype(auto) MatrixExpression<E>::operator()(const size_t row, const size_t column) const
+{
+	return Self()(row, column);
+}
+
+template<typename E>
+const E& MatrixExpression<E>::Self() const noexcept
+{
+	return static_cast<const E&>(*this);
+}
+
+template<typename T>
+ViewExpression<T>::ViewExpression(const Matrix2DView<const T>& view) noexcept
+	: view_{ view }
+{
+}
+
+template<typename T>
+size_t ViewExpression<T>::GetRows() const noexcept
+{
+	return view_.GetRows();
+}
+
+template<typename T>
+size_t ViewExpression<T>::GetColumns() const noexcept
+{
+	return view_.GetColumns();
+}
+
+template<typename T>
+const T& ViewExpression<T>::operator()(const size_t row, const size_t column) const noexcept
+{
+	return view_(row, column);
+}
+
+template<typename T>
+const Matrix2DView<const T>& ViewExpression<T>::GetView() const noexcept
+{
+	return view_;
+}
+
+template<typename Operand, typename UnaryOp>
+UnaryExpression<Operand, UnaryOp>::UnaryExpression(Operand operand, UnaryOp func)
+	: operand_{ std::move(operand) }
+	, func_{ std::move(func) }
+{
+}
+
+template<typename Operand, typename UnaryOp>
+size_t UnaryExpression<Operand, UnaryOp>::GetRows() const noexcept
+{
+	return operand_.GetRows();
+}
+
+template<typename Operand, typename UnaryOp>
+size_t UnaryExpression<Operand, UnaryOp>::GetColumns() const noexcept
+{
+	return operand_.GetColumns();
+}
+
+template<typename Operand, typename UnaryOp>
+typename UnaryExpression<Operand, UnaryOp>::ValueType
+UnaryExpression<Operand, UnaryOp>::operator()(const size_t row, const size_t column) const
+{
+	return func_(operand_(row, column));
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+BinaryExpression<Left, Right, BinaryOp>::BinaryExpression(Left left, Right right, BinaryOp func)
+	: left_{ std::move(left) }
+	, right_{ std::move(right) }
+	, func_{ std::move(func) }
+{
+	if (left_.GetRows() != right_.GetRows() || left_.GetColumns() != right_.GetColumns()) {
+		throw std::length_error("MatrixExpression: sizes of matrices don't match.");
+	}
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+size_t BinaryExpression<Left, Right, BinaryOp>::GetRows() const noexcept
+{
+	return left_.GetRows();
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+size_t BinaryExpression<Left, Right, BinaryOp>::GetColumns() const noexcept
+{
+	return left_.GetColumns();
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+typename BinaryExpression<Left, Right, BinaryOp>::ValueType
+BinaryExpression<Left, Right, BinaryOp>::operator()(const size_t row, const size_t column) const
+{
+	return func_(left_(row, column), right_(row, column));
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+const Left& BinaryExpression<Left, Right, BinaryOp>::GetLeft() const noexcept
+{
+	return left_;
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+const Right& BinaryExpression<Left, Right, BinaryOp>::GetRight() const noexcept
+{
+	return right_;
+}
+
+template<typename Left, typename Right, typename BinaryOp>
+const BinaryOp& BinaryExpression<Left, Right, BinaryOp>::GetOperation() const noexcept
+{
+	return func_;
+}
+
+namespace detail
+{
+
+//! Evaluates the row of the expression into contiguous storage.
+template<typename E, typename T>
+void EvaluateRow(const E& expr, const size_t row, T* result, const size_t columns)
+{
+	for (size_t c = 0; c < columns; ++c) {
+		result[c] = static_cast<T>(expr(row, c));
+	}
+}
+
+//! Sum or difference of two matrices with contiguous rows uses vector kernels.
+template<typename T, typename BinaryOp>
+void EvaluateRow(
+	const BinaryExpression<ViewExpression<T>, ViewExpression<T>, BinaryOp>& expr,
+	const size_t row,
+	T* result,
+	const size_t columns)
+{
+	const auto& left = expr.GetLeft().GetView();
+	const auto& right = expr.GetRight().GetView();
+	if (left.HasContiguousRows() && right.HasContiguousRows()) {
+		TransformRange(&left(row, 0), &right(row, 0), result, columns, expr.GetOperation());
+	}
+	else
+	{
+		for (size_t c = 0; c < columns; ++c) {
+			result[c] = static_cast<T>(expr(row, c));
+		}
+	}
+}
+
+//! Describes how an object takes part in expressions. Specializations provide
+//! Type of the expression node and Make function which creates it.
+//! Objects without specialization aren't matrix operands.
+template<typename X, typename = void>
+struct ExpressionOperand
+{
+};
+
+template<typename T>
+struct ExpressionOperand<Matrix2DView<T>>
+{
+	using Type = ViewExpression<std::remove_cv_t<T>>;
+	static Type Make(const Matrix2DView<T>& view) noexcept { return Type(view); }
+};
+
+template<typename E>
+struct ExpressionOperand<E, std::enable_if_t<std::is_base_of<MatrixExpression<E>, E>::value>>
+{
+	using Type = E;
+	static const E& Make(const E& expr) noexcept { return expr; }
+};
+
+template<typename X>
+using OperandType = typename ExpressionOperand<std::decay_t<X>>::Type;
+
+template<typename...>
+struct MakeVoid
+{
+	using Type = void;
+};
+
+//! Checks whether X may be used as an operand of matrix expressions.
+template<typename X, typename = void>
+struct IsExpressionOperand
+	: std::false_type
+{
+};
+
+template<typename X>
+struct IsExpressionOperand<X, typename MakeVoid<OperandType<X>>::Type>
+	: std::true_type
+{
+};
+
+//! Creates expression node for the operand.
+template<typename X>
+OperandType<X> MakeOperand(const X& operand)
+{
+	return ExpressionOperand<std::decay_t<X>>::Make(operand);
+}
+
+//! Applies Op with fixed right argument: func(x) = Op()(x, scalar).
+template<typename Op, typename S>
+struct BindScalarRight
+{
+	template<typename X>
+	auto operator()(const X& x) const { return Op()(x, scalar_); }
+
+	S scalar_;
+};
+
+//! Applies Op with fixed left argument: func(x) = Op()(scalar, x).
+template<typename Op, typename S>
+struct BindScalarLeft
+{
+	template<typename X>
+	auto operator()(const X& x) const { return Op()(scalar_, x); }
+
+	S scalar_;
+};
+
+//! Enables operators on matrix operands, scalars are arithmetic values.
+template<typename L, typename R>
+using EnableIfMatrices =
+	std::enable_if_t<IsExpressionOperand<L>::value && IsExpressionOperand<R>::value>;
+
+template<typename M, typename S>
+using EnableIfMatrixAndScalar =
+	std::enable_if_t<IsExpressionOperand<M>::value && std::is_arithmetic<S>::value>;
+
+}	// namespace detail
+
+//! Returns lazy expression applying func to every element of the operand.
+template<typename Operand, typename UnaryOp, typename = std::enable_if_t<detail::IsExpressionOperand<Operand>::value>>
+UnaryExpression<detail::OperandType<Operand>, UnaryOp> Map(const Operand& operand, UnaryOp func)
+{
+	return { detail::MakeOperand(operand), std::move(func) };
+}
+
+//! Returns lazy expression where element (r, c) is func(left(r, c), right(r, c)),
+//! it is a lazy counterpart of TransformMatrices.
+template<typename L, typename R, typename BinaryOp, typename = detail::EnableIfMatrices<L, R>>
+BinaryExpression<detail::OperandType<L>, detail::OperandType<R>, BinaryOp>
+Zip(const L& left, const R& right, BinaryOp func)
+{
+	return { detail::MakeOperand(left), detail::MakeOperand(right), std::move(func) };
+}
+
+//! Returns lazy sum of two matrices.
+template<typename L, typename R, typename = detail::EnableIfMatrices<L, R>>
+auto operator+(const L& left, const R& right)
+{
+	return Zip(left, right, std::plus<>());
+}
+
+//! Returns lazy difference of two matrices.
+template<typename L, typename R, typename = detail::EnableIfMatrices<L, R>>
+auto operator-(const L& left, const R& right)
+{
+	return Zip(left, right, std::minus<>());
+}
+
+//! Returns lazy negation of the matrix.
+template<typename M, typename = std::enable_if_t<detail::IsExpressionOperand<M>::value>>
+auto operator-(const M& mat)
+{
+	return Map(mat, std::negate<>());
+}
+
+//! Operators with scalars, they are applied to every element of the matrix.
+template<typename M, typename S, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator+(const M& mat, const S scalar)
+{
+	return Map(mat, detail::BindScalarRight<std::plus<>, S>{ scalar });
+}
+
+template<typename S, typename M, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator+(const S scalar, const M& mat)
+{
+	return Map(mat, detail::BindScalarLeft<std::plus<>, S>{ scalar });
+}
+
+template<typename M, typename S, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator-(const M& mat, const S scalar)
+{
+	return Map(mat, detail::BindScalarRight<std::minus<>, S>{ scalar });
+}
+
+template<typename S, typename M, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator-(const S scalar, const M& mat)
+{
+	return Map(mat, detail::BindScalarLeft<std::minus<>, S>{ scalar });
+}
+
+template<typename M, typename S, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator*(const M& mat, const S scalar)
+{
+	return Map(mat, detail::BindScalarRight<std::multiplies<>, S>{ scalar });
+}
+
+template<typename S, typename M, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator*(const S scalar, const M& mat)
+{
+	return Map(mat, detail::BindScalarLeft<std::multiplies<>, S>{ scalar });
+}
+
+template<typename M, typename S, typename = detail::EnableIfMatrixAndScalar<M, S>>
+auto operator/(const M& mat, const S scalar)
+{
+	return Map(mat, detail::BindScalarRight<std::divides<>, S>{ scalar });
+}
+
+//! Evaluates the expression into the existing storage viewed by result in a single pass,
+//! doesn't allocate. Throws std::length_error if sizes don't match.
+//! Result may be one of the operands, every element depends only on elements at the same position.
+template<typename E, typename T>
+void EvaluateInto(const MatrixExpression<E>& expr, const Matrix2DView<T>& result)
+{
+	if (expr.GetRows() != result.GetRows() || expr.GetColumns() != result.GetColumns()) {
+		throw std::length_error("EvaluateInto: sizes of matrices don't match.");
+	}
+
+	const E& self = expr.Self();
+	const size_t rows = result.GetRows();
+	const size_t columns = result.GetColumns();
+	for (size_t r = 0; r < rows && columns > 0; ++r)
+	{
+		if (result.HasContiguousRows()) {
+			detail::EvaluateRow(self, r, &result(r, 0), columns);
+		}
+		else
+		{
+			for (size_t c = 0; c < columns; ++c) {
+				result(r, c) = static_cast<T>(self(r, c));
+			}
+		}
+	}
+}
+
+}	// namespace mtx
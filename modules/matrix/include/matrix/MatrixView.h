@@ -0,0 +1,400 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mtx
+{
+
+//! Random access iterator over elements placed in memory with a constant stride.
+template<typename T>
+class StridedIterator
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	StridedIterator() = default;
+	//! Constructor.
+	StridedIterator(T* ptr, const std::ptrdiff_t stride) noexcept
+		: ptr_{ ptr }
+		, stride_{ stride }
+	{
+	}
+	//! Converting constructor, allows to get const iterator from non-const one.
+	template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	StridedIterator(const StridedIterator<U>& other) noexcept
+		: ptr_{ other.Get() }
+		, stride_{ other.GetStride() }
+	{
+	}
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns pointer to the current element.
+	T* Get() const noexcept { return ptr_; }
+	//! Returns distance in elements between two neighboring positions.
+	std::ptrdiff_t GetStride() const noexcept { return stride_; }
+
+	reference operator*() const noexcept { return *ptr_; }
+	pointer operator->() const noexcept { return ptr_; }
+	reference operator[](const difference_type n) const noexcept { return ptr_[n * stride_]; }
+
+	StridedIterator& operator++() noexcept { ptr_ += stride_; return *this; }
+	StridedIterator operator++(int) noexcept { auto tmp = *this; ptr_ += stride_; return tmp; }
+	StridedIterator& operator--() noexcept { ptr_ -= stride_; return *this; }
+	StridedIterator operator--(int) noexcept { auto tmp = *this; ptr_ -= stride_; return tmp; }
+	StridedIterator& operator+=(const difference_type n) noexcept { ptr_ += n * stride_; return *this; }
+	StridedIterator& operator-=(const difference_type n) noexcept { ptr_ -= n * stride_; return *this; }
+
+	friend StridedIterator operator+(StridedIterator it, const difference_type n) noexcept { return it += n; }
+	friend StridedIterator operator+(const difference_type n, StridedIterator it) noexcept { return it += n; }
+	friend StridedIterator operator-(StridedIterator it, const difference_type n) noexcept { return it -= n; }
+	friend difference_type operator-(const StridedIterator& left, const StridedIterator& right) noexcept
+	{
+		return (left.ptr_ - right.ptr_) / left.stride_;
+	}
+
+	friend bool operator==(const StridedIterator& l, const StridedIterator& r) noexcept { return l.ptr_ == r.ptr_; }
+	friend bool operator!=(const StridedIterator& l, const StridedIterator& r) noexcept { return l.ptr_ != r.ptr_; }
+	friend bool operator<(const StridedIterator& l, const StridedIterator& r) noexcept { return (r - l) > 0; }
+	friend bool operator>(const StridedIterator& l, const StridedIterator& r) noexcept { return r < l; }
+	friend bool operator<=(const StridedIterator& l, const StridedIterator& r) noexcept { return !(r < l); }
+	friend bool operator>=(const StridedIterator& l, const StridedIterator& r) noexcept { return !(l < r); }
+
+	//
+	// Private data members.
+	//
+private:
+	//! Pointer to the current element.
+	T* ptr_ = { nullptr };
+	//! Distance in elements between two neighboring positions.
+	std::ptrdiff_t stride_ = { 1 };
+};
+
+//! Non-owning one dimensional view of the matrix elements, e.g. row or column.
+//! View never allocates and stays valid while the viewed storage is alive and not resized.
+//! Use VectorView<const T> for read-only access.
+template<typename T>
+class VectorView
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using Iterator = StridedIterator<T>;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	VectorView() = default;
+	//! Constructor.
+	VectorView(T* data, const size_t size, const std::ptrdiff_t stride = 1) noexcept;
+	//! Converting constructor, allows to get const view from non-const one.
+	template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	VectorView(const VectorView<U>& other) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns pointer to the first element.
+	T* Data() const noexcept;
+	//! Returns number of elements.
+	size_t GetSize() const noexcept;
+	//! Returns distance in elements between two neighboring elements.
+	std::ptrdiff_t GetStride() const noexcept;
+	//! Returns true if elements are placed next to each other in memory.
+	bool IsContiguous() const noexcept;
+	//! Provides access to the elements.
+	T& operator[](const size_t n) const noexcept;
+	//! Returns an iterator pointing to the first element.
+	Iterator Begin() const noexcept;
+	//! Returns an iterator pointing to the past-the-end element.
+	Iterator End() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Pointer to the first element.
+	T* data_ = { nullptr };
+	//! Number of elements.
+	size_t size_ = { 0 };
+	//! Distance in elements between two neighboring elements.
+	std::ptrdiff_t stride_ = { 1 };
+};
+
+//! Non-owning two dimensional view of the matrix elements with arbitrary strides,
+//! element (r, c) is located at data[r * rowStride + c * columnStride].
+//! View never allocates and stays valid while the viewed storage is alive and not resized.
+//! Use Matrix2DView<const T> for read-only access.
+template<typename T>
+class Matrix2DView
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	Matrix2DView() = default;
+	//! Constructor.
+	Matrix2DView(
+		T* data,
+		const size_t rows,
+		const size_t columns,
+		const std::ptrdiff_t rowStride,
+		const std::ptrdiff_t columnStride = 1) noexcept;
+	//! Converting constructor, allows to get const view from non-const one.
+	template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	Matrix2DView(const Matrix2DView<U>& other) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns pointer to the element (0, 0).
+	T* Data() const noexcept;
+	//! Returns number of rows.
+	size_t GetRows() const noexcept;
+	//! Returns number of columns.
+	size_t GetColumns() const noexcept;
+	//! Returns distance in elements between two neighboring rows.
+	std::ptrdiff_t GetRowStride() const noexcept;
+	//! Returns distance in elements between two neighboring columns.
+	std::ptrdiff_t GetColumnStride() const noexcept;
+	//! Returns true if elements of every row are placed next to each other in memory.
+	bool HasContiguousRows() const noexcept;
+	//! Returns true if elements of every column are placed next to each other in memory.
+	bool HasContiguousColumns() const noexcept;
+	//! Provides access to the elements.
+	T& operator()(const size_t row, const size_t column) const noexcept;
+	//! Returns view of the row n.
+	VectorView<T> Row(const size_t n) const;
+	//! Returns view of the column n.
+	VectorView<T> Column(const size_t n) const;
+	//! Returns view of the rectangular part of the matrix which starts at (row, column)
+	//! and has specified number of rows and columns.
+	Matrix2DView Block(
+		const size_t row,
+		const size_t column,
+		const size_t rows,
+		const size_t columns) const;
+	//! Returns view of the transposed matrix, element (r, c) of it is element (c, r) of this view.
+	//! Nothing is moved, only sizes and strides are swapped.
+	Matrix2DView Transposed() const noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Pointer to the element (0, 0).
+	T* data_ = { nullptr };
+	//! Number of rows in the view.
+	size_t rows_ = { 0 };
+	//! Number of columns in the view.
+	size_t columns_ = { 0 };
+	//! Distance in elements between two neighboring rows.
+	std::ptrdiff_t rowStride_ = { 0 };
+	//! Distance in elements between two neighboring columns.
+	std::ptrdiff_t columnStride_ = { 1 };
+};
+
+template<typename T>
+VectorView<T>::VectorView(T* data, const size_t size, const std::ptrdiff_t stride) noexcept
+	: data_{ data }
+	, size_{ size }
+	, stride_{ stride }
+{
+}
+
+template<typename T>
+template<typename U, typename>
+VectorView<T>::VectorView(const VectorView<U>& other) noexcept
+	: data_{ other.Data() }
+	, size_{ other.GetSize() }
+	, stride_{ other.GetStride() }
+{
+}
+
+template<typename T>
+T* VectorView<T>::Data() const noexcept
+{
+	return data_;
+}
+
+template<typename T>
+size_t VectorView<T>::GetSize() const noexcept
+{
+	return size_;
+}
+
+template<typename T>
+std::ptrdiff_t VectorView<T>::GetStride() const noexcept
+{
+	return stride_;
+}
+
+template<typename T>
+bool VectorView<T>::IsContiguous() const noexcept
+{
+	return stride_ == 1 || size_ < 2;
+}
+
+template<typename T>
+T& VectorView<T>::operator[](const size_t n) const noexcept
+{
+	return data_[static_cast<std::ptrdiff_t>(n) * stride_];
+}
+
+template<typename T>
+typename VectorView<T>::Iterator VectorView<T>::Begin() const noexcept
+{
+	return Iterator(data_, stride_);
+}
+
+template<typename T>
+typename VectorView<T>::Iterator VectorView<T>::End() const noexcept
+{
+	return Iterator(data_ + static_cast<std::ptrdiff_t>(size_) * stride_, stride_);
+}
+
+template<typename T>
+Matrix2DView<T>::Matrix2DView(
+	T* data,
+	const size_t rows,
+	const size_t columns,
+	const std::ptrdiff_t rowStride,
+	const std::ptrdiff_t columnStride) noexcept
+	: data_{ data }
+	, rows_{ rows }
+	, columns_{ columns }
+	, rowStride_{ rowStride }
+	, columnStride_{ columnStride }
+{
+}
+
+template<typename T>
+template<typename U, typename>
+Matrix2DView<T>::Matrix2DView(const Matrix2DView<U>& other) noexcept
+	: data_{ other.Data() }
+	, rows_{ other.GetRows() }
+	, columns_{ other.GetColumns() }
+	, rowStride_{ other.GetRowStride() }
+	, columnStride_{ other.GetColumnStride() }
+{
+}
+
+template<typename T>
+T* Matrix2DView<T>::Data() const noexcept
+{
+	return data_;
+}
+
+template<typename T>
+size_t Matrix2DView<T>::GetRows() const noexcept
+{
+	return rows_;
+}
+
+template<typename T>
+size_t Matrix2DView<T>::GetColumns() const noexcept
+{
+	return columns_;
+}
+
+template<typename T>
+std::ptrdiff_t Matrix2DView<T>::GetRowStride() const noexcept
+{
+	return rowStride_;
+}
+
+template<typename T>
+std::ptrdiff_t Matrix2DView<T>::GetColumnStride() const noexcept
+{
+	return columnStride_;
+}
+
+template<typename T>
+bool Matrix2DView<T>::HasContiguousRows() const noexcept
+{
+	return columnStride_ == 1 || columns_ < 2;
+}
+
+template<typename T>
+bool Matrix2DView<T>::HasContiguousColumns() const noexcept
+{
+	return rowStride_ == 1 || rows_ < 2;
+}
+
+template<typename T>
+T& Matrix2DView<T>::operator()(const size_t row, const size_t column) const noexcept
+{
+	return data_[static_cast<std::ptrdiff_t>(row) * rowStride_
+		+ static_cast<std::ptrdiff_t>(column) * columnStride_];
+}
+
+template<typename T>
+VectorView<T> Matrix2DView<T>::Row(const size_t n) const
+{
+	if (n >= rows_) {
+		throw std::out_of_range("Matrix2DView::Row: argument is out of range.");
+	}
+
+	return VectorView<T>(&(*this)(n, 0), columns_, columnStride_);
+}
+
+template<typename T>
+VectorView<T> Matrix2DView<T>::Column(const size_t n) const
+{
+	if (n >= columns_) {
+		throw std::out_of_range("Matrix2DView::Column: argument is out of range.");
+	}
+
+	return VectorView<T>(&(*this)(0, n), rows_, rowStride_);
+}
+
+template<typename T>
+Matrix2DView<T> Matrix2DView<T>::Block(
+	const size_t row,
+	const size_t column,
+	const size_t rows,
+	const size_t columns) const
+{
+	bool outOfRange =
+		row > rows_
+		|| column > columns_
+		|| rows > rows_ - row
+		|| columns > columns_ - column;
+
+	if (outOfRange) {
+		throw std::out_of_range("Matrix2DView::Block: arguments are out of range.");
+	}
+
+	return Matrix2DView(&(*this)(row, column), rows, columns, rowStride_, columnStride_);
+}
+
+template<typename T>
+Matrix2DView<T> Matrix2DView<T>::Transposed() const noexcept
+{
+	return Matrix2DView(data_, columns_, rows_, columnStride_, rowStride_);
+}
+
+}	// namespace mtx
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "matrix/Scheduler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mtx
+{
+namespace execution
+{
+
+//! Policy which runs the algorithm on the calling thread.
+struct SequencedPolicy
+{
+};
+
+//! Policy which splits work of the algorithm by blocks of rows between threads.
+//! Work runs on the scheduler if it is set, on the default scheduler if number of
+//! threads is 0, otherwise on the specified number of dedicated threads.
+struct ParallelPolicy
+{
+	//! Returns the same policy which runs on the scheduler.
+	ParallelPolicy On(WorkStealingScheduler& scheduler) const noexcept
+	{
+		return ParallelPolicy{ threads_, &scheduler };
+	}
+
+	//! Number of dedicated threads, 0 means the scheduler is used.
+	size_t threads_ = { 0 };
+	//! Scheduler which runs the work, nullptr means the default one.
+	WorkStealingScheduler* scheduler_ = { nullptr };
+};
+
+//! Requests sequential execution.
+constexpr SequencedPolicy seq{};
+//! Requests parallel execution on the default scheduler.
+constexpr ParallelPolicy par{};
+
+}	// namespace execution
+
+namespace detail
+{
+
+//! Returns number of threads used by parallel algorithms of the library.
+inline size_t GetThreadsNumber() noexcept
+{
+	const size_t threads = std::thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+}
+
+//! Splits range [begin, end) into contiguous chunks of at least grain elements
+//! and calls func(chunkBegin, chunkEnd) for every chunk, chunks are processed in parallel
+//! by at most threads dedicated threads started for the call. Calling thread processes the first chunk itself.
+//! The first exception thrown by func is rethrown after all chunks are finished.
+template<typename Func>
+void ParallelFor(const size_t threads, const size_t begin, const size_t end, const size_t grain, Func func)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	const size_t length = end - begin;
+	const size_t maxChunks = (length + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1);
+	const size_t chunks = std::min(std::max<size_t>(threads, 1), maxChunks);
+	if (chunks <= 1)
+	{
+		func(begin, end);
+		return;
+	}
+
+	const size_t chunkLength = length / chunks;
+	const size_t remainder = length % chunks;
+	// Bounds of the chunk i, first chunks take one more element if length isn't divisible.
+	const auto chunkBegin = [=] (const size_t i)
+	{
+		return begin + i * chunkLength + std::min(i, remainder);
+	};
+
+	std::vector<std::exception_ptr> errors(chunks);
+	std::vector<std::thread> workers;
+	workers.reserve(chunks - 1);
+	for (size_t i = 1; i < chunks; ++i)
+	{
+		workers.emplace_back([&, i] ()
+		{
+			try {
+				func(chunkBegin(i), chunkBegin(i + 1));
+			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+		});
+	}
+
+	try {
+		func(chunkBegin(0), chunkBegin(1));
+	}
+	catch (...) {
+		errors[0] = std::current_exception();
+	}
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (const auto& error : errors)
+	{
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+//! Same as above, work is split between workers of the default scheduler,
+//! so nested calls don't start new threads.
+template<typename Func>
+void ParallelFor(const size_t begin, const size_t end, const size_t grain, Func func)
+{
+	WorkStealingScheduler::GetDefault().ParallelFor(begin, end, grain, std::move(func));
+}
+
+//! Checks if P is an execution policy.
+template<typename P>
+struct IsExecutionPolicy
+	: std::integral_constant<bool,
+		std::is_same<std::decay_t<P>, execution::SequencedPolicy>::value
+		|| std::is_same<std::decay_t<P>, execution::ParallelPolicy>::value>
+{
+};
+
+//! Removes overload from the set if P isn't an execution policy.
+template<typename P, typename R = void>
+using EnableIfPolicy = std::enable_if_t<IsExecutionPolicy<P>::value, R>;
+
+//! Calls func(begin, end) on the calling thread.
+template<typename Func>
+void ParallelFor(
+	const execution::SequencedPolicy&,
+	const size_t begin,
+	const size_t end,
+	const size_t,
+	Func func)
+{
+	if (begin < end) {
+		func(begin, end);
+	}
+}
+
+//! Splits range between threads allowed by the policy, see ParallelPolicy.
+template<typename Func>
+void ParallelFor(
+	const execution::ParallelPolicy& policy,
+	const size_t begin,
+	const size_t end,
+	const size_t grain,
+	Func func)
+{
+	if (policy.scheduler_ != nullptr) {
+		policy.scheduler_->ParallelFor(begin, end, grain, std::move(func));
+	}
+	else if (policy.threads_ == 0) {
+		ParallelFor(begin, end, grain, std::move(func));
+	}
+	else {
+		ParallelFor(policy.threads_, begin, end, grain, std::move(func));
+	}
+}
+
+//! Splits range [begin, end) into blocks of exactly blockLength elements (the last one
+//! may be shorter), calculates mapBlock(blockBegin, blockEnd) for blocks according to
+//! the policy and folds block results with combine(accumulated, blockResult) in order
+//! of blocks starting with init. Blocks don't depend on the number of threads, so result
+//! is the same for every policy even for non-associative operations like floating point sums.
+template<typename Policy, typename R, typename MapBlock, typename Combine>
+R ParallelReduce(
+	const Policy& policy,
+	const size_t begin,
+	const size_t end,
+	const size_t blockLength,
+	R init,
+	MapBlock mapBlock,
+	Combine combine)
+{
+	if (begin >= end) {
+		return init;
+	}
+
+	// Results are wrapped, so neighboring results never share a word like in vector<bool>.
+	struct BlockResult
+	{
+		R value_;
+	};
+
+	const size_t length = std::max<size_t>(blockLength, 1);
+	const size_t blocks = (end - begin + length - 1) / length;
+	std::vector<BlockResult> results(blocks, BlockResult{ init });
+	ParallelFor(policy, 0, blocks, 1, [&] (const size_t first, const size_t last)
+	{
+		for (size_t block = first; block < last; ++block)
+		{
+			const size_t blockBegin = begin + block * length;
+			results[block].value_ = mapBlock(blockBegin, std::min(blockBegin + length, end));
+		}
+	});
+
+	for (const auto& result : results) {
+		init = combine(init, result.value_);
+	}
+
+	return init;
+}
+
+//! Returns number of rows in blocks processed by a single task, it depends only
+//! on the number of columns, so reductions are reproducible on different machines.
+inline size_t RowsPerBlock(const size_t columns) noexcept
+{
+	constexpr size_t elementsPerBlock = 1 << 14;
+	return std::max<size_t>(1, elementsPerBlock / std::max<size_t>(columns, 1));
+}
+
+}	// namespace detail
+}	// namespace mtx
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace mtx
+{
+
+//! Counter-based random number generator: value number n of the stream is a hash of the key
+//! and n (the SplitMix64 finalizer), so any part of the sequence is computed directly without
+//! generating the values before it. Blocks of a matrix are filled by different threads
+//! with the same values as by a single thread.
+//! Satisfies requirements of UniformRandomBitGenerator, so it works with distributions of <random>.
+class CounterRng
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using result_type = std::uint64_t;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, generators with different seeds or streams produce independent sequences.
+	explicit CounterRng(const std::uint64_t seed = 0, const std::uint64_t stream = 0) noexcept;
+
+	//
+	// Public interface.
+	//
+public:
+	static constexpr result_type min() noexcept;
+	static constexpr result_type max() noexcept;
+	//! Returns the next value of the sequence.
+	result_type operator()() noexcept;
+	//! Returns value number n of the sequence, it doesn't change the generator.
+	result_type Generate(const std::uint64_t n) const noexcept;
+	//! Writes count values of the sequence starting at value number first, the loop
+	//! has no dependencies between iterations, so the compiler vectorizes it.
+	void Generate(const std::uint64_t first, const size_t count, result_type* output) const noexcept;
+	//! Skips n values of the sequence.
+	void Discard(const std::uint64_t n) noexcept;
+	//! Makes value number n the next value of the sequence.
+	void Seek(const std::uint64_t n) noexcept;
+	//! Returns number of the next value of the sequence.
+	std::uint64_t GetCounter() const noexcept;
+
+	//
+	// Private methods.
+	//
+private:
+	//! Finalizer of SplitMix64, a bijection with good avalanche properties.
+	static constexpr std::uint64_t Mix(std::uint64_t x) noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Odd constant of SplitMix64, distance between consecutive counters before mixing.
+	static constexpr std::uint64_t gamma = { 0x9e3779b97f4a7c15ULL };
+	//! Key of the sequence derived from the seed and the stream.
+	std::uint64_t key_;
+	//! Number of the next value.
+	std::uint64_t counter_ = { 0 };
+};
+
+inline CounterRng::CounterRng(const std::uint64_t seed, const std::uint64_t stream) noexcept
+	: key_{ Mix(seed ^ Mix(stream + gamma)) }
+{
+}
+
+constexpr CounterRng::result_type CounterRng::min() noexcept
+{
+	return 0;
+}
+
+constexpr CounterRng::result_type CounterRng::max() noexcept
+{
+	return std::numeric_limits<result_type>::max();
+}
+
+inline CounterRng::result_type CounterRng::operator()() noexcept
+{
+	return Generate(counter_++);
+}
+
+inline CounterRng::result_type CounterRng::Generate(const std::uint64_t n) const noexcept
+{
+	return Mix(key_ + (n + 1) * gamma);
+}
+
+inline void CounterRng::Generate(const std::uint64_t first, const size_t count, result_type* output) const noexcept
+{
+	const std::uint64_t base = key_ + (first + 1) * gamma;
+	for (size_t i = 0; i < count; ++i) {
+		output[i] = Mix(base + i * gamma);
+	}
+}
+
+inline void CounterRng::Discard(const std::uint64_t n) noexcept
+{
+	counter_ += n;
+}
+
+inline void CounterRng::Seek(const std::uint64_t n) noexcept
+{
+	counter_ = n;
+}
+
+inline std::uint64_t CounterRng::GetCounter() const noexcept
+{
+	return counter_;
+}
+
+constexpr std::uint64_t CounterRng::Mix(std::uint64_t x) noexcept
+{
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+namespace detail
+{
+
+//! Returns high 64 bits of the product.
+inline std::uint64_t MultiplyHigh(const std::uint64_t left, const std::uint64_t right) noexcept
+{
+	const std::uint64_t leftLow = left & 0xffffffffULL;
+	const std::uint64_t leftHigh = left >> 32;
+	const std::uint64_t rightLow = right & 0xffffffffULL;
+	const std::uint64_t rightHigh = right >> 32;
+	const std::uint64_t lowLow = leftLow * rightLow;
+	const std::uint64_t highLow = leftHigh * rightLow;
+	const std::uint64_t lowHigh = leftLow * rightHigh;
+	const std::uint64_t middle = (lowLow >> 32) + (highLow & 0xffffffffULL) + (lowHigh & 0xffffffffULL);
+
+	return leftHigh * rightHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+}
+
+//! Maps random bits to [low, high) for floating point types, the top bits of the value
+//! become the mantissa of the fraction.
+template<typename T>
+std::enable_if_t<std::is_floating_point<T>::value> UniformFromBits(
+	const std::uint64_t* bits,
+	const size_t count,
+	const T low,
+	const T high,
+	T* output) noexcept
+{
+	constexpr int digits = std::min(std::numeric_limits<T>::digits, 63);
+	// Narrow integers are converted by vector instructions of all instruction sets.
+	using Integer = std::conditional_t<(digits < 32), std::int32_t, std::int64_t>;
+	const T scale = (high - low) / static_cast<T>(std::uint64_t{ 1 } << digits);
+	for (size_t i = 0; i < count; ++i) {
+		output[i] = low + static_cast<T>(static_cast<Integer>(bits[i] >> (64 - digits))) * scale;
+	}
+}
+
+//! Maps random bits to [low, high] for integral types with the multiply-shift method,
+//! bias of the result is below range / 2^32 for ranges up to 2^32.
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value> UniformFromBits(
+	const std::uint64_t* bits,
+	const size_t count,
+	const T low,
+	const T high,
+	T* output) noexcept
+{
+	using Unsigned = std::make_unsigned_t<T>;
+	const std::uint64_t range = static_cast<std::uint64_t>(static_cast<Unsigned>(high) - static_cast<Unsigned>(low)) + 1;
+	const Unsigned base = static_cast<Unsigned>(low);
+	if (range == 0)
+	{
+		// The range covers all 64-bit values.
+		for (size_t i = 0; i < count; ++i) {
+			output[i] = static_cast<T>(bits[i]);
+		}
+	}
+	else if (range <= (std::uint64_t{ 1 } << 32))
+	{
+		for (size_t i = 0; i < count; ++i) {
+			output[i] = static_cast<T>(static_cast<Unsigned>(base + (((bits[i] >> 32) * range) >> 32)));
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < count; ++i) {
+			output[i] = static_cast<T>(static_cast<Unsigned>(base + MultiplyHigh(bits[i], range)));
+		}
+	}
+}
+
+}	// namespace detail
+
+//! Fills the view with uniformly distributed values, from [low, high] for integral types
+//! and from [low, high) for floating point ones. Element (r, c) gets value number
+//! r * columns + c of CounterRng(seed), so the result depends only on the seed and the sizes
+//! of the view, but not on the policy, number of threads or padding of rows.
+//! Blocks of rows are filled according to the policy.
+template<typename Policy, typename T>
+detail::EnableIfPolicy<Policy> RandomizeUniform(
+	const Policy& policy,
+	const Matrix2DView<T>& view,
+	const std::uint64_t seed,
+	const std::remove_const_t<T> low,
+	const std::remove_const_t<T> high)
+{
+	static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+		"RandomizeUniform supports integral types except bool and floating point types.");
+
+	const CounterRng generator(seed);
+	const size_t columns = view.GetColumns();
+	// Values are generated in chunks small enough to stay in the L1 cache.
+	constexpr size_t chunkLength = 256;
+	detail::ParallelFor(
+		policy,
+		0,
+		view.GetRows(),
+		detail::RowsPerBlock(columns),
+		[&] (const size_t first, const size_t last)
+		{
+			std::uint64_t bits[chunkLength];
+			std::remove_const_t<T> values[chunkLength];
+			for (size_t r = first; r < last; ++r)
+			{
+				for (size_t c = 0; c < columns; c += chunkLength)
+				{
+					const size_t count = std::min(chunkLength, columns - c);
+					generator.Generate(static_cast<std::uint64_t>(r) * columns + c, count, bits);
+					if (view.HasContiguousRows()) {
+						detail::UniformFromBits(bits, count, low, high, &view(r, c));
+					}
+					else
+					{
+						detail::UniformFromBits(bits, count, low, high, values);
+						std::copy(values, values + count, view.Row(r).Begin() + static_cast<std::ptrdiff_t>(c));
+					}
+				}
+			}
+		});
+}
+
+//! Same as above, elements are filled by the calling thread.
+template<typename T>
+void RandomizeUniform(
+	const Matrix2DView<T>& view,
+	const std::uint64_t seed,
+	const std::remove_const_t<T> low,
+	const std::remove_const_t<T> high)
+{
+	RandomizeUniform(execution::seq, view, seed, low, high);
+}
+
+}	// namespace mtx
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mtx
+{
+
+//! Pool of worker threads which executes parallel loops of the library.
+//! Every worker has its own deque of tasks: the owner takes tasks from the bottom
+//! and idle workers steal from the top, where the biggest ranges are. A task covering
+//! a range of rows splits itself in halves until the range is shorter than two grains,
+//! so the load is balanced dynamically.
+//! Threads waiting for their loop execute tasks as well, so nested loops started from
+//! tasks run on the same workers and never create additional threads.
+class WorkStealingScheduler
+{
+	//
+	// Nested types.
+	//
+private:
+	//! Loop shared by all its tasks.
+	class Job
+	{
+	public:
+		explicit Job(const size_t grain) noexcept : grain_{ grain } {}
+		virtual void Run(const size_t begin, const size_t end) = 0;
+
+	public:
+		//! Ranges of at least two grains are split.
+		const size_t grain_;
+		//! Number of tasks of the job which are not finished yet.
+		std::atomic<size_t> pending_ = { 1 };
+		//! The first exception thrown by the loop body.
+		std::exception_ptr error_;
+		std::mutex errorMutex_;
+
+	protected:
+		~Job() = default;
+	};
+
+	//! Job which calls the loop body for ranges.
+	template<typename Func>
+	class LoopJob
+		: public Job
+	{
+	public:
+		LoopJob(Func& func, const size_t grain) noexcept : Job(grain), func_(func) {}
+		void Run(const size_t begin, const size_t end) override { func_(begin, end); }
+
+	private:
+		Func& func_;
+	};
+
+	//! Range of the loop.
+	struct Task
+	{
+		Job* job_ = { nullptr };
+		size_t begin_ = { 0 };
+		size_t end_ = { 0 };
+	};
+
+	//! Deque of tasks of a single worker.
+	struct TaskQueue
+	{
+		std::mutex mutex_;
+		std::deque<Task> tasks_;
+	};
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, starts specified number of worker threads.
+	//! Scheduler without workers runs loops on the calling thread.
+	explicit WorkStealingScheduler(const size_t workers = GetDefaultWorkersNumber());
+	//! Destructor, waits for workers to finish.
+	~WorkStealingScheduler() noexcept;
+	WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+	WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Calls func(rangeBegin, rangeEnd) for subranges of [begin, end) of at least grain
+	//! elements in parallel and returns when all of them are finished. Calling thread
+	//! takes part in the work. The first exception thrown by func is rethrown.
+	template<typename Func>
+	void ParallelFor(const size_t begin, const size_t end, const size_t grain, Func func);
+	//! Returns number of worker threads.
+	size_t GetWorkersNumber() const noexcept;
+	//! Returns scheduler shared by the library, it has one worker less than hardware threads,
+	//! since the calling thread works too.
+	static WorkStealingScheduler& GetDefault();
+	//! Returns number of workers of the default scheduler.
+	static size_t GetDefaultWorkersNumber() noexcept;
+
+	//
+	// Private methods.
+	//
+private:
+	//! Main loop of the worker.
+	void WorkerLoop(const size_t index);
+	//! Returns index of the queue of the calling thread,
+	//! threads which don't belong to the scheduler share the last queue.
+	size_t GetOwnQueue() const noexcept;
+	//! Puts the task to the queue of the calling thread and wakes up a sleeping worker.
+	void Push(const Task& task);
+	//! Takes the newest task of the own queue or steals the oldest task of another queue.
+	bool TryTake(Task& task);
+	//! Splits the task, executes its first part and marks it finished.
+	void Execute(Task task);
+	//! Returns scheduler and index of the worker running on the calling thread.
+	static std::pair<const WorkStealingScheduler*, size_t>& CurrentWorker() noexcept;
+
+	//
+	// Private data members.
+	//
+private:
+	//! Queues of workers and the queue of external threads at the end.
+	std::vector<std::unique_ptr<TaskQueue>> queues_;
+	//! Worker threads.
+	std::vector<std::thread> workers_;
+	//! Number of tasks in all queues.
+	std::atomic<size_t> queued_ = { 0 };
+	//! Number of workers waiting for tasks.
+	std::atomic<size_t> sleeping_ = { 0 };
+	//! Protects stop_ and sleeping of workers.
+	std::mutex sleepMutex_;
+	std::condition_variable wakeUp_;
+	//! Requests workers to finish.
+	bool stop_ = { false };
+};
+
+inline WorkStealingScheduler::WorkStealingScheduler(const size_t workers)
+{
+	queues_.reserve(workers + 1);
+	for (size_t i = 0; i < workers + 1; ++i) {
+		queues_.push_back(std::make_unique<TaskQueue>());
+	}
+
+	workers_.reserve(workers);
+	for (size_t i = 0; i < workers; ++i) {
+		workers_.emplace_back([this, i] { WorkerLoop(i); });
+	}
+}
+
+inline WorkStealingScheduler::~WorkStealingScheduler() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stop_ = true;
+	}
+	wakeUp_.notify_all();
+
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+template<typename Func>
+void WorkStealingScheduler::ParallelFor(const size_t begin, const size_t end, const size_t grain, Func func)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	const size_t grainSize = std::max<size_t>(grain, 1);
+	if (workers_.empty() || end - begin < 2 * grainSize)
+	{
+		func(begin, end);
+		return;
+	}
+
+	LoopJob<Func> job(func, grainSize);
+	Execute(Task{ &job, begin, end });
+	// Help with any tasks until all tasks of this job are finished.
+	while (job.pending_.load(std::memory_order_acquire) != 0)
+	{
+		Task task;
+		if (TryTake(task)) {
+			Execute(task);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	if (job.error_) {
+		std::rethrow_exception(job.error_);
+	}
+}
+
+inline size_t WorkStealingScheduler::GetWorkersNumber() const noexcept
+{
+	return workers_.size();
+}
+
+inline WorkStealingScheduler& WorkStealingScheduler::GetDefault()
+{
+	static WorkStealingScheduler scheduler;
+	return scheduler;
+}
+
+inline size_t WorkStealingScheduler::GetDefaultWorkersNumber() noexcept
+{
+	const size_t threads = std::thread::hardware_concurrency();
+	return threads <= 1 ? 0 : threads - 1;
+}
+
+inline void WorkStealingScheduler::WorkerLoop(const size_t index)
+{
+	CurrentWorker() = std::make_pair(this, index);
+	while (true)
+	{
+		Task task;
+		if (TryTake(task))
+		{
+			Execute(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		++sleeping_;
+		wakeUp_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+		--sleeping_;
+		if (stop_ && queued_.load() == 0) {
+			return;
+		}
+	}
+}
+
+inline size_t WorkStealingScheduler::GetOwnQueue() const noexcept
+{
+	const auto& worker = CurrentWorker();
+	return worker.first == this ? worker.second : queues_.size() - 1;
+}
+
+inline void WorkStealingScheduler::Push(const Task& task)
+{
+	auto& queue = *queues_[GetOwnQueue()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		queue.tasks_.push_back(task);
+	}
+
+	// Worker either sees the new task before it sleeps or is already waiting for notification.
+	queued_.fetch_add(1);
+	if (sleeping_.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+		}
+		wakeUp_.notify_one();
+	}
+}
+
+inline bool WorkStealingScheduler::TryTake(Task& task)
+{
+	const size_t own = GetOwnQueue();
+	{
+		auto& queue = *queues_[own];
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		if (!queue.tasks_.empty())
+		{
+			task = queue.tasks_.back();
+			queue.tasks_.pop_back();
+			queued_.fetch_sub(1);
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < queues_.size(); ++i)
+	{
+		auto& queue = *queues_[(own + i) % queues_.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		if (!queue.tasks_.empty())
+		{
+			task = queue.tasks_.front();
+			queue.tasks_.pop_front();
+			queued_.fetch_sub(1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline void WorkStealingScheduler::Execute(Task task)
+{
+	Job& job = *task.job_;
+	// Second halves are left for thieves, the biggest ones are at the top of the deque.
+	while (task.end_ - task.begin_ >= 2 * job.grain_)
+	{
+		const size_t middle = task.begin_ + (task.end_ - task.begin_) / 2;
+		job.pending_.fetch_add(1, std::memory_order_relaxed);
+		Push(Task{ &job, middle, task.end_ });
+		task.end_ = middle;
+	}
+
+	try {
+		job.Run(task.begin_, task.end_);
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(job.errorMutex_);
+		if (!job.error_) {
+			job.error_ = std::current_exception();
+		}
+	}
+
+	// Job may be destroyed by its owner right after the last task is finished.
+	job.pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+inline std::pair<const WorkStealingScheduler*, size_t>& WorkStealingScheduler::CurrentWorker() noexcept
+{
+	thread_local std::pair<const WorkStealingScheduler*, size_t> worker{ nullptr, 0 };
+	return worker;
+}
+
+}	// namespace mtx
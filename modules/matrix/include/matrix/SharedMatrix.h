@@ -0,0 +1,260 @@
+#pragma once
+
+#include "matrix/Instrumentation.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixExpression.h"
+#include "matrix/MatrixView.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace mtx
+{
+
+//! Matrix with copy-on-write storage: copies share the refcounted Matrix2D and take constant
+//! time, the first mutable access of a copy clones the storage, so every copy behaves as
+//! an independent value. It suits pipelines where most stages only read the matrix.
+//! Read access (const methods) doesn't check for sharing. Mutable accessors check it every time,
+//! so loops writing many elements should take the view once and write through it.
+//! References, iterators and views returned by mutable accessors must not be used after
+//! the matrix is copied, they would modify the shared storage.
+//! A single matrix object must not be accessed by several threads while one of them mutates it,
+//! different copies sharing the storage may be used by different threads.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+class SharedMatrix2D
+{
+	//
+	// Alias declaration.
+	//
+public:
+	using Matrix = Matrix2D<T, Alloc>;
+	using Dimension = typename Matrix::Dimension;
+	using Iterator = typename Matrix::Iterator;
+	using ConstIterator = typename Matrix::ConstIterator;
+	using View = typename Matrix::View;
+	using ConstView = typename Matrix::ConstView;
+
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, the matrix is empty.
+	SharedMatrix2D();
+	//! Constructor, all elements are set to defVal.
+	SharedMatrix2D(const size_t rows, const size_t columns, const T& defVal = T(), const Alloc& alloc = Alloc());
+	//! Constructor, takes elements of the matrix without copying them.
+	SharedMatrix2D(Matrix&& mat);
+	//! Constructor, copies elements of the matrix once, further copies share them.
+	explicit SharedMatrix2D(const Matrix& mat);
+	//! Constructor, evaluates the expression, see MatrixExpression.
+	template<typename E>
+	SharedMatrix2D(const MatrixExpression<E>& expr);
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of columns.
+	size_t GetColumns() const noexcept;
+	//! Returns number of rows.
+	size_t GetRows() const noexcept;
+	//! Returns true if the storage is shared with other copies.
+	bool IsShared() const noexcept;
+	//! Provides read access to the elements without a check for sharing.
+	const T& operator()(const size_t row, const size_t column) const;
+	ConstIterator Begin() const noexcept;
+	ConstIterator End() const noexcept;
+	ConstView GetView() const noexcept;
+	//! Returns the matrix for reading, e.g. to pass it to functions working on Matrix2D.
+	const Matrix& Read() const noexcept;
+	//! Provide mutable access to the elements, clone the storage if it is shared.
+	T& operator()(const size_t row, const size_t column);
+	Iterator Begin();
+	Iterator End();
+	View GetView();
+	//! Returns the matrix for writing, clones the storage if it is shared.
+	Matrix& Write();
+
+	//
+	// Private methods.
+	//
+private:
+	//! Clones the storage if it is shared, so the matrix becomes its only owner.
+	void Detach();
+
+	//
+	// Private data members.
+	//
+private:
+	//! Matrix shared by copies, it is null only in a moved-from matrix,
+	//! which may be assigned or destroyed only.
+	std::shared_ptr<Matrix> mat_;
+};
+
+template<typename T, typename Alloc>
+SharedMatrix2D<T, Alloc>::SharedMatrix2D()
+	: mat_{ std::make_shared<Matrix>() }
+{
+}
+
+template<typename T, typename Alloc>
+SharedMatrix2D<T, Alloc>::SharedMatrix2D(const size_t rows, const size_t columns, const T& defVal, const Alloc& alloc)
+	: mat_{ std::make_shared<Matrix>(rows, columns, defVal, alloc) }
+{
+}
+
+template<typename T, typename Alloc>
+SharedMatrix2D<T, Alloc>::SharedMatrix2D(Matrix&& mat)
+	: mat_{ std::make_shared<Matrix>(std::move(mat)) }
+{
+}
+
+template<typename T, typename Alloc>
+SharedMatrix2D<T, Alloc>::SharedMatrix2D(const Matrix& mat)
+	: mat_{ std::make_shared<Matrix>(mat) }
+{
+}
+
+template<typename T, typename Alloc>
+template<typename E>
+SharedMatrix2D<T, Alloc>::SharedMatrix2D(const MatrixExpression<E>& expr)
+	: mat_{ std::make_shared<Matrix>(expr) }
+{
+}
+
+template<typename T, typename Alloc>
+size_t SharedMatrix2D<T, Alloc>::GetColumns() const noexcept
+{
+	return mat_->GetColumns();
+}
+
+template<typename T, typename Alloc>
+size_t SharedMatrix2D<T, Alloc>::GetRows() const noexcept
+{
+	return mat_->GetRows();
+}
+
+template<typename T, typename Alloc>
+bool SharedMatrix2D<T, Alloc>::IsShared() const noexcept
+{
+	return mat_.use_count() > 1;
+}
+
+template<typename T, typename Alloc>
+const T& SharedMatrix2D<T, Alloc>::operator()(const size_t row, const size_t column) const
+{
+	return Read()(row, column);
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::ConstIterator SharedMatrix2D<T, Alloc>::Begin() const noexcept
+{
+	return Read().Begin();
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::ConstIterator SharedMatrix2D<T, Alloc>::End() const noexcept
+{
+	return Read().End();
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::ConstView SharedMatrix2D<T, Alloc>::GetView() const noexcept
+{
+	return Read().GetView();
+}
+
+template<typename T, typename Alloc>
+const typename SharedMatrix2D<T, Alloc>::Matrix& SharedMatrix2D<T, Alloc>::Read() const noexcept
+{
+	return *mat_;
+}
+
+template<typename T, typename Alloc>
+T& SharedMatrix2D<T, Alloc>::operator()(const size_t row, const size_t column)
+{
+	return Write()(row, column);
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::Iterator SharedMatrix2D<T, Alloc>::Begin()
+{
+	return Write().Begin();
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::Iterator SharedMatrix2D<T, Alloc>::End()
+{
+	return Write().End();
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::View SharedMatrix2D<T, Alloc>::GetView()
+{
+	return Write().GetView();
+}
+
+template<typename T, typename Alloc>
+typename SharedMatrix2D<T, Alloc>::Matrix& SharedMatrix2D<T, Alloc>::Write()
+{
+	Detach();
+
+	return *mat_;
+}
+
+template<typename T, typename Alloc>
+void SharedMatrix2D<T, Alloc>::Detach()
+{
+	if (mat_.use_count() > 1)
+	{
+		mat_ = std::make_shared<Matrix>(*mat_);
+		return;
+	}
+
+	// The last other owner may have just released the storage after reading it,
+	// its reads must happen before our writes.
+	std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+//! Returns true if matrices have equal sizes and elements. Copies sharing storage are compared
+//! element by element like copies of Matrix2D, so a copy of a matrix with NaN isn't equal to it.
+template<typename T, typename Alloc>
+bool operator==(const SharedMatrix2D<T, Alloc>& left, const SharedMatrix2D<T, Alloc>& right)
+{
+	if (&left == &right) {
+		return true;
+	}
+
+	const auto& leftMatrix = left.Read();
+	const auto& rightMatrix = right.Read();
+	if (&leftMatrix != &rightMatrix) {
+		return leftMatrix == rightMatrix;
+	}
+
+	// operator== of Matrix2D treats the same object as equal without comparing elements.
+	MTX_INSTRUMENT(Equal, 2 * leftMatrix.GetRows() * leftMatrix.GetColumns());
+	return detail::EqualViews(leftMatrix.GetView(), rightMatrix.GetView());
+}
+
+template<typename T, typename Alloc>
+bool operator!=(const SharedMatrix2D<T, Alloc>& left, const SharedMatrix2D<T, Alloc>& right)
+{
+	return !(left == right);
+}
+
+namespace detail
+{
+
+//! Shared matrix takes part in expressions through a view of its elements, reading doesn't clone them.
+template<typename T, typename Alloc>
+struct ExpressionOperand<SharedMatrix2D<T, Alloc>>
+{
+	using Type = ViewExpression<T>;
+	static Type Make(const SharedMatrix2D<T, Alloc>& mat) noexcept { return Type(mat.GetView()); }
+};
+
+}	// namespace detail
+
+}	// namespace mtx
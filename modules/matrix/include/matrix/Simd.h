@@ -0,0 +1,923 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+// Explicit vector kernels are available on x86 with GCC, Clang and MSVC.
+// Define MTX_DISABLE_SIMD to always use portable scalar loops.
+#if !defined(MTX_DISABLE_SIMD) \
+	&& (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define MTX_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace mtx
+{
+namespace simd
+{
+
+//! Instruction set levels, every level implies support of the previous ones.
+enum class Isa
+{
+	Scalar = 0,
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+namespace detail
+{
+
+//! Maps element type to the lane type of vector kernels.
+//! Types without specialization are processed by scalar loops only.
+template<typename T, typename = void>
+struct SimdLane
+{
+};
+
+template<>
+struct SimdLane<float>
+{
+	using Type = float;
+};
+
+template<>
+struct SimdLane<double>
+{
+	using Type = double;
+};
+
+template<typename T>
+struct SimdLane<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value
+	&& (sizeof(T) == 4 || sizeof(T) == 8)>>
+{
+	using Type = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+};
+
+template<typename...>
+struct MakeVoid
+{
+	using Type = void;
+};
+
+template<typename T, typename = void>
+struct HasSimdLane
+	: std::false_type
+{
+};
+
+template<typename T>
+struct HasSimdLane<T, typename MakeVoid<typename SimdLane<T>::Type>::Type>
+	: std::true_type
+{
+};
+
+//! Returns number of set bits, used to count lanes of comparison masks.
+inline size_t PopCount(unsigned bits) noexcept
+{
+	bits = bits - ((bits >> 1) & 0x55555555u);
+	bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+	bits = (bits + (bits >> 4)) & 0x0f0f0f0fu;
+	return static_cast<size_t>((bits * 0x01010101u) >> 24);
+}
+
+//! Returns number of zero bits below the lowest set bit, bits must not be zero.
+inline size_t CountTrailingZeros(const std::uint64_t bits) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<size_t>(__builtin_ctzll(bits));
+#elif defined(MTX_SIMD_X86) && defined(_M_X64)
+	unsigned long index = 0;
+	_BitScanForward64(&index, bits);
+	return static_cast<size_t>(index);
+#else
+	size_t count = 0;
+	while (((bits >> count) & 1) == 0) {
+		++count;
+	}
+	return count;
+#endif
+}
+
+//! Returns mask of equal neighbors of data[0, pairs]: bit i is set if data[i] == data[i + 1],
+//! pairs must not exceed 64.
+template<typename It>
+std::uint64_t EqualNeighbors(const It data, const size_t pairs)
+{
+	std::uint64_t equal = 0;
+	for (size_t i = 0; i < pairs; ++i) {
+		equal |= static_cast<std::uint64_t>(data[i] == data[i + 1]) << i;
+	}
+
+	return equal;
+}
+
+//! Finds the longest run of identical elements from consecutive masks of equal neighbors,
+//! see EqualNeighbors. Boundaries of runs are found by bit-scan of the masks, so the time
+//! depends on the number of runs rather than the number of elements.
+struct RunScanner
+{
+	//! Consumes the mask of the next bits pairs of neighbors, bits must not exceed 64.
+	void Consume(std::uint64_t equal, const size_t bits) noexcept
+	{
+		const std::uint64_t valid = bits == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << bits) - 1;
+		equal &= valid;
+		// Bit i of starts is set if the pair i is equal and the previous one isn't,
+		// bit i of ends is set if the pair i isn't equal and the previous one is.
+		const std::uint64_t previous = (equal << 1) | static_cast<std::uint64_t>(open_);
+		std::uint64_t starts = equal & ~previous;
+		std::uint64_t ends = ~equal & valid & previous;
+		while (ends != 0)
+		{
+			if (!open_)
+			{
+				first_ = position_ + CountTrailingZeros(starts);
+				starts &= starts - 1;
+			}
+			const size_t last = position_ + CountTrailingZeros(ends);
+			ends &= ends - 1;
+			open_ = false;
+			Update(last);
+		}
+		if (starts != 0)
+		{
+			first_ = position_ + CountTrailingZeros(starts);
+			open_ = true;
+		}
+		position_ += bits;
+	}
+
+	//! Returns length and the first element of the longest run, the first of the longest runs wins.
+	//! Returns {1, 0} if there are no identical neighbors.
+	std::pair<size_t, size_t> Finish() noexcept
+	{
+		if (open_)
+		{
+			Update(position_);
+			open_ = false;
+		}
+
+		return std::make_pair(longest_, longestFirst_);
+	}
+
+	//! Replaces the longest run by the run [first_, last] if it is longer.
+	void Update(const size_t last) noexcept
+	{
+		if (last - first_ + 1 > longest_)
+		{
+			longest_ = last - first_ + 1;
+			longestFirst_ = first_;
+		}
+	}
+
+	//! Number of consumed pairs, it is the index of the last consumed element.
+	size_t position_ = { 0 };
+	//! True if the run started at first_ continues past the consumed pairs.
+	bool open_ = { false };
+	size_t first_ = { 0 };
+	size_t longest_ = { 1 };
+	size_t longestFirst_ = { 0 };
+};
+
+//! Detects the best instruction set supported by the processor and the operating system.
+inline Isa DetectIsa() noexcept
+{
+#if defined(MTX_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		return Isa::Avx512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return Isa::Avx2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return Isa::Sse2;
+	}
+	return Isa::Scalar;
+#elif defined(MTX_SIMD_X86)
+	int info[4] = {};
+	__cpuid(info, 1);
+	const bool sse2 = (info[3] & (1 << 26)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	// Check that the operating system saves ymm and zmm registers.
+	const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	const bool avxState = (xcr0 & 0x6) == 0x6;
+	const bool avx512State = (xcr0 & 0xe6) == 0xe6;
+	__cpuidex(info, 7, 0);
+	const bool avx2 = (info[1] & (1 << 5)) != 0;
+	const bool avx512f = (info[1] & (1 << 16)) != 0;
+	if (avx512f && avx512State) {
+		return Isa::Avx512;
+	}
+	if (avx2 && avxState) {
+		return Isa::Avx2;
+	}
+	return sse2 ? Isa::Sse2 : Isa::Scalar;
+#else
+	return Isa::Scalar;
+#endif
+}
+
+//! Returns storage for the instruction set limit set by SetIsaLimit.
+inline std::atomic<int>& IsaLimit() noexcept
+{
+	static std::atomic<int> limit{ static_cast<int>(Isa::Avx512) };
+	return limit;
+}
+
+}	// namespace detail
+
+//! Returns the best instruction set supported by the processor, detected once.
+inline Isa GetSupportedIsa() noexcept
+{
+	static const Isa supported = detail::DetectIsa();
+	return supported;
+}
+
+//! Returns instruction set used by the kernels: the supported one unless it is limited.
+inline Isa GetActiveIsa() noexcept
+{
+	const auto limit = static_cast<Isa>(detail::IsaLimit().load(std::memory_order_relaxed));
+	return std::min(GetSupportedIsa(), limit);
+}
+
+//! Limits instruction set used by the kernels, e.g. for benchmarks and tests.
+//! Pass Isa::Avx512 to remove the limit.
+inline void SetIsaLimit(const Isa isa) noexcept
+{
+	detail::IsaLimit().store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+//! Returns printable name of the instruction set.
+inline const char* GetIsaName(const Isa isa) noexcept
+{
+	switch (isa)
+	{
+	case Isa::Sse2:
+		return "SSE2";
+	case Isa::Avx2:
+		return "AVX2";
+	case Isa::Avx512:
+		return "AVX-512";
+	default:
+		return "Scalar";
+	}
+}
+
+//! True for element types which have vector kernels: float, double
+//! and 32 or 64 bit integers.
+template<typename T>
+struct IsVectorizable
+	: detail::HasSimdLane<T>
+{
+};
+
+namespace scalar
+{
+
+template<typename Lane, typename T>
+void Add(const T* left, const T* right, T* result, const size_t n)
+{
+	std::transform(left, left + n, right, result, std::plus<T>());
+}
+
+template<typename Lane, typename T>
+void Subtract(const T* left, const T* right, T* result, const size_t n)
+{
+	std::transform(left, left + n, right, result, std::minus<T>());
+}
+
+template<typename Lane, typename T>
+bool Equal(const T* left, const T* right, const size_t n)
+{
+	return std::equal(left, left + n, right);
+}
+
+template<typename Lane, typename T>
+T Sum(const T* data, const size_t n, const T init)
+{
+	return std::accumulate(data, data + n, init);
+}
+
+template<typename Lane, typename T>
+bool AnyNegative(const T* data, const size_t n)
+{
+	return std::any_of(data, data + n, [] (const T& val) { return val < 0; });
+}
+
+template<typename Lane, typename T>
+size_t CountLocalMinimums(const T* above, const T* row, const T* below, const size_t n)
+{
+	size_t count = 0;
+	for (size_t i = 1; i + 1 < n; ++i)
+	{
+		const T center = row[i];
+		// Comparisons are combined without branches, so the compiler may vectorize the loop.
+		count += static_cast<size_t>(
+			!(above[i - 1] <= center) & !(above[i] <= center) & !(above[i + 1] <= center)
+			& !(row[i - 1] <= center) & !(row[i + 1] <= center)
+			& !(below[i - 1] <= center) & !(below[i] <= center) & !(below[i + 1] <= center));
+	}
+
+	return count;
+}
+
+//! Returns length and the first element of the longest run of identical elements,
+//! data may be any random access iterator, e.g. over a column.
+template<typename Lane, typename It>
+std::pair<size_t, size_t> LongestRun(const It data, const size_t n)
+{
+	detail::RunScanner scanner;
+	const size_t pairs = n > 0 ? n - 1 : 0;
+	for (size_t i = 0; i < pairs; i += 64)
+	{
+		const size_t bits = std::min<size_t>(64, pairs - i);
+		scanner.Consume(detail::EqualNeighbors(data + i, bits), bits);
+	}
+
+	return scanner.Finish();
+}
+
+}	// namespace scalar
+
+}	// namespace simd
+}	// namespace mtx
+
+#if defined(MTX_SIMD_X86)
+
+//
+// SSE2 kernels.
+//
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace mtx
+{
+namespace simd
+{
+namespace sse2
+{
+
+template<typename Lane>
+struct Ops;
+
+template<>
+struct Ops<float>
+{
+	using Vec = __m128;
+	using Mask = Vec;
+	static constexpr size_t lanes = 4;
+	static Vec Zero() { return _mm_setzero_ps(); }
+	static Vec Load(const void* p) { return _mm_loadu_ps(static_cast<const float*>(p)); }
+	static void Store(void* p, Vec v) { _mm_storeu_ps(static_cast<float*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)) == 0xf; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+	static bool AnyNegative(Vec a) { return _mm_movemask_ps(_mm_cmplt_ps(a, Zero())) != 0; }
+	// Comparisons of NaN are unordered, so they give true as !(a <= b) does.
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm_cmpnle_ps(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm_movemask_ps(m))); }
+};
+
+template<>
+struct Ops<double>
+{
+	using Vec = __m128d;
+	using Mask = Vec;
+	static constexpr size_t lanes = 2;
+	static Vec Zero() { return _mm_setzero_pd(); }
+	static Vec Load(const void* p) { return _mm_loadu_pd(static_cast<const double*>(p)); }
+	static void Store(void* p, Vec v) { _mm_storeu_pd(static_cast<double*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)) == 0x3; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+	static bool AnyNegative(Vec a) { return _mm_movemask_pd(_mm_cmplt_pd(a, Zero())) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm_cmpnle_pd(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm_and_pd(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm_movemask_pd(m))); }
+};
+
+template<>
+struct Ops<std::int32_t>
+{
+	using Vec = __m128i;
+	using Mask = Vec;
+	static constexpr size_t lanes = 4;
+	static Vec Zero() { return _mm_setzero_si128(); }
+	static Vec Load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+	static void Store(void* p, Vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) == 0xffff; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+	static bool AnyNegative(Vec a) { return _mm_movemask_ps(_mm_castsi128_ps(a)) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm_and_si128(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)))); }
+};
+
+template<>
+struct Ops<std::int64_t>
+{
+	using Vec = __m128i;
+	using Mask = Vec;
+	static constexpr size_t lanes = 2;
+	static Vec Zero() { return _mm_setzero_si128(); }
+	static Vec Load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+	static void Store(void* p, Vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm_sub_epi64(a, b); }
+	// 64 bit lanes are equal when both of their 32 bit halves are equal.
+	static bool AllEqual(Vec a, Vec b) { return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) == 0xffff; }
+	static unsigned EqualBits(Vec a, Vec b)
+	{
+		// Halves are compared separately, the mask of every half is combined with the swapped one.
+		const Vec halves = _mm_cmpeq_epi32(a, b);
+		const Vec both = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(both)));
+	}
+	static bool AnyNegative(Vec a) { return _mm_movemask_pd(_mm_castsi128_pd(a)) != 0; }
+	// SSE2 has no 64 bit comparison, so only sign bits of the mask lanes are meaningful:
+	// b - a is negative when a > b, the overflow is corrected by signs of the arguments.
+	// And and CountMask look at sign bits only.
+	static Mask NotLessEqual(Vec a, Vec b)
+	{
+		const Vec difference = _mm_sub_epi64(b, a);
+		return _mm_xor_si128(difference, _mm_and_si128(_mm_xor_si128(b, a), _mm_xor_si128(difference, b)));
+	}
+	static Mask And(Mask a, Mask b) { return _mm_and_si128(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(m)))); }
+};
+
+#include "matrix/SimdKernels.inl"
+
+}	// namespace sse2
+}	// namespace simd
+}	// namespace mtx
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+//
+// AVX2 kernels.
+//
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace mtx
+{
+namespace simd
+{
+namespace avx2
+{
+
+template<typename Lane>
+struct Ops;
+
+template<>
+struct Ops<float>
+{
+	using Vec = __m256;
+	using Mask = Vec;
+	static constexpr size_t lanes = 8;
+	static Vec Zero() { return _mm256_setzero_ps(); }
+	static Vec Load(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+	static void Store(void* p, Vec v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)) == 0xff; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+	static bool AnyNegative(Vec a) { return _mm256_movemask_ps(_mm256_cmp_ps(a, Zero(), _CMP_LT_OQ)) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_NLE_UQ); }
+	static Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm256_movemask_ps(m))); }
+};
+
+template<>
+struct Ops<double>
+{
+	using Vec = __m256d;
+	using Mask = Vec;
+	static constexpr size_t lanes = 4;
+	static Vec Zero() { return _mm256_setzero_pd(); }
+	static Vec Load(const void* p) { return _mm256_loadu_pd(static_cast<const double*>(p)); }
+	static void Store(void* p, Vec v) { _mm256_storeu_pd(static_cast<double*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)) == 0xf; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+	static bool AnyNegative(Vec a) { return _mm256_movemask_pd(_mm256_cmp_pd(a, Zero(), _CMP_LT_OQ)) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_NLE_UQ); }
+	static Mask And(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm256_movemask_pd(m))); }
+};
+
+template<>
+struct Ops<std::int32_t>
+{
+	using Vec = __m256i;
+	using Mask = Vec;
+	static constexpr size_t lanes = 8;
+	static Vec Zero() { return _mm256_setzero_si256(); }
+	static Vec Load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+	static void Store(void* p, Vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm256_sub_epi32(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)) == -1; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+	static bool AnyNegative(Vec a) { return _mm256_movemask_ps(_mm256_castsi256_ps(a)) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm256_and_si256(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)))); }
+};
+
+template<>
+struct Ops<std::int64_t>
+{
+	using Vec = __m256i;
+	using Mask = Vec;
+	static constexpr size_t lanes = 4;
+	static Vec Zero() { return _mm256_setzero_si256(); }
+	static Vec Load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+	static void Store(void* p, Vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+	static Vec Add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm256_sub_epi64(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)) == -1; }
+	static unsigned EqualBits(Vec a, Vec b) { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))); }
+	static bool AnyNegative(Vec a) { return _mm256_movemask_pd(_mm256_castsi256_pd(a)) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm256_cmpgt_epi64(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm256_and_si256(a, b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m)))); }
+};
+
+#include "matrix/SimdKernels.inl"
+
+}	// namespace avx2
+}	// namespace simd
+}	// namespace mtx
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+//
+// AVX-512 kernels.
+//
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace mtx
+{
+namespace simd
+{
+namespace avx512
+{
+
+template<typename Lane>
+struct Ops;
+
+template<>
+struct Ops<float>
+{
+	using Vec = __m512;
+	using Mask = __mmask16;
+	static constexpr size_t lanes = 16;
+	static Vec Zero() { return _mm512_setzero_ps(); }
+	static Vec Load(const void* p) { return _mm512_loadu_ps(p); }
+	static void Store(void* p, Vec v) { _mm512_storeu_ps(p, v); }
+	static Vec Add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ) == 0xffff; }
+	static unsigned EqualBits(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	static bool AnyNegative(Vec a) { return _mm512_cmp_ps_mask(a, Zero(), _CMP_LT_OQ) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_NLE_UQ); }
+	static Mask And(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(m); }
+};
+
+template<>
+struct Ops<double>
+{
+	using Vec = __m512d;
+	using Mask = __mmask8;
+	static constexpr size_t lanes = 8;
+	static Vec Zero() { return _mm512_setzero_pd(); }
+	static Vec Load(const void* p) { return _mm512_loadu_pd(p); }
+	static void Store(void* p, Vec v) { _mm512_storeu_pd(p, v); }
+	static Vec Add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ) == 0xff; }
+	static unsigned EqualBits(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+	static bool AnyNegative(Vec a) { return _mm512_cmp_pd_mask(a, Zero(), _CMP_LT_OQ) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_NLE_UQ); }
+	static Mask And(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(m); }
+};
+
+template<>
+struct Ops<std::int32_t>
+{
+	using Vec = __m512i;
+	using Mask = __mmask16;
+	static constexpr size_t lanes = 16;
+	static Vec Zero() { return _mm512_setzero_si512(); }
+	static Vec Load(const void* p) { return _mm512_loadu_si512(p); }
+	static void Store(void* p, Vec v) { _mm512_storeu_si512(p, v); }
+	static Vec Add(Vec a, Vec b) { return _mm512_add_epi32(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm512_sub_epi32(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm512_cmpeq_epi32_mask(a, b) == 0xffff; }
+	static unsigned EqualBits(Vec a, Vec b) { return _mm512_cmpeq_epi32_mask(a, b); }
+	static bool AnyNegative(Vec a) { return _mm512_cmplt_epi32_mask(a, Zero()) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm512_cmpgt_epi32_mask(a, b); }
+	static Mask And(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(m); }
+};
+
+template<>
+struct Ops<std::int64_t>
+{
+	using Vec = __m512i;
+	using Mask = __mmask8;
+	static constexpr size_t lanes = 8;
+	static Vec Zero() { return _mm512_setzero_si512(); }
+	static Vec Load(const void* p) { return _mm512_loadu_si512(p); }
+	static void Store(void* p, Vec v) { _mm512_storeu_si512(p, v); }
+	static Vec Add(Vec a, Vec b) { return _mm512_add_epi64(a, b); }
+	static Vec Sub(Vec a, Vec b) { return _mm512_sub_epi64(a, b); }
+	static bool AllEqual(Vec a, Vec b) { return _mm512_cmpeq_epi64_mask(a, b) == 0xff; }
+	static unsigned EqualBits(Vec a, Vec b) { return _mm512_cmpeq_epi64_mask(a, b); }
+	static bool AnyNegative(Vec a) { return _mm512_cmplt_epi64_mask(a, Zero()) != 0; }
+	static Mask NotLessEqual(Vec a, Vec b) { return _mm512_cmpgt_epi64_mask(a, b); }
+	static Mask And(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+	static size_t CountMask(Mask m) { return detail::PopCount(m); }
+};
+
+#include "matrix/SimdKernels.inl"
+
+}	// namespace avx512
+}	// namespace simd
+}	// namespace mtx
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif	// MTX_SIMD_X86
+
+namespace mtx
+{
+namespace simd
+{
+
+// Dispatch of the calls to the best kernel of the active instruction set.
+#if defined(MTX_SIMD_X86)
+#define MTX_SIMD_DISPATCH(Kernel, ...) \
+	switch (GetActiveIsa()) \
+	{ \
+	case Isa::Avx512: \
+		return avx512::Kernel<typename detail::SimdLane<T>::Type>(__VA_ARGS__); \
+	case Isa::Avx2: \
+		return avx2::Kernel<typename detail::SimdLane<T>::Type>(__VA_ARGS__); \
+	case Isa::Sse2: \
+		return sse2::Kernel<typename detail::SimdLane<T>::Type>(__VA_ARGS__); \
+	default: \
+		return scalar::Kernel<typename detail::SimdLane<T>::Type>(__VA_ARGS__); \
+	}
+#else
+#define MTX_SIMD_DISPATCH(Kernel, ...) \
+	return scalar::Kernel<typename detail::SimdLane<T>::Type>(__VA_ARGS__);
+#endif
+
+//! result[i] = left[i] + right[i], result may coincide with the arguments.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value>>
+void Add(const T* left, const T* right, T* result, const size_t n)
+{
+	MTX_SIMD_DISPATCH(Add, left, right, result, n)
+}
+
+//! result[i] = left[i] - right[i], result may coincide with the arguments.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value>>
+void Subtract(const T* left, const T* right, T* result, const size_t n)
+{
+	MTX_SIMD_DISPATCH(Subtract, left, right, result, n)
+}
+
+//! Returns true if left[i] == right[i] for all i.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value>>
+bool Equal(const T* left, const T* right, const size_t n)
+{
+	MTX_SIMD_DISPATCH(Equal, left, right, n)
+}
+
+//! Returns init + sum of elements. Order of additions differs from sequential loop,
+//! so results for floating point types may differ in the last bits.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value>>
+T Sum(const T* data, const size_t n, const T init)
+{
+	MTX_SIMD_DISPATCH(Sum, data, n, init)
+}
+
+//! Returns true if there is an element less than zero.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value && std::is_signed<T>::value>>
+bool AnyNegative(const T* data, const size_t n)
+{
+	MTX_SIMD_DISPATCH(AnyNegative, data, n)
+}
+
+//! Returns number of elements row[i], 0 < i < n - 1, which are less than all eight neighbors
+//! in row, above and below. Neighbors are compared as !(neighbor <= row[i]), so NaN neighbors
+//! don't prevent a minimum and a NaN element is a minimum, as with scalar comparisons.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value && std::is_signed<T>::value>>
+size_t CountLocalMinimums(const T* above, const T* row, const T* below, const size_t n)
+{
+	MTX_SIMD_DISPATCH(CountLocalMinimums, above, row, below, n)
+}
+
+//! Returns length and the first element of the longest run of identical neighboring elements,
+//! the first of the longest runs wins. Returns {1, 0} if there are no identical neighbors.
+//! Floating point elements are compared as with operator==, so NaN breaks every run.
+template<typename T, typename = std::enable_if_t<IsVectorizable<T>::value>>
+std::pair<size_t, size_t> LongestRun(const T* data, const size_t n)
+{
+	MTX_SIMD_DISPATCH(LongestRun, data, n)
+}
+
+#undef MTX_SIMD_DISPATCH
+
+}	// namespace simd
+}	// namespace mtx
+
+namespace mtx
+{
+namespace detail
+{
+
+//
+// Range helpers used by the library, they choose vector kernels when the element type
+// and the operation allow it and fall back to the standard algorithms otherwise.
+//
+
+//! result[i] = func(left[i], right[i]).
+template<typename L, typename R, typename O, typename BinaryOp>
+void TransformRange(const L* left, const R* right, O* result, const size_t n, BinaryOp func)
+{
+	std::transform(left, left + n, right, result, func);
+}
+
+template<typename T, typename = std::enable_if_t<simd::IsVectorizable<T>::value>>
+void TransformRange(const T* left, const T* right, T* result, const size_t n, std::plus<T>)
+{
+	simd::Add(left, right, result, n);
+}
+
+template<typename T, typename = std::enable_if_t<simd::IsVectorizable<T>::value>>
+void TransformRange(const T* left, const T* right, T* result, const size_t n, std::plus<>)
+{
+	simd::Add(left, right, result, n);
+}
+
+template<typename T, typename = std::enable_if_t<simd::IsVectorizable<T>::value>>
+void TransformRange(const T* left, const T* right, T* result, const size_t n, std::minus<T>)
+{
+	simd::Subtract(left, right, result, n);
+}
+
+template<typename T, typename = std::enable_if_t<simd::IsVectorizable<T>::value>>
+void TransformRange(const T* left, const T* right, T* result, const size_t n, std::minus<>)
+{
+	simd::Subtract(left, right, result, n);
+}
+
+template<typename T>
+bool EqualRange(const T* left, const T* right, const size_t n, std::true_type)
+{
+	return simd::Equal(left, right, n);
+}
+
+template<typename T>
+bool EqualRange(const T* left, const T* right, const size_t n, std::false_type)
+{
+	return std::equal(left, left + n, right);
+}
+
+//! Returns true if left[i] == right[i] for all i.
+template<typename T>
+bool EqualRange(const T* left, const T* right, const size_t n)
+{
+	return EqualRange(left, right, n, simd::IsVectorizable<T>());
+}
+
+template<typename T>
+T SumRange(const T* data, const size_t n, const T init, std::true_type)
+{
+	return simd::Sum(data, n, init);
+}
+
+template<typename T>
+T SumRange(const T* data, const size_t n, const T init, std::false_type)
+{
+	return std::accumulate(data, data + n, init);
+}
+
+//! Returns init + sum of elements.
+template<typename T>
+T SumRange(const T* data, const size_t n, const T init)
+{
+	return SumRange(data, n, init, simd::IsVectorizable<T>());
+}
+
+template<typename T>
+bool AnyNegativeInRange(const T* data, const size_t n, std::true_type)
+{
+	return simd::AnyNegative(data, n);
+}
+
+template<typename T>
+bool AnyNegativeInRange(const T* data, const size_t n, std::false_type)
+{
+	return std::any_of(data, data + n, [] (const T& val) { return val < 0; });
+}
+
+//! Returns true if there is an element less than zero.
+template<typename T>
+bool AnyNegativeInRange(const T* data, const size_t n)
+{
+	using Vectorizable = std::integral_constant<bool,
+		simd::IsVectorizable<T>::value && std::is_signed<T>::value>;
+	return AnyNegativeInRange(data, n, Vectorizable());
+}
+
+template<typename T>
+size_t CountRowMinimums(const T* above, const T* row, const T* below, const size_t n, std::true_type)
+{
+	return simd::CountLocalMinimums(above, row, below, n);
+}
+
+template<typename T>
+size_t CountRowMinimums(const T* above, const T* row, const T* below, const size_t n, std::false_type)
+{
+	return simd::scalar::CountLocalMinimums<T>(above, row, below, n);
+}
+
+//! Returns number of local minimums among elements (0, n - 1) of the row,
+//! rows above and below it have n elements as well.
+template<typename T>
+size_t CountRowMinimums(const T* above, const T* row, const T* below, const size_t n)
+{
+	using Vectorizable = std::integral_constant<bool,
+		simd::IsVectorizable<T>::value && std::is_signed<T>::value>;
+	return CountRowMinimums(above, row, below, n, Vectorizable());
+}
+
+template<typename T>
+std::pair<size_t, size_t> LongestRunInRange(const T* data, const size_t n, std::true_type)
+{
+	return simd::LongestRun(data, n);
+}
+
+template<typename T>
+std::pair<size_t, size_t> LongestRunInRange(const T* data, const size_t n, std::false_type)
+{
+	return simd::scalar::LongestRun<T>(data, n);
+}
+
+//! Returns length and the first element of the longest run of identical neighboring elements.
+template<typename T>
+std::pair<size_t, size_t> LongestRunInRange(const T* data, const size_t n)
+{
+	return LongestRunInRange(data, n, simd::IsVectorizable<T>());
+}
+
+}	// namespace detail
+}	// namespace mtx
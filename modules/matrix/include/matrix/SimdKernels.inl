@@ -0,0 +1,162 @@
+// Generic kernels shared by all instruction sets, see Simd.h.
+// This file is included inside the namespace of every instruction set, where
+// Ops<Lane> provides vector type and operations for the lane type.
+// Scalar loops process tails which don't fill a whole vector.
+
+//! result[i] = left[i] + right[i].
+template<typename Lane, typename T>
+void Add(const T* left, const T* right, T* result, const size_t n)
+{
+	using V = Ops<Lane>;
+	size_t i = 0;
+	for (; i + V::lanes <= n; i += V::lanes) {
+		V::Store(result + i, V::Add(V::Load(left + i), V::Load(right + i)));
+	}
+	for (; i < n; ++i) {
+		result[i] = static_cast<T>(left[i] + right[i]);
+	}
+}
+
+//! result[i] = left[i] - right[i].
+template<typename Lane, typename T>
+void Subtract(const T* left, const T* right, T* result, const size_t n)
+{
+	using V = Ops<Lane>;
+	size_t i = 0;
+	for (; i + V::lanes <= n; i += V::lanes) {
+		V::Store(result + i, V::Sub(V::Load(left + i), V::Load(right + i)));
+	}
+	for (; i < n; ++i) {
+		result[i] = static_cast<T>(left[i] - right[i]);
+	}
+}
+
+//! Returns true if left[i] == right[i] for all i.
+template<typename Lane, typename T>
+bool Equal(const T* left, const T* right, const size_t n)
+{
+	using V = Ops<Lane>;
+	size_t i = 0;
+	for (; i + V::lanes <= n; i += V::lanes)
+	{
+		if (!V::AllEqual(V::Load(left + i), V::Load(right + i))) {
+			return false;
+		}
+	}
+	for (; i < n; ++i)
+	{
+		if (!(left[i] == right[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//! Returns init + sum of elements, four independent accumulators hide latency of additions.
+template<typename Lane, typename T>
+T Sum(const T* data, const size_t n, const T init)
+{
+	using V = Ops<Lane>;
+	auto acc0 = V::Zero();
+	auto acc1 = V::Zero();
+	auto acc2 = V::Zero();
+	auto acc3 = V::Zero();
+	size_t i = 0;
+	for (; i + 4 * V::lanes <= n; i += 4 * V::lanes)
+	{
+		acc0 = V::Add(acc0, V::Load(data + i));
+		acc1 = V::Add(acc1, V::Load(data + i + V::lanes));
+		acc2 = V::Add(acc2, V::Load(data + i + 2 * V::lanes));
+		acc3 = V::Add(acc3, V::Load(data + i + 3 * V::lanes));
+	}
+	for (; i + V::lanes <= n; i += V::lanes) {
+		acc0 = V::Add(acc0, V::Load(data + i));
+	}
+
+	T lanesSum[V::lanes];
+	V::Store(lanesSum, V::Add(V::Add(acc0, acc1), V::Add(acc2, acc3)));
+	T sum = init;
+	for (size_t l = 0; l < V::lanes; ++l) {
+		sum += lanesSum[l];
+	}
+	for (; i < n; ++i) {
+		sum += data[i];
+	}
+
+	return sum;
+}
+
+//! Returns true if there is an element less than zero.
+template<typename Lane, typename T>
+bool AnyNegative(const T* data, const size_t n)
+{
+	using V = Ops<Lane>;
+	size_t i = 0;
+	for (; i + V::lanes <= n; i += V::lanes)
+	{
+		if (V::AnyNegative(V::Load(data + i))) {
+			return true;
+		}
+	}
+	for (; i < n; ++i)
+	{
+		if (data[i] < 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//! Returns number of elements row[i], 0 < i < n - 1, less than all eight neighbors.
+//! Masks of eight comparisons are combined, so there are no branches per element.
+template<typename Lane, typename T>
+size_t CountLocalMinimums(const T* above, const T* row, const T* below, const size_t n)
+{
+	using V = Ops<Lane>;
+	size_t count = 0;
+	size_t i = 1;
+	for (; i + V::lanes < n; i += V::lanes)
+	{
+		const auto center = V::Load(row + i);
+		auto mask = V::And(
+			V::NotLessEqual(V::Load(row + i - 1), center),
+			V::NotLessEqual(V::Load(row + i + 1), center));
+		mask = V::And(mask, V::And(
+			V::NotLessEqual(V::Load(above + i - 1), center),
+			V::NotLessEqual(V::Load(below + i - 1), center)));
+		mask = V::And(mask, V::And(
+			V::NotLessEqual(V::Load(above + i), center),
+			V::NotLessEqual(V::Load(below + i), center)));
+		mask = V::And(mask, V::And(
+			V::NotLessEqual(V::Load(above + i + 1), center),
+			V::NotLessEqual(V::Load(below + i + 1), center)));
+		count += V::CountMask(mask);
+	}
+
+	// The tail starts one element before i, since the scalar kernel checks elements after the first.
+	return count + scalar::CountLocalMinimums<Lane>(above + i - 1, row + i - 1, below + i - 1, n - i + 1);
+}
+
+//! Returns length and the first element of the longest run of identical elements.
+//! Neighbors are compared by whole vectors, masks of 64 pairs are scanned for boundaries of runs.
+template<typename Lane, typename T>
+std::pair<size_t, size_t> LongestRun(const T* data, const size_t n)
+{
+	using V = Ops<Lane>;
+	detail::RunScanner scanner;
+	const size_t pairs = n > 0 ? n - 1 : 0;
+	size_t i = 0;
+	for (; i + 64 <= pairs; i += 64)
+	{
+		std::uint64_t equal = 0;
+		for (size_t l = 0; l < 64; l += V::lanes) {
+			equal |= static_cast<std::uint64_t>(V::EqualBits(V::Load(data + i + l), V::Load(data + i + l + 1))) << l;
+		}
+		scanner.Consume(equal, 64);
+	}
+	scanner.Consume(detail::EqualNeighbors(data + i, pairs - i), pairs - i);
+
+	return scanner.Finish();
+}
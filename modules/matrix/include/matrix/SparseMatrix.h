@@ -0,0 +1,518 @@
+#pragma once
+
+#include "matrix/Allocator.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mtx
+{
+
+//! Element of a sparse matrix in the coordinate (COO) format.
+template<typename T>
+struct Triplet
+{
+	size_t row_ = { 0 };
+	size_t column_ = { 0 };
+	T value_ = {};
+};
+
+//! Sparse matrix in the compressed sparse row (CSR) format: only non-zero elements are stored,
+//! row by row in order of columns. Elements of the row r are [GetRowOffsets()[r], GetRowOffsets()[r + 1])
+//! of GetColumnIndices() and GetValues(). Zero elements are never stored, so memory and time
+//! of operations scale with the number of non-zeros.
+template<typename T>
+class SparseMatrix2D
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor.
+	SparseMatrix2D() = default;
+	//! Constructor, all elements are zeros.
+	SparseMatrix2D(const size_t rows, const size_t columns);
+	//! Constructor from the coordinate format, triplets may follow in any order,
+	//! values of duplicate triplets are summed.
+	SparseMatrix2D(const size_t rows, const size_t columns, const std::vector<Triplet<T>>& triplets);
+	//! Constructor, stores non-zero elements of the dense matrix.
+	explicit SparseMatrix2D(const Matrix2DView<const T>& view);
+	template<typename Alloc>
+	explicit SparseMatrix2D(const Matrix2D<T, Alloc>& mat);
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of rows.
+	size_t GetRows() const noexcept;
+	//! Returns number of columns.
+	size_t GetColumns() const noexcept;
+	//! Returns number of stored (non-zero) elements.
+	size_t GetNonZeros() const noexcept;
+	//! Returns offsets of rows in the arrays of columns and values, it has GetRows() + 1 elements.
+	const std::vector<size_t>& GetRowOffsets() const noexcept;
+	//! Returns columns of stored elements.
+	const std::vector<size_t>& GetColumnIndices() const noexcept;
+	//! Returns values of stored elements.
+	const std::vector<T>& GetValues() const noexcept;
+	//! Returns the element, zero if it isn't stored. Takes logarithmic time of the row length.
+	T operator()(const size_t row, const size_t column) const;
+	//! Returns pointer to the stored element or nullptr if the element is zero.
+	const T* Find(const size_t row, const size_t column) const;
+	//! Returns stored elements in the coordinate format, sorted by rows and columns.
+	std::vector<Triplet<T>> ToTriplets() const;
+	//! Returns the dense matrix.
+	template<typename Alloc = AlignedAllocator<T>>
+	Matrix2D<T, Alloc> ToDense(const Alloc& alloc = Alloc()) const;
+	//! Builds the matrix from rows which are already in the CSR format, used by operations
+	//! producing sparse results. Columns of every row must be sorted and values non-zero.
+	static SparseMatrix2D FromCompressedRows(
+		const size_t rows,
+		const size_t columns,
+		std::vector<size_t> rowOffsets,
+		std::vector<size_t> columnIndices,
+		std::vector<T> values);
+
+	//
+	// Private data members.
+	//
+private:
+	//! Number of rows.
+	size_t rows_ = { 0 };
+	//! Number of columns.
+	size_t columns_ = { 0 };
+	//! Offsets of rows, the first one is zero and the last one is number of stored elements.
+	std::vector<size_t> rowOffsets_ = { 0 };
+	//! Columns of stored elements.
+	std::vector<size_t> columnIndices_;
+	//! Values of stored elements.
+	std::vector<T> values_;
+};
+
+template<typename T>
+SparseMatrix2D<T>::SparseMatrix2D(const size_t rows, const size_t columns)
+	: rows_{ rows }
+	, columns_{ columns }
+	, rowOffsets_(rows + 1, 0)
+{
+}
+
+template<typename T>
+SparseMatrix2D<T>::SparseMatrix2D(const size_t rows, const size_t columns, const std::vector<Triplet<T>>& triplets)
+	: SparseMatrix2D(rows, columns)
+{
+	// Counting sort by rows keeps construction linear in the number of triplets.
+	for (const auto& triplet : triplets)
+	{
+		if (triplet.row_ >= rows || triplet.column_ >= columns) {
+			throw std::out_of_range("SparseMatrix2D: element is out of range.");
+		}
+		++rowOffsets_[triplet.row_ + 1];
+	}
+	for (size_t r = 0; r < rows; ++r) {
+		rowOffsets_[r + 1] += rowOffsets_[r];
+	}
+
+	std::vector<size_t> next(rowOffsets_.begin(), rowOffsets_.end() - 1);
+	std::vector<std::pair<size_t, T>> elements(triplets.size());
+	for (const auto& triplet : triplets) {
+		elements[next[triplet.row_]++] = std::make_pair(triplet.column_, triplet.value_);
+	}
+
+	columnIndices_.reserve(triplets.size());
+	values_.reserve(triplets.size());
+	size_t stored = 0;
+	for (size_t r = 0; r < rows; ++r)
+	{
+		const auto rowBegin = elements.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[r]);
+		const auto rowEnd = elements.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[r + 1]);
+		std::stable_sort(rowBegin, rowEnd, [] (const std::pair<size_t, T>& l, const std::pair<size_t, T>& r)
+		{
+			return l.first < r.first;
+		});
+
+		for (auto it = rowBegin; it != rowEnd;)
+		{
+			const size_t column = it->first;
+			T value = it->second;
+			for (++it; it != rowEnd && it->first == column; ++it) {
+				value += it->second;
+			}
+			if (!(value == T()))
+			{
+				columnIndices_.push_back(column);
+				values_.push_back(value);
+			}
+		}
+		rowOffsets_[r] = stored;
+		stored = values_.size();
+	}
+	rowOffsets_[rows] = stored;
+}
+
+template<typename T>
+SparseMatrix2D<T>::SparseMatrix2D(const Matrix2DView<const T>& view)
+	: SparseMatrix2D(view.GetRows(), view.GetColumns())
+{
+	for (size_t r = 0; r < rows_; ++r)
+	{
+		for (size_t c = 0; c < columns_; ++c)
+		{
+			const T& value = view(r, c);
+			if (!(value == T()))
+			{
+				columnIndices_.push_back(c);
+				values_.push_back(value);
+			}
+		}
+		rowOffsets_[r + 1] = values_.size();
+	}
+}
+
+template<typename T>
+template<typename Alloc>
+SparseMatrix2D<T>::SparseMatrix2D(const Matrix2D<T, Alloc>& mat)
+	: SparseMatrix2D(mat.GetView())
+{
+}
+
+template<typename T>
+size_t SparseMatrix2D<T>::GetRows() const noexcept
+{
+	return rows_;
+}
+
+template<typename T>
+size_t SparseMatrix2D<T>::GetColumns() const noexcept
+{
+	return columns_;
+}
+
+template<typename T>
+size_t SparseMatrix2D<T>::GetNonZeros() const noexcept
+{
+	return values_.size();
+}
+
+template<typename T>
+const std::vector<size_t>& SparseMatrix2D<T>::GetRowOffsets() const noexcept
+{
+	return rowOffsets_;
+}
+
+template<typename T>
+const std::vector<size_t>& SparseMatrix2D<T>::GetColumnIndices() const noexcept
+{
+	return columnIndices_;
+}
+
+template<typename T>
+const std::vector<T>& SparseMatrix2D<T>::GetValues() const noexcept
+{
+	return values_;
+}
+
+template<typename T>
+T SparseMatrix2D<T>::operator()(const size_t row, const size_t column) const
+{
+	const T* element = Find(row, column);
+	return element != nullptr ? *element : T();
+}
+
+template<typename T>
+const T* SparseMatrix2D<T>::Find(const size_t row, const size_t column) const
+{
+	const auto begin = columnIndices_.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[row]);
+	const auto end = columnIndices_.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[row + 1]);
+	const auto it = std::lower_bound(begin, end, column);
+	if (it == end || *it != column) {
+		return nullptr;
+	}
+
+	return &values_[static_cast<size_t>(it - columnIndices_.begin())];
+}
+
+template<typename T>
+std::vector<Triplet<T>> SparseMatrix2D<T>::ToTriplets() const
+{
+	std::vector<Triplet<T>> triplets;
+	triplets.reserve(values_.size());
+	for (size_t r = 0; r < rows_; ++r)
+	{
+		for (size_t i = rowOffsets_[r]; i < rowOffsets_[r + 1]; ++i) {
+			triplets.push_back(Triplet<T>{ r, columnIndices_[i], values_[i] });
+		}
+	}
+
+	return triplets;
+}
+
+template<typename T>
+template<typename Alloc>
+Matrix2D<T, Alloc> SparseMatrix2D<T>::ToDense(const Alloc& alloc) const
+{
+	Matrix2D<T, Alloc> mat(rows_, columns_, T(), alloc);
+	for (size_t r = 0; r < rows_; ++r)
+	{
+		for (size_t i = rowOffsets_[r]; i < rowOffsets_[r + 1]; ++i) {
+			mat(r, columnIndices_[i]) = values_[i];
+		}
+	}
+
+	return mat;
+}
+
+template<typename T>
+SparseMatrix2D<T> SparseMatrix2D<T>::FromCompressedRows(
+	const size_t rows,
+	const size_t columns,
+	std::vector<size_t> rowOffsets,
+	std::vector<size_t> columnIndices,
+	std::vector<T> values)
+{
+	if (rowOffsets.size() != rows + 1 || rowOffsets.back() != values.size() || columnIndices.size() != values.size()) {
+		throw std::length_error("SparseMatrix2D::FromCompressedRows: sizes of arrays don't match.");
+	}
+
+	SparseMatrix2D mat;
+	mat.rows_ = rows;
+	mat.columns_ = columns;
+	mat.rowOffsets_ = std::move(rowOffsets);
+	mat.columnIndices_ = std::move(columnIndices);
+	mat.values_ = std::move(values);
+
+	return mat;
+}
+
+template<typename T>
+bool operator==(const SparseMatrix2D<T>& left, const SparseMatrix2D<T>& right)
+{
+	// Representation is unique: columns are sorted and zeros aren't stored.
+	return left.GetRows() == right.GetRows()
+		&& left.GetColumns() == right.GetColumns()
+		&& left.GetRowOffsets() == right.GetRowOffsets()
+		&& left.GetColumnIndices() == right.GetColumnIndices()
+		&& left.GetValues() == right.GetValues();
+}
+
+template<typename T>
+bool operator!=(const SparseMatrix2D<T>& left, const SparseMatrix2D<T>& right)
+{
+	return !(left == right);
+}
+
+namespace detail
+{
+
+//! Returns result(r, c) = func(left(r, c), right(r, c)) computed for elements stored
+//! in any of the matrices only, func(0, 0) must be zero.
+template<typename T, typename BinaryOp>
+SparseMatrix2D<T> MergeSparse(
+	const SparseMatrix2D<T>& left,
+	const SparseMatrix2D<T>& right,
+	BinaryOp func,
+	const char* function)
+{
+	if (left.GetRows() != right.GetRows() || left.GetColumns() != right.GetColumns()) {
+		throw std::length_error(std::string(function) + ": sizes of matrices don't match.");
+	}
+
+	const auto& leftOffsets = left.GetRowOffsets();
+	const auto& leftColumns = left.GetColumnIndices();
+	const auto& leftValues = left.GetValues();
+	const auto& rightOffsets = right.GetRowOffsets();
+	const auto& rightColumns = right.GetColumnIndices();
+	const auto& rightValues = right.GetValues();
+
+	std::vector<size_t> offsets(left.GetRows() + 1, 0);
+	std::vector<size_t> columns;
+	std::vector<T> values;
+	columns.reserve(left.GetNonZeros() + right.GetNonZeros());
+	values.reserve(left.GetNonZeros() + right.GetNonZeros());
+	const auto append = [&columns, &values] (const size_t column, const T& value)
+	{
+		if (!(value == T()))
+		{
+			columns.push_back(column);
+			values.push_back(value);
+		}
+	};
+
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		size_t i = leftOffsets[r];
+		size_t j = rightOffsets[r];
+		while (i < leftOffsets[r + 1] || j < rightOffsets[r + 1])
+		{
+			const bool takeLeft = j == rightOffsets[r + 1]
+				|| (i < leftOffsets[r + 1] && leftColumns[i] < rightColumns[j]);
+			const bool takeRight = i == leftOffsets[r + 1]
+				|| (j < rightOffsets[r + 1] && rightColumns[j] < leftColumns[i]);
+			if (takeLeft)
+			{
+				append(leftColumns[i], func(leftValues[i], T()));
+				++i;
+			}
+			else if (takeRight)
+			{
+				append(rightColumns[j], func(T(), rightValues[j]));
+				++j;
+			}
+			else
+			{
+				append(leftColumns[i], func(leftValues[i], rightValues[j]));
+				++i;
+				++j;
+			}
+		}
+		offsets[r + 1] = values.size();
+	}
+
+	return SparseMatrix2D<T>::FromCompressedRows(
+		left.GetRows(),
+		left.GetColumns(),
+		std::move(offsets),
+		std::move(columns),
+		std::move(values));
+}
+
+}	// namespace detail
+
+//! Returns sum of sparse matrices.
+template<typename T>
+SparseMatrix2D<T> operator+(const SparseMatrix2D<T>& left, const SparseMatrix2D<T>& right)
+{
+	return detail::MergeSparse(left, right, std::plus<T>(), "operator+");
+}
+
+//! Returns difference of sparse matrices.
+template<typename T>
+SparseMatrix2D<T> operator-(const SparseMatrix2D<T>& left, const SparseMatrix2D<T>& right)
+{
+	return detail::MergeSparse(left, right, std::minus<T>(), "operator-");
+}
+
+//! Writes product of the sparse and the dense matrices into the storage viewed by result,
+//! rows of the result are computed according to the execution policy.
+//! Result must not overlap with the right matrix.
+template<typename Policy, typename T, typename R, typename O>
+detail::EnableIfPolicy<Policy, void> Multiply(
+	const Policy& policy,
+	const SparseMatrix2D<T>& left,
+	const Matrix2DView<R>& right,
+	const Matrix2DView<O>& result)
+{
+	bool sizesMismatch =
+		left.GetColumns() != right.GetRows()
+		|| left.GetRows() != result.GetRows()
+		|| right.GetColumns() != result.GetColumns();
+
+	if (sizesMismatch) {
+		throw std::length_error("Multiply: sizes of matrices don't match.");
+	}
+
+	const auto& offsets = left.GetRowOffsets();
+	const auto& columns = left.GetColumnIndices();
+	const auto& values = left.GetValues();
+	const size_t resultColumns = result.GetColumns();
+	// Blocks have similar numbers of multiplications when non-zeros are spread evenly.
+	const size_t averageWork = left.GetRows() == 0 ? 1 : left.GetNonZeros() * resultColumns / left.GetRows();
+	detail::ParallelFor(
+		policy,
+		0,
+		left.GetRows(),
+		detail::RowsPerBlock(std::max<size_t>(averageWork, 1)),
+		[&] (const size_t first, const size_t last)
+		{
+			for (size_t r = first; r < last; ++r)
+			{
+				const auto resultRow = result.Row(r);
+				std::fill(resultRow.Begin(), resultRow.End(), O());
+				// Row of the result accumulates rows of the right matrix scaled by the stored elements.
+				for (size_t i = offsets[r]; i < offsets[r + 1]; ++i)
+				{
+					const auto rightRow = right.Row(columns[i]);
+					const T& value = values[i];
+					auto out = resultRow.Begin();
+					for (auto it = rightRow.Begin(); it != rightRow.End(); ++it, ++out) {
+						*out += value * *it;
+					}
+				}
+			}
+		});
+}
+
+//! Writes product of the sparse and the dense matrices into the storage viewed by result.
+template<typename T, typename R, typename O>
+void Multiply(const SparseMatrix2D<T>& left, const Matrix2DView<R>& right, const Matrix2DView<O>& result)
+{
+	Multiply(execution::seq, left, right, result);
+}
+
+//! Returns product of the sparse and the dense matrices, it takes time
+//! proportional to the number of non-zeros times number of columns of the result.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> Multiply(const SparseMatrix2D<T>& left, const Matrix2D<T, Alloc>& right)
+{
+	if (left.GetColumns() != right.GetRows()) {
+		throw std::length_error("Multiply: sizes of matrices don't match.");
+	}
+
+	Matrix2D<T, Alloc> resultMat(
+		typename Matrix2D<T, Alloc>::Dimension{ left.GetRows(), right.GetColumns() },
+		right.GetRowPadding(),
+		uninitialized,
+		right.GetAllocator());
+	Multiply(execution::seq, left, right.GetView(), resultMat.GetView());
+
+	return resultMat;
+}
+
+//! Returns product of the sparse and the dense matrices.
+template<typename T, typename Alloc>
+Matrix2D<T, Alloc> operator*(const SparseMatrix2D<T>& left, const Matrix2D<T, Alloc>& right)
+{
+	return Multiply(left, right);
+}
+
+//! Returns product of the sparse matrix and the column vector.
+template<typename T>
+std::vector<T> Multiply(const SparseMatrix2D<T>& left, const std::vector<T>& vec)
+{
+	if (left.GetColumns() != vec.size()) {
+		throw std::length_error("Multiply: sizes of the matrix and the vector don't match.");
+	}
+
+	const auto& offsets = left.GetRowOffsets();
+	const auto& columns = left.GetColumnIndices();
+	const auto& values = left.GetValues();
+	std::vector<T> result(left.GetRows(), T());
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		T sum = T();
+		for (size_t i = offsets[r]; i < offsets[r + 1]; ++i) {
+			sum += values[i] * vec[columns[i]];
+		}
+		result[r] = sum;
+	}
+
+	return result;
+}
+
+//! Returns product of the sparse matrix and the column vector.
+template<typename T>
+std::vector<T> operator*(const SparseMatrix2D<T>& left, const std::vector<T>& vec)
+{
+	return Multiply(left, vec);
+}
+
+}	// namespace mtx
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "matrix/BinaryFormat.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/MatrixView.h"
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace mtx
+{
+namespace streaming
+{
+
+//! Number of rows in the band by default.
+constexpr size_t defaultBandRows = 1024;
+
+//! Part of the matrix read from the file.
+template<typename T>
+struct Band
+{
+	//! Rows of the band with halo rows above and below it.
+	Matrix2DView<const T> view_;
+	//! Number of the first row of the band in the matrix.
+	size_t firstRow_ = { 0 };
+	//! Number of halo rows above the band, so rows of the band are
+	//! [haloTop_, haloTop_ + rows_) of the view.
+	size_t haloTop_ = { 0 };
+	//! Number of rows of the band.
+	size_t rows_ = { 0 };
+};
+
+//! Reads the matrix saved in the binary format by bands of rows, see BinaryFormat.h.
+//! Only two bands are kept in the memory: the current one and the next one, which is read
+//! by a background thread while the current band is processed. Every band may be surrounded
+//! by halo rows of the neighboring bands for algorithms looking at neighbors of elements.
+template<typename T>
+class BandStream
+{
+	//
+	// Construction and destruction.
+	//
+public:
+	//! Constructor, opens the file and reads its header.
+	BandStream(const std::string& path, const size_t bandRows = defaultBandRows, const size_t halo = 0);
+	//! Destructor, waits for the background read.
+	~BandStream() noexcept;
+	BandStream(const BandStream&) = delete;
+	BandStream& operator=(const BandStream&) = delete;
+
+	//
+	// Public interface.
+	//
+public:
+	//! Returns number of rows of the matrix.
+	size_t GetRows() const noexcept;
+	//! Returns number of columns of the matrix.
+	size_t GetColumns() const noexcept;
+	//! Returns padding of rows of the saved matrix.
+	RowPadding GetRowPadding() const noexcept;
+	//! Makes the next band current and starts reading of the following one,
+	//! returns false if there are no more bands.
+	bool Next();
+	//! Returns the current band, it is valid until the next call of Next.
+	const Band<T>& GetBand() const noexcept;
+
+	//
+	// Private methods.
+	//
+private:
+	//! Reads band starting at the row firstRow with its halo rows into the buffer.
+	Band<T> ReadBand(Matrix2D<T>& buffer, const size_t firstRow);
+
+	//
+	// Private data members.
+	//
+private:
+	//! File with the matrix.
+	std::ifstream file_;
+	//! Header of the file in native byte order.
+	BinaryHeader header_;
+	//! True if elements are stored in the foreign byte order.
+	bool swapped_ = { false };
+	//! Number of rows in a band.
+	size_t bandRows_;
+	//! Number of halo rows on every side of the band.
+	size_t halo_;
+	//! Buffers of the current and the next bands.
+	Matrix2D<T> current_;
+	Matrix2D<T> next_;
+	//! The current band.
+	Band<T> band_;
+	//! True if the first band is read.
+	bool started_ = { false };
+	//! Result of the background read of the next band.
+	std::future<Band<T>> prefetch_;
+};
+
+template<typename T>
+BandStream<T>::BandStream(const std::string& path, const size_t bandRows, const size_t halo)
+	: file_(path, std::ios::binary)
+	, bandRows_{ std::max<size_t>(bandRows, 1) }
+	, halo_{ halo }
+{
+	if (!file_) {
+		throw std::runtime_error("BandStream: file can't be opened.");
+	}
+
+	swapped_ = ReadBinaryHeader(file_, header_);
+	detail::CheckBinaryHeader<T>(header_, "BandStream");
+
+	const typename Matrix2D<T>::Dimension bufferSize{
+		std::min(bandRows_, GetRows()) + 2 * halo_,
+		GetColumns() };
+	current_ = Matrix2D<T>(bufferSize, GetRowPadding(), uninitialized);
+	next_ = Matrix2D<T>(bufferSize, GetRowPadding(), uninitialized);
+}
+
+template<typename T>
+BandStream<T>::~BandStream() noexcept
+{
+	if (prefetch_.valid()) {
+		prefetch_.wait();
+	}
+}
+
+template<typename T>
+size_t BandStream<T>::GetRows() const noexcept
+{
+	return static_cast<size_t>(header_.rows_);
+}
+
+template<typename T>
+size_t BandStream<T>::GetColumns() const noexcept
+{
+	return static_cast<size_t>(header_.columns_);
+}
+
+template<typename T>
+RowPadding BandStream<T>::GetRowPadding() const noexcept
+{
+	return RowPadding{ header_.rowPadding_ };
+}
+
+template<typename T>
+bool BandStream<T>::Next()
+{
+	if (!started_)
+	{
+		started_ = true;
+		if (GetRows() == 0) {
+			return false;
+		}
+		band_ = ReadBand(current_, 0);
+	}
+	else
+	{
+		if (!prefetch_.valid()) {
+			return false;
+		}
+		// Swap keeps storage of buffers, so the band still views the elements it was read to.
+		band_ = prefetch_.get();
+		std::swap(current_, next_);
+	}
+
+	const size_t nextRow = band_.firstRow_ + band_.rows_;
+	if (nextRow < GetRows())
+	{
+		prefetch_ = std::async(std::launch::async, [this, nextRow] ()
+		{
+			return ReadBand(next_, nextRow);
+		});
+	}
+
+	return true;
+}
+
+template<typename T>
+const Band<T>& BandStream<T>::GetBand() const noexcept
+{
+	return band_;
+}
+
+template<typename T>
+Band<T> BandStream<T>::ReadBand(Matrix2D<T>& buffer, const size_t firstRow)
+{
+	const size_t rows = std::min(bandRows_, GetRows() - firstRow);
+	const size_t haloTop = std::min(halo_, firstRow);
+	const size_t haloBottom = std::min(halo_, GetRows() - firstRow - rows);
+	const size_t count = haloTop + rows + haloBottom;
+	const size_t rowBytes = buffer.GetRowStride() * sizeof(T);
+
+	file_.seekg(static_cast<std::streamoff>(header_.dataOffset_ + (firstRow - haloTop) * rowBytes));
+	if (!file_.read(reinterpret_cast<char*>(buffer.GetView().Data()), static_cast<std::streamsize>(count * rowBytes))) {
+		throw std::runtime_error("BandStream: unexpected end of the file.");
+	}
+
+	if (swapped_) {
+		std::for_each(buffer.Begin(), buffer.Begin() + count * buffer.GetRowStride(), [] (T& value)
+		{
+			detail::SwapBytes(value);
+		});
+	}
+
+	return Band<T>{ buffer.BlockView(0, 0, count, GetColumns()), firstRow, haloTop, rows };
+}
+
+//! Analyses of Matrix2DAdapter applied to the matrix saved in the binary format which
+//! may be bigger than the memory. Memory usage is bounded by two bands of bandRows rows,
+//! results are equal to the ones of the matrix loaded to the memory.
+
+//! Returns number of local minimums, bands are read with one row of halo on each side.
+template<typename T>
+int CountLocalMinimums(const std::string& path, const size_t bandRows = defaultBandRows)
+{
+	BandStream<T> stream(path, bandRows, 1);
+	int counter = 0;
+	while (stream.Next())
+	{
+		const auto& band = stream.GetBand();
+		counter += Matrix2DAdapter<T>::CountLocalMinimums(band.view_, band.haloTop_, band.haloTop_ + band.rows_);
+	}
+
+	return counter;
+}
+
+//! Returns number of row with longest set of identical elements.
+//! Returns -1 if matrix is empty.
+template<typename T>
+int LongestIdenticalSet(const std::string& path, const size_t bandRows = defaultBandRows)
+{
+	BandStream<T> stream(path, bandRows);
+	if (stream.GetRows() == 0) {
+		return -1;
+	}
+
+	size_t longestSet = 1;
+	size_t number = 0;
+	while (stream.Next())
+	{
+		const auto& band = stream.GetBand();
+		const auto longest = Matrix2DAdapter<T>::LongestIdenticalSet(band.view_, 0, band.rows_);
+		if (longest.first > longestSet)
+		{
+			longestSet = longest.first;
+			number = band.firstRow_ + longest.second;
+		}
+	}
+
+	return static_cast<int>(number);
+}
+
+//! Calculates multiplication of elements in rows with all non negative elements.
+template<typename T>
+T NonNegativeRowsMultiplication(const std::string& path, const size_t bandRows = defaultBandRows)
+{
+	BandStream<T> stream(path, bandRows);
+	T multiplication = 1;
+	while (stream.Next())
+	{
+		const auto& band = stream.GetBand();
+		multiplication =
+			Matrix2DAdapter<T>::NonNegativeRowsMultiplication(band.view_, 0, band.rows_, multiplication);
+	}
+
+	return multiplication;
+}
+
+//! Calculates sum of elements situated over the main diagonal.
+//! Bands below the last row crossing the diagonal aren't read.
+template<typename T>
+T SumOverMainDiagonal(const std::string& path, const size_t bandRows = defaultBandRows)
+{
+	BandStream<T> stream(path, bandRows);
+	const size_t rows = stream.GetRows();
+	const size_t columns = stream.GetColumns();
+	if (rows == 0 || columns == 0 || !stream.Next()) {
+		return 0;
+	}
+	if (rows == 1 || columns == 1) {
+		return stream.GetBand().view_(0, 0);
+	}
+
+	const size_t diagonalRows = std::min(rows, columns - 1);
+	T sumVal = 0;
+	do
+	{
+		const auto& band = stream.GetBand();
+		if (band.firstRow_ >= diagonalRows) {
+			break;
+		}
+		// Block starts at the diagonal element of the first row of the band,
+		// so its row i has elements to sum to the right of its column i.
+		const auto block = band.view_.Block(0, band.firstRow_, band.rows_, columns - band.firstRow_);
+		const size_t blockRows = std::min(band.rows_, diagonalRows - band.firstRow_);
+		sumVal = Matrix2DAdapter<T>::SumOverMainDiagonal(block, 0, blockRows, sumVal);
+	}
+	while (stream.Next());
+
+	return sumVal;
+}
+
+//! Writes file of the matrix result(r, c) = func(left(r, c), right(r, c)) for matrices
+//! saved in files, the result keeps padding of rows of the left matrix.
+//! Only bands of rows are kept in the memory.
+template<typename T, typename BinaryOp>
+void TransformMatrices(
+	const std::string& leftPath,
+	const std::string& rightPath,
+	const std::string& resultPath,
+	BinaryOp func,
+	const size_t bandRows = defaultBandRows)
+{
+	BandStream<T> left(leftPath, bandRows);
+	BandStream<T> right(rightPath, bandRows);
+	const size_t rows = left.GetRows();
+	const size_t columns = left.GetColumns();
+	if (rows != right.GetRows() || columns != right.GetColumns()) {
+		throw std::length_error("TransformMatrices: sizes of matrices don't match.");
+	}
+
+	std::ofstream output(resultPath, std::ios::binary | std::ios::trunc);
+	if (!output) {
+		throw std::runtime_error("TransformMatrices: file can't be opened.");
+	}
+	const auto header = detail::MakeBinaryHeader<T>(rows, columns, left.GetRowPadding());
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	Matrix2D<T> result(
+		typename Matrix2D<T>::Dimension{ std::min(std::max<size_t>(bandRows, 1), rows), columns },
+		left.GetRowPadding(),
+		uninitialized);
+	while (left.Next() && right.Next())
+	{
+		const size_t bandSize = left.GetBand().rows_;
+		mtx::TransformMatrices(
+			left.GetBand().view_,
+			right.GetBand().view_,
+			result.BlockView(0, 0, bandSize, columns),
+			func);
+		output.write(
+			reinterpret_cast<const char*>(result.GetView().Data()),
+			static_cast<std::streamsize>(bandSize * result.GetRowStride() * sizeof(T)));
+	}
+
+	if (!output) {
+		throw std::runtime_error("TransformMatrices: failed to write the result.");
+	}
+}
+
+}	// namespace streaming
+}	// namespace mtx
@@ -0,0 +1,807 @@
+#pragma once
+
+#include "matrix/Allocator.h"
+#include "matrix/Matrix.h"
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mtx
+{
+namespace detail
+{
+
+//! Maximal length of a formatted element, e.g. "-1.2345678901234567e-308".
+constexpr size_t maxTextElementLength = 32;
+//! Number of blocks of rows formatted in parallel before they are written to the stream,
+//! it bounds memory used by formatted text.
+constexpr size_t textBlocksPerWrite = 64;
+//! Size of chunks in which text is read from the stream.
+constexpr size_t textReadChunk = size_t{ 1 } << 20;
+
+//! Checks that elements of type T are supported by the text format.
+template<typename T>
+constexpr bool IsTextElement() noexcept
+{
+	return (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+		|| std::is_same<T, float>::value
+		|| std::is_same<T, double>::value;
+}
+
+//! Writes decimal digits of the integer to out and returns pointer past the last written character.
+template<typename T>
+char* FormatInteger(const T value, char* out) noexcept
+{
+	using Unsigned = std::make_unsigned_t<T>;
+	// Negation is done in unsigned type, so the minimal value doesn't overflow.
+	Unsigned magnitude = static_cast<Unsigned>(value);
+	if (value < 0)
+	{
+		*out++ = '-';
+		magnitude = static_cast<Unsigned>(Unsigned(0) - magnitude);
+	}
+
+	char digits[std::numeric_limits<Unsigned>::digits10 + 1];
+	size_t length = 0;
+	do
+	{
+		digits[length++] = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+
+	std::reverse_copy(digits, digits + length, out);
+	return out + length;
+}
+
+//! Floating point number f * 2^e with 64-bit significand used by the formatting of floating point numbers.
+struct DiyFp
+{
+	std::uint64_t f_ = { 0 };
+	int e_ = { 0 };
+};
+
+//! Returns x - y, both numbers must have the same exponent and x.f_ >= y.f_.
+inline DiyFp Subtract(const DiyFp& x, const DiyFp& y) noexcept
+{
+	return DiyFp{ x.f_ - y.f_, x.e_ };
+}
+
+//! Returns x * y rounded to 64 bits of the significand.
+inline DiyFp Multiply(const DiyFp& x, const DiyFp& y) noexcept
+{
+	const std::uint64_t mask = 0xFFFFFFFFu;
+	const std::uint64_t xLow = x.f_ & mask;
+	const std::uint64_t xHigh = x.f_ >> 32;
+	const std::uint64_t yLow = y.f_ & mask;
+	const std::uint64_t yHigh = y.f_ >> 32;
+	const std::uint64_t lowLow = xLow * yLow;
+	const std::uint64_t lowHigh = xLow * yHigh;
+	const std::uint64_t highLow = xHigh * yLow;
+	const std::uint64_t highHigh = xHigh * yHigh;
+	// Middle part of the product, the last term rounds the result half up.
+	const std::uint64_t middle = (lowLow >> 32) + (lowHigh & mask) + (highLow & mask) + (std::uint64_t{ 1 } << 31);
+
+	return DiyFp{ highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32), x.e_ + y.e_ + 64 };
+}
+
+//! Shifts the significand left until its highest bit is set.
+inline DiyFp Normalize(DiyFp x) noexcept
+{
+	while ((x.f_ >> 63) == 0)
+	{
+		x.f_ <<= 1;
+		--x.e_;
+	}
+
+	return x;
+}
+
+//! Value and the boundaries of the interval of numbers which are rounded to it,
+//! the boundaries have the same exponent.
+struct FloatBoundaries
+{
+	DiyFp value_;
+	DiyFp minus_;
+	DiyFp plus_;
+};
+
+//! Returns normalized value and boundaries of the finite positive number.
+template<typename T>
+FloatBoundaries ComputeBoundaries(const T value) noexcept
+{
+	using Bits = std::conditional_t<std::is_same<T, float>::value, std::uint32_t, std::uint64_t>;
+	constexpr int precision = std::numeric_limits<T>::digits;
+	constexpr int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+	constexpr std::uint64_t hiddenBit = std::uint64_t{ 1 } << (precision - 1);
+
+	Bits bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const std::uint64_t fraction = bits & (hiddenBit - 1);
+	const std::uint64_t biasedExponent = bits >> (precision - 1);
+	const DiyFp v = biasedExponent == 0
+		? DiyFp{ fraction, 1 - bias }
+		: DiyFp{ fraction + hiddenBit, static_cast<int>(biasedExponent) - bias };
+
+	// The lower boundary is closer if the value is a power of two with the normal predecessor.
+	const bool lowerIsCloser = fraction == 0 && biasedExponent > 1;
+	const DiyFp plus = Normalize(DiyFp{ 2 * v.f_ + 1, v.e_ - 1 });
+	DiyFp minus = lowerIsCloser ? DiyFp{ 4 * v.f_ - 1, v.e_ - 2 } : DiyFp{ 2 * v.f_ - 1, v.e_ - 1 };
+	minus.f_ <<= minus.e_ - plus.e_;
+	minus.e_ = plus.e_;
+
+	return FloatBoundaries{ Normalize(v), minus, plus };
+}
+
+//! Power of ten 10^k approximated by f * 2^e.
+struct CachedPower
+{
+	std::uint64_t f_;
+	int e_;
+	int k_;
+};
+
+//! Returns the power of ten c such that the exponent of c times a number with binary
+//! exponent e lies in [-60, -32], so its integral part fits 32 bits.
+inline CachedPower GetCachedPower(const int e) noexcept
+{
+	// Powers 10^k for k = -300, -292, ..., 324 rounded to 64 bits.
+	static const CachedPower powers[] = {
+		{ 0xAB70FE17C79AC6CA, -1060, -300 },
+		{ 0xFF77B1FCBEBCDC4F, -1034, -292 },
+		{ 0xBE5691EF416BD60C, -1007, -284 },
+		{ 0x8DD01FAD907FFC3C, -980, -276 },
+		{ 0xD3515C2831559A83, -954, -268 },
+		{ 0x9D71AC8FADA6C9B5, -927, -260 },
+		{ 0xEA9C227723EE8BCB, -901, -252 },
+		{ 0xAECC49914078536D, -874, -244 },
+		{ 0x823C12795DB6CE57, -847, -236 },
+		{ 0xC21094364DFB5637, -821, -228 },
+		{ 0x9096EA6F3848984F, -794, -220 },
+		{ 0xD77485CB25823AC7, -768, -212 },
+		{ 0xA086CFCD97BF97F4, -741, -204 },
+		{ 0xEF340A98172AACE5, -715, -196 },
+		{ 0xB23867FB2A35B28E, -688, -188 },
+		{ 0x84C8D4DFD2C63F3B, -661, -180 },
+		{ 0xC5DD44271AD3CDBA, -635, -172 },
+		{ 0x936B9FCEBB25C996, -608, -164 },
+		{ 0xDBAC6C247D62A584, -582, -156 },
+		{ 0xA3AB66580D5FDAF6, -555, -148 },
+		{ 0xF3E2F893DEC3F126, -529, -140 },
+		{ 0xB5B5ADA8AAFF80B8, -502, -132 },
+		{ 0x87625F056C7C4A8B, -475, -124 },
+		{ 0xC9BCFF6034C13053, -449, -116 },
+		{ 0x964E858C91BA2655, -422, -108 },
+		{ 0xDFF9772470297EBD, -396, -100 },
+		{ 0xA6DFBD9FB8E5B88F, -369, -92 },
+		{ 0xF8A95FCF88747D94, -343, -84 },
+		{ 0xB94470938FA89BCF, -316, -76 },
+		{ 0x8A08F0F8BF0F156B, -289, -68 },
+		{ 0xCDB02555653131B6, -263, -60 },
+		{ 0x993FE2C6D07B7FAC, -236, -52 },
+		{ 0xE45C10C42A2B3B06, -210, -44 },
+		{ 0xAA242499697392D3, -183, -36 },
+		{ 0xFD87B5F28300CA0E, -157, -28 },
+		{ 0xBCE5086492111AEB, -130, -20 },
+		{ 0x8CBCCC096F5088CC, -103, -12 },
+		{ 0xD1B71758E219652C, -77, -4 },
+		{ 0x9C40000000000000, -50, 4 },
+		{ 0xE8D4A51000000000, -24, 12 },
+		{ 0xAD78EBC5AC620000, 3, 20 },
+		{ 0x813F3978F8940984, 30, 28 },
+		{ 0xC097CE7BC90715B3, 56, 36 },
+		{ 0x8F7E32CE7BEA5C70, 83, 44 },
+		{ 0xD5D238A4ABE98068, 109, 52 },
+		{ 0x9F4F2726179A2245, 136, 60 },
+		{ 0xED63A231D4C4FB27, 162, 68 },
+		{ 0xB0DE65388CC8ADA8, 189, 76 },
+		{ 0x83C7088E1AAB65DB, 216, 84 },
+		{ 0xC45D1DF942711D9A, 242, 92 },
+		{ 0x924D692CA61BE758, 269, 100 },
+		{ 0xDA01EE641A708DEA, 295, 108 },
+		{ 0xA26DA3999AEF774A, 322, 116 },
+		{ 0xF209787BB47D6B85, 348, 124 },
+		{ 0xB454E4A179DD1877, 375, 132 },
+		{ 0x865B86925B9BC5C2, 402, 140 },
+		{ 0xC83553C5C8965D3D, 428, 148 },
+		{ 0x952AB45CFA97A0B3, 455, 156 },
+		{ 0xDE469FBD99A05FE3, 481, 164 },
+		{ 0xA59BC234DB398C25, 508, 172 },
+		{ 0xF6C69A72A3989F5C, 534, 180 },
+		{ 0xB7DCBF5354E9BECE, 561, 188 },
+		{ 0x88FCF317F22241E2, 588, 196 },
+		{ 0xCC20CE9BD35C78A5, 614, 204 },
+		{ 0x98165AF37B2153DF, 641, 212 },
+		{ 0xE2A0B5DC971F303A, 667, 220 },
+		{ 0xA8D9D1535CE3B396, 694, 228 },
+		{ 0xFB9B7CD9A4A7443C, 720, 236 },
+		{ 0xBB764C4CA7A44410, 747, 244 },
+		{ 0x8BAB8EEFB6409C1A, 774, 252 },
+		{ 0xD01FEF10A657842C, 800, 260 },
+		{ 0x9B10A4E5E9913129, 827, 268 },
+		{ 0xE7109BFBA19C0C9D, 853, 276 },
+		{ 0xAC2820D9623BF429, 880, 284 },
+		{ 0x80444B5E7AA7CF85, 907, 292 },
+		{ 0xBF21E44003ACDD2D, 933, 300 },
+		{ 0x8E679C2F5E44FF8F, 960, 308 },
+		{ 0xD433179D9C8CB841, 986, 316 },
+		{ 0x9E19DB92B4E31BA9, 1013, 324 },
+	};
+
+	constexpr int alpha = -60;
+	const int f = alpha - e - 1;
+	// ceil(f * log10(2)).
+	const int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+	const auto index = static_cast<size_t>((300 + k + 7) / 8);
+
+	return powers[index];
+}
+
+//! Moves the last digit towards the value while the result stays inside the boundaries.
+inline void RoundShortest(
+	char* digits,
+	const size_t length,
+	const std::uint64_t distance,
+	const std::uint64_t delta,
+	std::uint64_t rest,
+	const std::uint64_t tenToK) noexcept
+{
+	while (rest < distance
+		&& delta - rest >= tenToK
+		&& (rest + tenToK < distance || distance - rest > rest + tenToK - distance))
+	{
+		--digits[length - 1];
+		rest += tenToK;
+	}
+}
+
+//! Writes the shortest digits of a number in [minus, plus] which is the closest to value,
+//! all numbers are scaled so that their exponent is in [-60, -32].
+//! Returns number of digits, decimalExponent is adjusted by the position of the last digit.
+inline size_t GenerateDigits(
+	char* digits,
+	int& decimalExponent,
+	const DiyFp& minus,
+	const DiyFp& value,
+	const DiyFp& plus) noexcept
+{
+	std::uint64_t delta = Subtract(plus, minus).f_;
+	std::uint64_t distance = Subtract(plus, value).f_;
+	const int shift = -plus.e_;
+	const std::uint64_t one = std::uint64_t{ 1 } << shift;
+	auto integral = static_cast<std::uint32_t>(plus.f_ >> shift);
+	std::uint64_t fractional = plus.f_ & (one - 1);
+
+	std::uint32_t power = 1000000000;
+	int integralDigits = 10;
+	while (power > integral)
+	{
+		power /= 10;
+		--integralDigits;
+	}
+
+	size_t length = 0;
+	while (integralDigits > 0)
+	{
+		digits[length++] = static_cast<char>('0' + integral / power);
+		integral %= power;
+		--integralDigits;
+		const std::uint64_t rest = (std::uint64_t{ integral } << shift) + fractional;
+		if (rest <= delta)
+		{
+			decimalExponent += integralDigits;
+			RoundShortest(digits, length, distance, delta, rest, std::uint64_t{ power } << shift);
+			return length;
+		}
+		power /= 10;
+	}
+
+	int fractionalDigits = 0;
+	for (;;)
+	{
+		fractional *= 10;
+		digits[length++] = static_cast<char>('0' + (fractional >> shift));
+		fractional &= one - 1;
+		++fractionalDigits;
+		delta *= 10;
+		distance *= 10;
+		if (fractional <= delta) {
+			break;
+		}
+	}
+	decimalExponent -= fractionalDigits;
+	RoundShortest(digits, length, distance, delta, fractional, one);
+
+	return length;
+}
+
+//! Writes short digits which are read back as the finite positive value (Grisu2, they are
+//! the shortest for almost all values). The value equals digits * 10^decimalExponent.
+//! Returns number of digits.
+template<typename T>
+size_t ShortestDigits(const T value, char* digits, int& decimalExponent) noexcept
+{
+	const auto boundaries = ComputeBoundaries(value);
+	const auto cached = GetCachedPower(boundaries.plus_.e_);
+	const DiyFp power{ cached.f_, cached.e_ };
+	const DiyFp scaledValue = Multiply(boundaries.value_, power);
+	DiyFp scaledMinus = Multiply(boundaries.minus_, power);
+	DiyFp scaledPlus = Multiply(boundaries.plus_, power);
+	// Boundaries are narrowed by the possible error of the multiplication.
+	++scaledMinus.f_;
+	--scaledPlus.f_;
+	decimalExponent = -cached.k_;
+
+	return GenerateDigits(digits, decimalExponent, scaledMinus, scaledValue, scaledPlus);
+}
+
+//! Writes the element to out and returns pointer past the last written character.
+//! Integral values of floating point elements are written as integers, other values
+//! are written with short digits which are read back exactly.
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value, char*> FormatElement(const T value, char* out) noexcept
+{
+	return FormatInteger(value, out);
+}
+
+template<typename T>
+std::enable_if_t<std::is_floating_point<T>::value, char*> FormatElement(const T value, char* out) noexcept
+{
+	const T maxExactInteger = static_cast<T>(std::uint64_t{ 1 } << std::numeric_limits<T>::digits);
+	if (std::fabs(value) < maxExactInteger && value == std::trunc(value) && !(value == 0 && std::signbit(value))) {
+		return FormatInteger(static_cast<std::int64_t>(value), out);
+	}
+	if (std::isnan(value))
+	{
+		std::memcpy(out, "nan", 3);
+		return out + 3;
+	}
+	if (std::signbit(value)) {
+		*out++ = '-';
+	}
+	if (std::isinf(value))
+	{
+		std::memcpy(out, "inf", 3);
+		return out + 3;
+	}
+	if (value == 0)
+	{
+		*out = '0';
+		return out + 1;
+	}
+
+	// Digits are placed after the room for "0.000", so they can be moved to their place.
+	char* digits = out + 6;
+	int decimalExponent = 0;
+	const auto length = static_cast<int>(ShortestDigits(std::fabs(value), digits, decimalExponent));
+	// Value is 0.digits * 10^point.
+	const int point = length + decimalExponent;
+	if (point > 0 && point <= std::numeric_limits<T>::digits10)
+	{
+		// ddd.ddd, integral values are written by the branch above.
+		std::memmove(out, digits, static_cast<size_t>(point));
+		out[point] = '.';
+		std::memmove(out + point + 1, digits + point, static_cast<size_t>(length - point));
+		return out + length + 1;
+	}
+	if (point <= 0 && point > -4)
+	{
+		// 0.000ddd
+		std::memmove(out + 2 - point, digits, static_cast<size_t>(length));
+		out[0] = '0';
+		out[1] = '.';
+		std::fill(out + 2, out + 2 - point, '0');
+		return out + 2 - point + length;
+	}
+
+	// d.ddde+xx
+	*out++ = digits[0];
+	if (length > 1)
+	{
+		*out++ = '.';
+		std::memmove(out, digits + 1, static_cast<size_t>(length - 1));
+		out += length - 1;
+	}
+	*out++ = 'e';
+	*out++ = point - 1 < 0 ? '-' : '+';
+	return FormatInteger(std::abs(point - 1), out);
+}
+
+//! Appends rows [first, last) of the view to the text, elements are separated by separator
+//! and every row ends with the new line.
+template<typename T>
+void FormatTextRows(
+	const Matrix2DView<T>& view,
+	const size_t first,
+	const size_t last,
+	const char separator,
+	std::string& text)
+{
+	const size_t columns = view.GetColumns();
+	text.resize((last - first) * (columns * (maxTextElementLength + 1) + 1));
+	char* out = &text[0];
+	for (size_t r = first; r < last; ++r)
+	{
+		const auto row = view.Row(r);
+		for (size_t c = 0; c < columns; ++c)
+		{
+			if (c != 0) {
+				*out++ = separator;
+			}
+			out = FormatElement(row[c], out);
+		}
+		*out++ = '\n';
+	}
+	text.resize(static_cast<size_t>(out - text.data()));
+}
+
+//! Returns true if the character separates elements of a row.
+inline bool IsTextSeparator(const char c) noexcept
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';';
+}
+
+//! Returns true if the character is a space inside a row.
+inline bool IsTextSpace(const char c) noexcept
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+//! Reads the integer starting at text, advances text past it.
+//! Returns false if there is no number or it doesn't fit T.
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value, bool> ParseElement(const char*& text, T& value) noexcept
+{
+	using Unsigned = std::make_unsigned_t<T>;
+	const char* p = text;
+	const bool negative = *p == '-';
+	if (*p == '-' || *p == '+') {
+		++p;
+	}
+	if (negative && !std::is_signed<T>::value) {
+		return false;
+	}
+
+	// Magnitude of the minimal signed value is one more than the maximal value.
+	const Unsigned limit = static_cast<Unsigned>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+	Unsigned magnitude = 0;
+	const char* digits = p;
+	for (; *p >= '0' && *p <= '9'; ++p)
+	{
+		const auto digit = static_cast<Unsigned>(*p - '0');
+		if (magnitude > (limit - digit) / 10) {
+			return false;
+		}
+		magnitude = static_cast<Unsigned>(magnitude * 10 + digit);
+	}
+	if (p == digits) {
+		return false;
+	}
+
+	value = negative ? static_cast<T>(Unsigned(0) - magnitude) : static_cast<T>(magnitude);
+	text = p;
+	return true;
+}
+
+//! Converts text to float or double by the C library.
+inline float ParseFloatingPoint(const char* text, char** end, float) noexcept
+{
+	return std::strtof(text, end);
+}
+
+inline double ParseFloatingPoint(const char* text, char** end, double) noexcept
+{
+	return std::strtod(text, end);
+}
+
+//! Reads the floating point number starting at text, advances text past it.
+//! Numbers with at most 19 significant digits whose mantissa and power of ten are exact in T
+//! are converted by a single multiplication or division, which rounds correctly.
+//! Other numbers, infinities and NaNs are converted by the C library.
+template<typename T>
+std::enable_if_t<std::is_floating_point<T>::value, bool> ParseElement(const char*& text, T& value) noexcept
+{
+	// Powers of ten are exact in double up to 1e22 and in float up to 1e10.
+	static const T powers[] = {
+		T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7), T(1e8), T(1e9), T(1e10), T(1e11),
+		T(1e12), T(1e13), T(1e14), T(1e15), T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22)
+	};
+	constexpr int maxPower = std::is_same<T, float>::value ? 10 : 22;
+
+	const char* p = text;
+	const bool negative = *p == '-';
+	if (*p == '-' || *p == '+') {
+		++p;
+	}
+
+	std::uint64_t mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+	for (; *p >= '0' && *p <= '9'; ++p)
+	{
+		hasDigits = true;
+		mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+		significantDigits += mantissa != 0 ? 1 : 0;
+	}
+	if (*p == '.')
+	{
+		for (++p; *p >= '0' && *p <= '9'; ++p)
+		{
+			hasDigits = true;
+			mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+			significantDigits += mantissa != 0 ? 1 : 0;
+			--exponent;
+		}
+	}
+	if (hasDigits && (*p == 'e' || *p == 'E'))
+	{
+		const char* exponentText = p + 1;
+		const bool negativeExponent = *exponentText == '-';
+		if (*exponentText == '-' || *exponentText == '+') {
+			++exponentText;
+		}
+		if (*exponentText >= '0' && *exponentText <= '9')
+		{
+			int written = 0;
+			for (; *exponentText >= '0' && *exponentText <= '9'; ++exponentText) {
+				written = std::min(written * 10 + (*exponentText - '0'), 100000);
+			}
+			exponent += negativeExponent ? -written : written;
+			p = exponentText;
+		}
+	}
+
+	const bool exact =
+		hasDigits
+		&& significantDigits <= 19
+		&& mantissa <= (std::uint64_t{ 1 } << std::numeric_limits<T>::digits)
+		&& exponent >= -maxPower
+		&& exponent <= maxPower;
+	if (exact)
+	{
+		const auto magnitude = static_cast<T>(mantissa);
+		value = exponent < 0 ? magnitude / powers[-exponent] : magnitude * powers[exponent];
+		value = negative ? -value : value;
+		text = p;
+		return true;
+	}
+
+	// The C library skips leading spaces, which are never passed here.
+	char* end = nullptr;
+	value = ParseFloatingPoint(text, &end, T());
+	if (end == text) {
+		return false;
+	}
+
+	text = end;
+	return true;
+}
+
+//! Parses elements of the line which starts at text and ends at the new line or the end
+//! of the text, calls store(index, value) for every element and returns number of elements.
+//! Elements are separated by spaces, tabs, a comma or a semicolon, a separator
+//! after the last element is allowed. Throws std::runtime_error if an element is invalid.
+template<typename T, typename Store>
+size_t ParseTextLine(const char* text, const size_t row, Store store)
+{
+	size_t count = 0;
+	for (;;)
+	{
+		while (IsTextSpace(*text)) {
+			++text;
+		}
+		if (*text == '\n' || *text == '\0') {
+			return count;
+		}
+
+		T value;
+		const bool valid = ParseElement(text, value) && (IsTextSeparator(*text) || *text == '\n' || *text == '\0');
+		if (!valid) {
+			throw std::runtime_error("LoadText: invalid element in row " + std::to_string(row) + ".");
+		}
+		store(count++, value);
+
+		while (IsTextSpace(*text)) {
+			++text;
+		}
+		if (*text == ',' || *text == ';') {
+			++text;
+		}
+	}
+}
+
+//! Reads the rest of the stream into the buffer and terminates it with zero.
+inline std::vector<char> ReadText(std::istream& stream)
+{
+	std::vector<char> text;
+	size_t size = 0;
+	for (;;)
+	{
+		text.resize(size + textReadChunk);
+		stream.read(text.data() + size, static_cast<std::streamsize>(textReadChunk));
+		size += static_cast<size_t>(stream.gcount());
+		if (!stream) {
+			break;
+		}
+	}
+	if (stream.bad()) {
+		throw std::runtime_error("LoadText: failed to read the stream.");
+	}
+
+	text.resize(size);
+	text.push_back('\0');
+	return text;
+}
+
+}	// namespace detail
+
+//! Writes matrix viewed by view to the stream as text: a line per row, elements are
+//! separated by separator. Integers are written exactly, floating point elements are written
+//! with short digits which are read back exactly. Blocks of rows are formatted according to
+//! the policy and written by large writes in order of rows.
+template<typename Policy, typename T>
+detail::EnableIfPolicy<Policy> SaveText(
+	const Policy& policy,
+	const Matrix2DView<T>& view,
+	std::ostream& stream,
+	const char separator = ',')
+{
+	static_assert(
+		detail::IsTextElement<std::remove_const_t<T>>(),
+		"Text format supports integral types except bool, float and double.");
+
+	const size_t rows = view.GetRows();
+	const size_t blockRows = detail::RowsPerBlock(view.GetColumns());
+	std::vector<std::string> blocks(detail::textBlocksPerWrite);
+	for (size_t first = 0; first < rows; first += blockRows * blocks.size())
+	{
+		const size_t last = std::min(rows, first + blockRows * blocks.size());
+		const size_t blocksNumber = (last - first + blockRows - 1) / blockRows;
+		detail::ParallelFor(policy, 0, blocksNumber, 1, [&] (const size_t firstBlock, const size_t lastBlock)
+		{
+			for (size_t b = firstBlock; b < lastBlock; ++b)
+			{
+				const size_t blockBegin = first + b * blockRows;
+				detail::FormatTextRows(view, blockBegin, std::min(blockBegin + blockRows, last), separator, blocks[b]);
+			}
+		});
+
+		for (size_t b = 0; b < blocksNumber; ++b) {
+			stream.write(blocks[b].data(), static_cast<std::streamsize>(blocks[b].size()));
+		}
+	}
+
+	if (!stream) {
+		throw std::runtime_error("SaveText: failed to write the matrix.");
+	}
+}
+
+//! Same as above, rows are formatted by the calling thread.
+template<typename T>
+void SaveText(const Matrix2DView<T>& view, std::ostream& stream, const char separator = ',')
+{
+	SaveText(execution::seq, view, stream, separator);
+}
+
+//! Writes the matrix to the file as text, the file is overwritten.
+template<typename Policy, typename T, typename Alloc>
+detail::EnableIfPolicy<Policy> SaveText(
+	const Policy& policy,
+	const Matrix2D<T, Alloc>& mat,
+	const std::string& path,
+	const char separator = ',')
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("SaveText: file can't be opened.");
+	}
+
+	SaveText(policy, mat.GetView(), file, separator);
+}
+
+//! Same as above, rows are formatted by the calling thread.
+template<typename T, typename Alloc>
+void SaveText(const Matrix2D<T, Alloc>& mat, const std::string& path, const char separator = ',')
+{
+	SaveText(execution::seq, mat, path, separator);
+}
+
+//! Reads matrix of T from the text where every non-blank line is a row, elements are separated
+//! by spaces, tabs, commas or semicolons, so CSV and whitespace separated files are accepted.
+//! All rows must have the same number of elements, otherwise std::runtime_error is thrown.
+//! The stream is read by large chunks, then blocks of rows are parsed according to the policy
+//! directly into the matrix. Integers are parsed exactly and checked for overflow, most floating
+//! point numbers are converted without the C library, others are converted in the current C locale.
+template<typename T, typename Alloc = AlignedAllocator<T>, typename Policy>
+detail::EnableIfPolicy<Policy, Matrix2D<T, Alloc>> LoadText(
+	const Policy& policy,
+	std::istream& stream,
+	const Alloc& alloc = Alloc())
+{
+	static_assert(
+		detail::IsTextElement<T>(),
+		"Text format supports integral types except bool, float and double.");
+
+	const auto text = detail::ReadText(stream);
+	const char* const begin = text.data();
+	const char* const end = begin + text.size() - 1;
+
+	// Lines are found by memchr, which is much faster than parsing, so only parsing is parallel.
+	std::vector<const char*> lines;
+	for (const char* line = begin; line < end;)
+	{
+		const void* newLine = std::memchr(line, '\n', static_cast<size_t>(end - line));
+		const char* lineEnd = newLine != nullptr ? static_cast<const char*>(newLine) : end;
+		if (std::find_if_not(line, lineEnd, detail::IsTextSpace) != lineEnd) {
+			lines.push_back(line);
+		}
+		line = lineEnd + 1;
+	}
+
+	const size_t rows = lines.size();
+	const size_t columns = rows == 0 ? 0 : detail::ParseTextLine<T>(lines[0], 0, [] (size_t, T) {});
+	Matrix2D<T, Alloc> mat(typename Matrix2D<T, Alloc>::Dimension{ rows, columns }, uninitialized, alloc);
+	const auto view = mat.GetView();
+	detail::ParallelFor(policy, 0, rows, detail::RowsPerBlock(columns), [&] (const size_t first, const size_t last)
+	{
+		for (size_t r = first; r < last; ++r)
+		{
+			T* row = view.Row(r).Data();
+			const size_t count = detail::ParseTextLine<T>(lines[r], r, [row, columns] (const size_t c, const T value)
+			{
+				if (c < columns) {
+					row[c] = value;
+				}
+			});
+			if (count != columns) {
+				throw std::runtime_error("LoadText: rows have different numbers of elements.");
+			}
+		}
+	});
+
+	return mat;
+}
+
+//! Same as above, rows are parsed by the calling thread.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+Matrix2D<T, Alloc> LoadText(std::istream& stream, const Alloc& alloc = Alloc())
+{
+	return LoadText<T, Alloc>(execution::seq, stream, alloc);
+}
+
+//! Reads matrix of T from the text file.
+template<typename T, typename Alloc = AlignedAllocator<T>, typename Policy>
+detail::EnableIfPolicy<Policy, Matrix2D<T, Alloc>> LoadText(
+	const Policy& policy,
+	const std::string& path,
+	const Alloc& alloc = Alloc())
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("LoadText: file can't be opened.");
+	}
+
+	return LoadText<T, Alloc>(policy, file, alloc);
+}
+
+//! Same as above, rows are parsed by the calling thread.
+template<typename T, typename Alloc = AlignedAllocator<T>>
+Matrix2D<T, Alloc> LoadText(const std::string& path, const Alloc& alloc = Alloc())
+{
+	return LoadText<T, Alloc>(execution::seq, path, alloc);
+}
+
+}	// namespace mtx
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "matrix/Instrumentation.h"
+#include "matrix/MatrixView.h"
+#include "matrix/Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace mtx
+{
+namespace detail
+{
+
+//! Side of blocks transposed by plain loops, a pair of blocks of doubles fits the L1 cache.
+constexpr size_t transposeBlock = 32;
+
+//! Writes result(c, r) = source(r, c) for rows [firstRow, lastRow) and columns
+//! [firstColumn, lastColumn) of the source. The range is halved along the longer side
+//! until it fits a block, so every level of the cache is used without knowing its size.
+template<typename S, typename D>
+void TransposeRange(
+	const Matrix2DView<S>& source,
+	const Matrix2DView<D>& result,
+	const size_t firstRow,
+	const size_t lastRow,
+	const size_t firstColumn,
+	const size_t lastColumn)
+{
+	const size_t rows = lastRow - firstRow;
+	const size_t columns = lastColumn - firstColumn;
+	if (rows == 0 || columns == 0) {
+		return;
+	}
+	if (rows <= transposeBlock && columns <= transposeBlock)
+	{
+		for (size_t r = firstRow; r < lastRow; ++r)
+		{
+			for (size_t c = firstColumn; c < lastColumn; ++c) {
+				result(c, r) = source(r, c);
+			}
+		}
+		return;
+	}
+
+	if (rows >= columns)
+	{
+		const size_t middle = firstRow + rows / 2;
+		TransposeRange(source, result, firstRow, middle, firstColumn, lastColumn);
+		TransposeRange(source, result, middle, lastRow, firstColumn, lastColumn);
+	}
+	else
+	{
+		const size_t middle = firstColumn + columns / 2;
+		TransposeRange(source, result, firstRow, lastRow, firstColumn, middle);
+		TransposeRange(source, result, firstRow, lastRow, middle, lastColumn);
+	}
+}
+
+//! Swaps view(r, c) with view(c, r) for rows [firstRow, lastRow) and columns
+//! [firstColumn, lastColumn), the range must lie above the main diagonal.
+template<typename T>
+void SwapTransposedRange(
+	const Matrix2DView<T>& view,
+	const size_t firstRow,
+	const size_t lastRow,
+	const size_t firstColumn,
+	const size_t lastColumn)
+{
+	const size_t rows = lastRow - firstRow;
+	const size_t columns = lastColumn - firstColumn;
+	if (rows == 0 || columns == 0) {
+		return;
+	}
+	if (rows <= transposeBlock && columns <= transposeBlock)
+	{
+		for (size_t r = firstRow; r < lastRow; ++r)
+		{
+			for (size_t c = firstColumn; c < lastColumn; ++c)
+			{
+				using std::swap;
+				swap(view(r, c), view(c, r));
+			}
+		}
+		return;
+	}
+
+	if (rows >= columns)
+	{
+		const size_t middle = firstRow + rows / 2;
+		SwapTransposedRange(view, firstRow, middle, firstColumn, lastColumn);
+		SwapTransposedRange(view, middle, lastRow, firstColumn, lastColumn);
+	}
+	else
+	{
+		const size_t middle = firstColumn + columns / 2;
+		SwapTransposedRange(view, firstRow, lastRow, firstColumn, middle);
+		SwapTransposedRange(view, firstRow, lastRow, middle, lastColumn);
+	}
+}
+
+//! Transposes the square part [first, last) x [first, last) of the view in place:
+//! both diagonal quarters are transposed and the off-diagonal ones are swapped.
+template<typename T>
+void TransposeDiagonalRange(const Matrix2DView<T>& view, const size_t first, const size_t last)
+{
+	if (last - first <= transposeBlock)
+	{
+		for (size_t r = first; r < last; ++r)
+		{
+			for (size_t c = r + 1; c < last; ++c)
+			{
+				using std::swap;
+				swap(view(r, c), view(c, r));
+			}
+		}
+		return;
+	}
+
+	const size_t middle = first + (last - first) / 2;
+	TransposeDiagonalRange(view, first, middle);
+	TransposeDiagonalRange(view, middle, last);
+	SwapTransposedRange(view, first, middle, middle, last);
+}
+
+}	// namespace detail
+
+//! Writes the transposed source into the existing storage viewed by result, result(c, r) = source(r, c).
+//! Result must have the transposed sizes of the source and must not overlap with it.
+//! Uses cache-oblivious recursive blocking, so neither reads nor writes walk the whole matrix
+//! with a large stride. Views may have arbitrary strides, so the same function copies
+//! the matrix into the other layout if result is a view of the transposed destination.
+//! Blocks of rows of the source are processed according to the policy.
+template<typename Policy, typename S, typename D>
+detail::EnableIfPolicy<Policy> Transpose(
+	const Policy& policy,
+	const Matrix2DView<S>& source,
+	const Matrix2DView<D>& result)
+{
+	if (source.GetRows() != result.GetColumns() || source.GetColumns() != result.GetRows()) {
+		throw std::length_error("Transpose: sizes of matrices don't match.");
+	}
+
+	MTX_INSTRUMENT(Transpose, 2 * source.GetRows() * source.GetColumns());
+	const size_t columns = source.GetColumns();
+	detail::ParallelFor(
+		policy,
+		0,
+		source.GetRows(),
+		std::max(detail::RowsPerBlock(columns), detail::transposeBlock),
+		[&] (const size_t first, const size_t last)
+		{
+			detail::TransposeRange(source, result, first, last, 0, columns);
+		});
+}
+
+//! Same as above, the source is transposed by the calling thread.
+template<typename S, typename D>
+void Transpose(const Matrix2DView<S>& source, const Matrix2DView<D>& result)
+{
+	Transpose(execution::seq, source, result);
+}
+
+//! Transposes the square matrix viewed by view in place, elements above and below
+//! the main diagonal are swapped by blocks which fit the cache.
+//! Blocks of rows are processed according to the policy.
+template<typename Policy, typename T>
+detail::EnableIfPolicy<Policy> TransposeInPlace(const Policy& policy, const Matrix2DView<T>& view)
+{
+	if (view.GetRows() != view.GetColumns()) {
+		throw std::length_error("TransposeInPlace: matrix isn't square.");
+	}
+
+	MTX_INSTRUMENT(Transpose, view.GetRows() * view.GetColumns());
+	// Block of rows swaps its part above the diagonal with the mirrored part below it,
+	// parts of different blocks don't intersect.
+	const size_t size = view.GetRows();
+	detail::ParallelFor(
+		policy,
+		0,
+		size,
+		std::max(detail::RowsPerBlock(size), detail::transposeBlock),
+		[&view, size] (const size_t first, const size_t last)
+		{
+			detail::TransposeDiagonalRange(view, first, last);
+			detail::SwapTransposedRange(view, first, last, last, size);
+		});
+}
+
+//! Same as above, the matrix is transposed by the calling thread.
+template<typename T>
+void TransposeInPlace(const Matrix2DView<T>& view)
+{
+	TransposeInPlace(execution::seq, view);
+}
+
+}	// namespace mtx
@@ -0,0 +1,212 @@
+#include "matrix/Allocator.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace
+{
+
+bool IsAligned(const void* ptr, const size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+//! Standard allocator which counts elements constructed through it.
+template<typename T>
+struct CountingAllocator
+{
+	using value_type = T;
+
+	CountingAllocator() = default;
+	template<typename U>
+	CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+	T* allocate(const size_t n) { return std::allocator<T>().allocate(n); }
+	void deallocate(T* ptr, const size_t n) noexcept { std::allocator<T>().deallocate(ptr, n); }
+
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args)
+	{
+		++constructed;
+		::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+	}
+
+	static size_t constructed;
+};
+
+template<typename T>
+size_t CountingAllocator<T>::constructed = 0;
+
+template<typename T, typename U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) noexcept
+{
+	return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) noexcept
+{
+	return false;
+}
+
+}	// namespace
+
+TEST_CASE("Matrix storage is aligned and may be padded", "[Allocator]")
+{
+	SECTION("Default storage is aligned to the cache line")
+	{
+		for (size_t columns = 1; columns < 10; ++columns)
+		{
+			const mtx::Matrix2D<char> mat(3, columns);
+			REQUIRE(IsAligned(&mat(0, 0), mtx::defaultAlignment));
+			REQUIRE(mat.IsContiguous());
+			REQUIRE(mat.GetRowStride() == columns);
+		}
+	}
+	SECTION("Padded rows start at aligned addresses")
+	{
+		const mtx::Matrix2D<float>::Dimension size{ 5, 17 };
+		mtx::Matrix2D<float> mat(size, mtx::SimdRowPadding<float>());
+		REQUIRE(mat.GetRowStride() == 32);
+		REQUIRE(!mat.IsContiguous());
+		for (size_t r = 0; r < mat.GetRows(); ++r) {
+			REQUIRE(IsAligned(&mat(r, 0), mtx::defaultAlignment));
+		}
+
+		for (size_t r = 0; r < mat.GetRows(); ++r)
+		{
+			for (size_t c = 0; c < mat.GetColumns(); ++c) {
+				mat(r, c) = 2.0f;
+			}
+		}
+		REQUIRE(mat == mat);
+		REQUIRE(mat.RowView(4)[16] == 2.0f);
+
+		// Results keep padding of the left operand.
+		const auto sum = mtx::TransformMatrices(mat, mat, std::plus<float>());
+		REQUIRE(sum.GetRowStride() == 32);
+		REQUIRE(sum(4, 16) == 4.0f);
+
+		mtx::Matrix2D<float> lazySum = mat + mat;
+		REQUIRE(lazySum.GetRowStride() == 17);
+		REQUIRE(lazySum == mtx::Matrix2D<float>(size, 4.0f));
+
+		const mtx::Matrix2D<float> square(mtx::Matrix2D<float>::Dimension{ 17, 3 }, 1.0f);
+		const auto product = mat * mtx::Matrix2D<float>(square);
+		REQUIRE(product(4, 2) == 34.0f);
+
+		REQUIRE(mtx::Matrix2DAdapter<float>::SumOverMainDiagonal(mat.GetView()) == 2.0f * (16 + 15 + 14 + 13 + 12));
+		REQUIRE(mtx::Matrix2DAdapter<float>::CountLocalMinimums(mat.GetView()) == 0);
+
+		const mtx::Matrix2D<float> copy = mat;
+		REQUIRE(copy.GetRowStride() == 32);
+		REQUIRE(copy == mat);
+	}
+	SECTION("Aligned allocator works with other alignments")
+	{
+		mtx::AlignedAllocator<double, 256> alloc;
+		double* ptr = alloc.allocate(7);
+		REQUIRE(IsAligned(ptr, 256));
+		alloc.deallocate(ptr, 7);
+	}
+}
+
+TEST_CASE("Matrices can live in the arena", "[Allocator]")
+{
+	using ArenaMatrix = mtx::Matrix2D<int, mtx::ArenaAllocator<int>>;
+
+	mtx::Arena arena(4096);
+	mtx::ArenaAllocator<int> alloc(arena);
+	{
+		ArenaMatrix a(10, 10, 1, alloc);
+		ArenaMatrix b(10, 10, 2, alloc);
+		REQUIRE(arena.GetUsedBytes() == 2 * 100 * sizeof(int));
+		REQUIRE(IsAligned(&a(0, 0), mtx::defaultAlignment));
+		REQUIRE(IsAligned(&b(0, 0), mtx::defaultAlignment));
+
+		// Intermediate results are allocated from the same arena.
+		const auto sum = mtx::TransformMatrices(a, b, std::plus<int>());
+		REQUIRE(sum.GetAllocator() == alloc);
+		REQUIRE(sum(9, 9) == 3);
+		REQUIRE(arena.GetUsedBytes() == 3 * 100 * sizeof(int));
+
+		ArenaMatrix moved = std::move(a);
+		REQUIRE(moved.GetAllocator() == alloc);
+		a = ArenaMatrix(2, 2, 0, alloc);
+		a = moved - b;
+		REQUIRE(a(0, 0) == -1);
+
+		// Blocks bigger than a chunk get their own chunk.
+		ArenaMatrix big(100, 100, 7, alloc);
+		REQUIRE(big(99, 99) == 7);
+	}
+	arena.Release();
+	REQUIRE(arena.GetUsedBytes() == 0);
+
+	ArenaMatrix noArena;
+	REQUIRE_THROWS_AS(ArenaMatrix(2, 2), std::bad_alloc);
+}
+
+TEST_CASE("Matrix can be constructed without initialization", "[Allocator]")
+{
+	using CountingMatrix = mtx::Matrix2D<int, CountingAllocator<int>>;
+	using Dimension = CountingMatrix::Dimension;
+
+	SECTION("Only filling constructors write elements")
+	{
+		CountingAllocator<int>::constructed = 0;
+		CountingMatrix zeros(Dimension{ 10, 10 });
+		REQUIRE(CountingAllocator<int>::constructed == 100);
+		REQUIRE(zeros(9, 9) == 0);
+
+		CountingAllocator<int>::constructed = 0;
+		CountingMatrix raw(Dimension{ 10, 10 }, mtx::uninitialized);
+		REQUIRE(CountingAllocator<int>::constructed == 0);
+		REQUIRE(raw.GetRows() == 10);
+		REQUIRE(raw.GetColumns() == 10);
+
+		// Producers of the library overwrite every element, so they don't fill the result.
+		CountingMatrix ones(Dimension{ 10, 10 }, 1);
+		CountingAllocator<int>::constructed = 0;
+		const auto sum = mtx::TransformMatrices(ones, ones, std::plus<int>());
+		const auto product = ones * ones;
+		const CountingMatrix evaluated = ones + ones;
+		REQUIRE(CountingAllocator<int>::constructed == 0);
+		REQUIRE(sum(5, 5) == 2);
+		REQUIRE(product(5, 5) == 10);
+		REQUIRE(evaluated == sum);
+	}
+
+	SECTION("Padding of uninitialized matrix is cleared")
+	{
+		mtx::Matrix2D<float> mat(
+			mtx::Matrix2D<float>::Dimension{ 5, 3 },
+			mtx::RowPadding{ 4 },
+			mtx::uninitialized);
+		REQUIRE(mat.GetRowStride() == 4);
+		for (size_t r = 0; r < mat.GetRows(); ++r) {
+			REQUIRE(mat.RowView(r).Data()[3] == 0.0f);
+		}
+	}
+
+	SECTION("First touch initialization fills rows and padding")
+	{
+		const mtx::Matrix2D<double>::Dimension size{ 300, 301 };
+		mtx::Matrix2D<double> filled(size, mtx::firstTouch, 2.5);
+		REQUIRE(filled == mtx::Matrix2D<double>(size, 2.5));
+
+		mtx::Matrix2D<double> padded(size, mtx::SimdRowPadding<double>(), mtx::firstTouch, 1.0);
+		REQUIRE(padded.GetRowStride() == 304);
+		REQUIRE(padded == mtx::Matrix2D<double>(size, 1.0));
+		REQUIRE(padded.RowView(299).Data()[303] == 0.0);
+
+		mtx::Matrix2D<double> zeros(mtx::Matrix2D<double>::Dimension{ 0, 0 }, mtx::firstTouch);
+		REQUIRE(zeros.GetRows() == 0);
+	}
+}
@@ -0,0 +1,132 @@
+#include "matrix/BatchedMatrix.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include "catch.hpp"
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+//! Returns batch of count random matrices and the same matrices as Matrix2D.
+template<typename T>
+mtx::BatchedMatrix2D<T> CreateBatch(
+	const size_t count,
+	const size_t rows,
+	const size_t columns,
+	const T low,
+	const T high,
+	std::vector<mtx::Matrix2D<T>>& matrices)
+{
+	mtx::BatchedMatrix2D<T> batch(count, rows, columns);
+	matrices.clear();
+	for (size_t b = 0; b < count; ++b)
+	{
+		mtx::Matrix2D<T> mat(rows, columns);
+		mtx::RandomizeUniform(mat.GetView(), b, low, high);
+		batch.Set(b, mat.GetView());
+		matrices.push_back(mat);
+	}
+
+	return batch;
+}
+
+}	// namespace
+
+TEST_CASE("Batch keeps matrices in planes", "[batched]")
+{
+	mtx::BatchedMatrix2D<double> batch(5, 3, 4, 1.5);
+	REQUIRE(batch.GetCount() == 5);
+	REQUIRE(batch.GetRows() == 3);
+	REQUIRE(batch.GetColumns() == 4);
+	REQUIRE(batch.GetPlaneStride() == 8);
+	REQUIRE(batch.Plane(1, 2) + 8 == batch.Plane(1, 3));
+
+	batch(2, 1, 3) = 7;
+	REQUIRE(batch.Plane(1, 3)[2] == 7);
+	REQUIRE(batch.GetView(2)(1, 3) == 7);
+	REQUIRE(batch.ToMatrix2D(2)(1, 3) == 7);
+	REQUIRE(batch.ToMatrix2D(3) == mtx::Matrix2D<double>(3, 4, 1.5));
+	REQUIRE_THROWS_AS(batch.GetView(5), std::out_of_range);
+
+	mtx::Matrix2D<double> wrongSize(4, 3);
+	REQUIRE_THROWS_AS(batch.Set(0, wrongSize.GetView()), std::length_error);
+
+	auto copy = batch;
+	REQUIRE(copy == batch);
+	copy(4, 2, 0) = 0;
+	REQUIRE(copy != batch);
+}
+
+TEST_CASE("Batched operations match operations on separate matrices", "[batched]")
+{
+	std::vector<mtx::Matrix2D<int>> lefts;
+	std::vector<mtx::Matrix2D<int>> rights;
+	const auto left = CreateBatch<int>(37, 6, 5, -10, 10, lefts);
+	const auto right = CreateBatch<int>(37, 5, 4, -10, 10, rights);
+	std::vector<mtx::Matrix2D<int>> others;
+	const auto other = CreateBatch<int>(37, 6, 5, -10, 10, others);
+
+	const auto sum = mtx::TransformMatrices(left, other, std::plus<int>());
+	const auto product = left * right;
+	REQUIRE(mtx::TransformMatrices(mtx::execution::ParallelPolicy{ 3 }, left, other, std::plus<int>()) == sum);
+	REQUIRE(mtx::Multiply(mtx::execution::ParallelPolicy{ 3 }, left, right) == product);
+
+	// Results are written into existing batches without allocation.
+	mtx::BatchedMatrix2D<int> result(37, 6, 4, 5);
+	mtx::Multiply(left, right, result);
+	REQUIRE(result == product);
+	mtx::BatchedMatrix2D<int> sumResult(37, 6, 5);
+	mtx::TransformMatrices(mtx::execution::ParallelPolicy{ 2 }, left, other, sumResult, std::plus<int>());
+	REQUIRE(sumResult == sum);
+	REQUIRE_THROWS_AS(mtx::Multiply(left, right, sumResult), std::length_error);
+	for (size_t b = 0; b < left.GetCount(); ++b)
+	{
+		REQUIRE(sum.ToMatrix2D(b) == mtx::TransformMatrices(lefts[b], others[b], std::plus<int>()));
+		REQUIRE(product.ToMatrix2D(b) == lefts[b] * rights[b]);
+	}
+
+	std::vector<mtx::Matrix2D<int>> wrongRights;
+	const auto wrongRight = CreateBatch<int>(36, 5, 4, -10, 10, wrongRights);
+	REQUIRE_THROWS_AS(left * wrongRight, std::length_error);
+	REQUIRE_THROWS_AS(left * other, std::length_error);
+	REQUIRE_THROWS_AS(mtx::TransformMatrices(left, right, std::plus<int>()), std::length_error);
+}
+
+TEST_CASE("Batched analyses match analyses of separate matrices", "[batched]")
+{
+	using Adapter = mtx::Matrix2DAdapter<int>;
+	const size_t sizes[][2] = { { 0, 0 }, { 1, 1 }, { 1, 6 }, { 6, 1 }, { 2, 2 }, { 7, 9 }, { 12, 5 } };
+	for (const auto& size : sizes)
+	{
+		std::vector<mtx::Matrix2D<int>> matrices;
+		// Narrow range makes identical neighbors and equal neighbors of minimums frequent.
+		const auto batch = CreateBatch<int>(21, size[0], size[1], -2, 3, matrices);
+		const auto minimums = Adapter::CountLocalMinimums(batch);
+		const auto sets = Adapter::LongestIdenticalSet(batch);
+		const auto products = Adapter::NonNegativeRowsMultiplication(batch);
+		const auto sums = Adapter::SumOverMainDiagonal(batch);
+		for (size_t b = 0; b < batch.GetCount(); ++b)
+		{
+			const auto view = matrices[b].GetView();
+			REQUIRE(minimums[b] == Adapter::CountLocalMinimums(view));
+			REQUIRE(sets[b] == Adapter::LongestIdenticalSet(view));
+			REQUIRE(products[b] == Adapter::NonNegativeRowsMultiplication(view));
+			REQUIRE(sums[b] == Adapter::SumOverMainDiagonal(view));
+		}
+	}
+
+	std::vector<mtx::Matrix2D<double>> matrices;
+	const auto batch = CreateBatch<double>(10, 8, 8, -1.0, 4.0, matrices);
+	const auto products = mtx::Matrix2DAdapter<double>::NonNegativeRowsMultiplication(batch);
+	const auto sums = mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(batch);
+	for (size_t b = 0; b < batch.GetCount(); ++b)
+	{
+		const auto view = matrices[b].GetView();
+		REQUIRE(products[b] == mtx::Matrix2DAdapter<double>::NonNegativeRowsMultiplication(view));
+		REQUIRE(sums[b] == Approx(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(view)));
+	}
+}
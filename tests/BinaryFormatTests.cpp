@@ -0,0 +1,125 @@
+#include "matrix/BinaryFormat.h"
+#include "matrix/MappedMatrix.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include "TemporaryFile.h"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("Matrices are saved and loaded in the binary format", "[BinaryFormat]")
+{
+	SECTION("Round trip keeps elements and padding")
+	{
+		const auto source = mtx::CreateRandomMatrix2D<double>(13, 7);
+		mtx::Matrix2D<double> padded(source.GetSize(), mtx::SimdRowPadding<double>());
+		padded = source + 0.0;
+
+		std::stringstream stream;
+		mtx::Save(padded, stream);
+		REQUIRE(stream.str().size() == 64 + 13 * 8 * sizeof(double));
+
+		const auto loaded = mtx::Load<double>(stream);
+		REQUIRE(loaded == source);
+		REQUIRE(loaded.GetRowStride() == 8);
+		REQUIRE(loaded.GetRowPadding().multiple_ == mtx::SimdRowPadding<double>().multiple_);
+	}
+
+	SECTION("Views are saved without their strides")
+	{
+		const auto source = mtx::CreateRandomMatrix2D<int>(6, 6);
+		std::stringstream stream;
+		mtx::Save(source.BlockView(1, 2, 4, 3), stream);
+
+		const auto loaded = mtx::Load<int>(stream);
+		REQUIRE(loaded.GetRows() == 4);
+		REQUIRE(loaded.GetColumns() == 3);
+		REQUIRE(loaded(3, 2) == source(4, 4));
+
+		std::stringstream empty;
+		mtx::Save(mtx::Matrix2D<float>(), empty);
+		REQUIRE(mtx::Load<float>(empty).GetSize().rowsNumber_ == 0);
+	}
+
+	SECTION("Files of foreign byte order are converted")
+	{
+		mtx::Matrix2D<std::int32_t> source(2, 3);
+		source(1, 2) = 0x01020304;
+		std::stringstream stream;
+		mtx::Save(source, stream);
+
+		// Swap bytes of every field of the header and of every element.
+		std::string bytes = stream.str();
+		mtx::BinaryHeader header;
+		std::copy(bytes.begin(), bytes.begin() + sizeof(header), reinterpret_cast<char*>(&header));
+		mtx::detail::SwapBytes(header);
+		std::copy(reinterpret_cast<char*>(&header), reinterpret_cast<char*>(&header) + sizeof(header), bytes.begin());
+		for (size_t i = sizeof(header); i < bytes.size(); i += sizeof(std::int32_t)) {
+			std::reverse(bytes.begin() + i, bytes.begin() + i + sizeof(std::int32_t));
+		}
+
+		std::stringstream foreign(bytes);
+		REQUIRE(mtx::Load<std::int32_t>(foreign) == source);
+	}
+
+	SECTION("Invalid files are rejected")
+	{
+		std::stringstream stream;
+		mtx::Save(mtx::Matrix2D<float>(3, 3, 1.0f), stream);
+		const std::string bytes = stream.str();
+
+		std::stringstream wrongType(bytes);
+		REQUIRE_THROWS_AS(mtx::Load<double>(wrongType), std::runtime_error);
+		std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+		REQUIRE_THROWS_AS(mtx::Load<float>(truncated), std::runtime_error);
+		std::stringstream garbage(std::string(100, 'x'));
+		REQUIRE_THROWS_AS(mtx::Load<float>(garbage), std::runtime_error);
+		REQUIRE_THROWS_AS(mtx::Load<float>(std::string("missing-matrix-file.bin")), std::runtime_error);
+	}
+}
+
+TEST_CASE("Matrices can be backed by mapped files", "[BinaryFormat]")
+{
+	const TemporaryFile file("BinaryFormatTests.bin");
+	const auto source = mtx::CreateRandomMatrix2D<float>(31, 17);
+	mtx::Save(source, file.path_);
+
+	{
+		const mtx::MappedMatrix2D<float> mapped(file.path_);
+		REQUIRE(mapped.GetRows() == 31);
+		REQUIRE(mapped.GetColumns() == 17);
+		REQUIRE(mapped(30, 16) == source(30, 16));
+		REQUIRE(mtx::Matrix2DAdapter<float>::SumOverMainDiagonal(mapped.GetView())
+			== mtx::Matrix2DAdapter<float>::SumOverMainDiagonal(source.GetView()));
+
+		mtx::MappedMatrix2D<float> readOnly(file.path_);
+		REQUIRE_FALSE(readOnly.IsWritable());
+		REQUIRE(readOnly.GetView()(30, 16) == source(30, 16));
+		REQUIRE_THROWS_AS(readOnly.GetWritableView(), std::runtime_error);
+		REQUIRE_THROWS_AS(mtx::MappedMatrix2D<double>(file.path_), std::runtime_error);
+	}
+
+	{
+		// Results are written directly to the mapped file.
+		auto result = mtx::MappedMatrix2D<float>::Create(file.path_, 31, 17, mtx::SimdRowPadding<float>());
+		REQUIRE(result.IsWritable());
+		REQUIRE(result.GetRowStride() == 32);
+		REQUIRE(result(5, 5) == 0.0f);
+		mtx::TransformMatrices(source.GetView(), source.GetView(), result.GetWritableView(), std::plus<float>());
+
+		mtx::MappedMatrix2D<float> moved = std::move(result);
+		moved.Flush();
+		REQUIRE(result.GetRows() == 0);
+	}
+
+	const auto loaded = mtx::Load<float>(file.path_);
+	REQUIRE(loaded == mtx::TransformMatrices(source, source, std::plus<float>()));
+	REQUIRE(loaded.GetRowStride() == 32);
+	REQUIRE_THROWS_AS(mtx::MappedMatrix2D<float>("missing-matrix-file.bin"), std::runtime_error);
+}
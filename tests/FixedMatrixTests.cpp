@@ -0,0 +1,84 @@
+#include "matrix/FixedMatrix.h"
+#include "matrix/Matrix.h"
+
+#include "catch.hpp"
+
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr mtx::FixedMatrix2D<int, 2, 3> left(1, 2, 3, 4, 5, 6);
+constexpr mtx::FixedMatrix2D<int, 3, 2> right(7, 8, 9, 10, 11, 12);
+constexpr auto product = left * right;
+constexpr auto sum = left + mtx::FixedMatrix2D<int, 2, 3>::Filled(1);
+
+static_assert(product.GetRows() == 2 && product.GetColumns() == 2, "Product has sizes of the result.");
+static_assert(product(0, 0) == 58 && product(0, 1) == 64, "Product is computed at compile time.");
+static_assert(product(1, 0) == 139 && product(1, 1) == 154, "Product is computed at compile time.");
+static_assert(sum(1, 2) == 7 && (sum - left).GetElements()[0] == 1, "Element-wise operations are constexpr.");
+static_assert(
+	mtx::FixedMatrix2D<int, 3, 3>::Identity() * right == right,
+	"Identity matrix doesn't change the product.");
+static_assert(sizeof(mtx::FixedMatrix2D<float, 4, 4>) == 16 * sizeof(float), "Elements are stored inline.");
+
+//! Returns matrix with random elements.
+template<typename T, size_t R, size_t C>
+mtx::FixedMatrix2D<T, R, C> CreateRandomFixed(std::mt19937& generator)
+{
+	std::uniform_int_distribution<int> distribution(-9, 9);
+	mtx::FixedMatrix2D<T, R, C> mat;
+	for (auto it = mat.Begin(); it != mat.End(); ++it) {
+		*it = static_cast<T>(distribution(generator));
+	}
+
+	return mat;
+}
+
+//! Checks operations against the ones of Matrix2D.
+template<typename T, size_t R, size_t K, size_t C>
+void CheckOperations(std::mt19937& generator)
+{
+	const auto a = CreateRandomFixed<T, R, K>(generator);
+	const auto b = CreateRandomFixed<T, R, K>(generator);
+	const auto c = CreateRandomFixed<T, K, C>(generator);
+
+	REQUIRE((a + b).ToMatrix2D() == mtx::TransformMatrices(a.ToMatrix2D(), b.ToMatrix2D(), std::plus<T>()));
+	REQUIRE((a - b).ToMatrix2D() == mtx::TransformMatrices(a.ToMatrix2D(), b.ToMatrix2D(), std::minus<T>()));
+	REQUIRE((a * c).ToMatrix2D() == mtx::Multiply(a.ToMatrix2D(), c.ToMatrix2D()));
+}
+
+}	// namespace
+
+TEST_CASE("Fixed matrix operations match Matrix2D", "[fixed]")
+{
+	std::mt19937 generator;
+	CheckOperations<int, 2, 2, 2>(generator);
+	CheckOperations<int, 3, 5, 4>(generator);
+	CheckOperations<double, 4, 4, 4>(generator);
+	CheckOperations<double, 8, 8, 8>(generator);
+	CheckOperations<float, 1, 7, 3>(generator);
+}
+
+TEST_CASE("Fixed matrix interoperates with Matrix2D", "[fixed]")
+{
+	mtx::Matrix2D<int> mat(5, 6);
+	int value = 0;
+	for (auto it = mat.Begin(); it != mat.End(); ++it) {
+		*it = ++value;
+	}
+
+	const mtx::FixedMatrix2D<int, 2, 3> block(mat.BlockView(1, 2, 2, 3));
+	REQUIRE(block(0, 0) == mat(1, 2));
+	REQUIRE(block(1, 2) == mat(2, 4));
+	REQUIRE(block.ToMatrix2D()(1, 1) == mat(2, 3));
+
+	// The view allows to use the fixed matrix in operations of Matrix2D.
+	mtx::Matrix2D<int> result(2, 2);
+	mtx::Multiply(block.GetView(), right.GetView(), result.GetView());
+	REQUIRE(result == (block * right).ToMatrix2D());
+
+	REQUIRE_THROWS_AS((mtx::FixedMatrix2D<int, 2, 2>(mat.GetView())), std::length_error);
+}
@@ -0,0 +1,116 @@
+#include "matrix/Instrumentation.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using mtx::instrumentation::Operation;
+
+TEST_CASE("Instrumentation counts calls and elements of operations", "[instrumentation]")
+{
+	mtx::instrumentation::Reset();
+
+	mtx::Matrix2D<int> left(10, 20, 1);
+	mtx::Matrix2D<int> right(10, 20, 2);
+	const mtx::Matrix2D<int> sum = left + right;
+	const auto copy = sum;
+	REQUIRE(copy == sum);
+	mtx::TransformMatrices(mtx::execution::ParallelPolicy{ 3 }, left.GetView(), right.GetView(), left.GetView(), std::plus<int>());
+	mtx::Matrix2DAdapter<int>::CountLocalMinimums(left.GetView());
+	mtx::Matrix2DAdapter<int>::Analyze(mtx::execution::par, left.GetView());
+	const auto row = left.Slice(2, 5, 15);
+	REQUIRE(row.size() == 10);
+
+	const auto snapshot = mtx::instrumentation::GetSnapshot();
+	if (!mtx::instrumentation::IsEnabled())
+	{
+		// Without instrumentation nothing is recorded.
+		REQUIRE(snapshot[Operation::Construction].calls_ == 0);
+		REQUIRE(snapshot.allocations_ == 0);
+		return;
+	}
+
+	// left, right and the result of the expression, the copy is counted separately.
+	REQUIRE(snapshot[Operation::Construction].calls_ == 3);
+	REQUIRE(snapshot[Operation::Construction].elements_ == 600);
+	REQUIRE(snapshot[Operation::Copy].calls_ == 1);
+	REQUIRE(snapshot[Operation::Copy].elements_ == 200);
+	REQUIRE(snapshot[Operation::Equal].calls_ == 1);
+	REQUIRE(snapshot[Operation::Equal].elements_ == 400);
+	// Blocks of the parallel version aren't counted as separate calls.
+	REQUIRE(snapshot[Operation::TransformMatrices].calls_ == 1);
+	REQUIRE(snapshot[Operation::TransformMatrices].elements_ == 600);
+	REQUIRE(snapshot[Operation::CountLocalMinimums].calls_ == 1);
+	REQUIRE(snapshot[Operation::Analyze].calls_ == 1);
+	REQUIRE(snapshot[Operation::LongestIdenticalSet].calls_ == 0);
+	REQUIRE(snapshot[Operation::Slice].elements_ == 10);
+	REQUIRE(snapshot.allocations_ >= 4);
+	REQUIRE(snapshot.bytesAllocated_ >= 4 * 200 * sizeof(int));
+
+	for (const auto& stats : snapshot.operations_)
+	{
+		std::uint64_t histogramCalls = 0;
+		for (const auto bucket : stats.histogram_) {
+			histogramCalls += bucket;
+		}
+		REQUIRE(histogramCalls == stats.calls_);
+	}
+
+	mtx::instrumentation::Reset();
+	REQUIRE(mtx::instrumentation::GetSnapshot()[Operation::Construction].calls_ == 0);
+	REQUIRE(mtx::instrumentation::GetSnapshot().bytesAllocated_ == 0);
+}
+
+TEST_CASE("Instrumentation counts only recomputed rows of cached analyses", "[instrumentation]")
+{
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(8, 16, 1);
+	mtx::Matrix2DAdapter<int> adapter(mat);
+	adapter.EnableCache();
+	adapter.LongestIdenticalSet();
+	mtx::instrumentation::Reset();
+
+	adapter.SetElement(3, 4, 7);
+	adapter.LongestIdenticalSet();
+	adapter.LongestIdenticalSet();
+
+	const auto snapshot = mtx::instrumentation::GetSnapshot();
+	if (mtx::instrumentation::IsEnabled())
+	{
+		REQUIRE(snapshot[Operation::LongestIdenticalSet].calls_ == 2);
+		REQUIRE(snapshot[Operation::LongestIdenticalSet].elements_ == 16);
+	}
+}
+
+TEST_CASE("Metrics are written in the text format of Prometheus", "[instrumentation]")
+{
+	mtx::instrumentation::Snapshot snapshot;
+	auto& multiply = snapshot.operations_[static_cast<size_t>(Operation::Multiply)];
+	multiply.calls_ = 3;
+	multiply.elements_ = 300;
+	multiply.nanoseconds_ = 2000000000;
+	multiply.histogram_[0] = 1;
+	multiply.histogram_[5] = 2;
+	snapshot.allocations_ = 4;
+	snapshot.bytesAllocated_ = 1024;
+
+	std::ostringstream stream;
+	mtx::instrumentation::WriteMetrics(stream, snapshot);
+	const std::string metrics = stream.str();
+
+	REQUIRE(metrics.find("mtx_operation_calls_total{operation=\"Multiply\"} 3\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_operation_elements_total{operation=\"Multiply\"} 300\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_operation_seconds_bucket{operation=\"Multiply\",le=\"2e-09\"} 1\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_operation_seconds_bucket{operation=\"Multiply\",le=\"6.4e-08\"} 3\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_operation_seconds_bucket{operation=\"Multiply\",le=\"+Inf\"} 3\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_operation_seconds_sum{operation=\"Multiply\"} 2\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_allocations_total 4\n") != std::string::npos);
+	REQUIRE(metrics.find("mtx_allocated_bytes_total 1024\n") != std::string::npos);
+	// Operations which weren't called are skipped.
+	REQUIRE(metrics.find("operation=\"Copy\"") == std::string::npos);
+}
@@ -0,0 +1,79 @@
+#include "matrix/Matrix.h"
+
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+TEST_CASE("Element-wise operations are lazy and fused", "[MatrixExpression]")
+{
+	const mtx::Matrix2D<int> a(3, 4, 5);
+	const mtx::Matrix2D<int> b(3, 4, 2);
+	const mtx::Matrix2D<int> c(3, 4, 1);
+
+	SECTION("Chained operators")
+	{
+		auto expr = a + b - c;
+		static_assert(!std::is_same<decltype(expr), mtx::Matrix2D<int>>::value, "Expression must be lazy.");
+		REQUIRE(expr.GetRows() == 3);
+		REQUIRE(expr.GetColumns() == 4);
+		REQUIRE(expr(2, 3) == 6);
+
+		const mtx::Matrix2D<int> result = expr;
+		REQUIRE(result == mtx::Matrix2D<int>(3, 4, 6));
+		REQUIRE(mtx::Evaluate(-(a - b)) == mtx::Matrix2D<int>(3, 4, -3));
+	}
+	SECTION("Scalar operators")
+	{
+		mtx::Matrix2D<int> result = 2 * a + 1;
+		REQUIRE(result(0, 0) == 11);
+		result = 10 - a / 5 * 3;
+		REQUIRE(result(1, 1) == 7);
+		result = a * 2 - (1 + b);
+		REQUIRE(result(2, 2) == 7);
+
+		const mtx::Matrix2D<double> halves = mtx::Evaluate(a * 0.5);
+		REQUIRE(halves(0, 0) == Approx(2.5));
+	}
+	SECTION("User functions")
+	{
+		mtx::Matrix2D<int> result = mtx::Map(a - b, [] (int val) { return val * val; });
+		REQUIRE(result(0, 0) == 9);
+		result = mtx::Zip(a, mtx::Map(b, [] (int val) { return val + 1; }),
+			[] (int left, int right) { return left % right; });
+		REQUIRE(result(0, 0) == 2);
+	}
+	SECTION("Assignment reuses storage and allows aliasing")
+	{
+		mtx::Matrix2D<int> result(3, 4, 1);
+		const int* storage = &result(0, 0);
+		result = result + a + result;
+		REQUIRE(&result(0, 0) == storage);
+		REQUIRE(result == mtx::Matrix2D<int>(3, 4, 7));
+
+		mtx::Matrix2D<int> resized(1, 1);
+		resized = a - c;
+		REQUIRE(resized.GetRows() == 3);
+		REQUIRE(resized(2, 3) == 4);
+	}
+	SECTION("Views take part in expressions")
+	{
+		mtx::Matrix2D<int> result = a.BlockView(1, 1, 2, 2) + b.BlockView(0, 0, 2, 2);
+		REQUIRE(result == mtx::Matrix2D<int>(2, 2, 7));
+
+		mtx::Matrix2D<int> target(3, 4, 0);
+		mtx::EvaluateInto(a + b + c, target.GetView());
+		REQUIRE(target == mtx::Matrix2D<int>(3, 4, 8));
+		mtx::EvaluateInto(a.BlockView(0, 0, 3, 1) - b.BlockView(0, 1, 3, 1), target.BlockView(0, 0, 3, 1));
+		REQUIRE(target(2, 0) == 3);
+		REQUIRE(target(2, 1) == 8);
+	}
+	SECTION("Sizes are checked")
+	{
+		const mtx::Matrix2D<int> other(4, 3, 1);
+		mtx::Matrix2D<int> target(3, 3, 0);
+		REQUIRE_THROWS_AS(a + other, std::length_error);
+		REQUIRE_THROWS_AS(a - b + other, std::length_error);
+		REQUIRE_THROWS_AS(mtx::EvaluateInto(a + b, target.GetView()), std::length_error);
+	}
+}
@@ -4,11 +4,17 @@
 #include "CatchInclude.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -50,6 +56,444 @@ TEST_CASE("Matrix has a basic interface", "[Matrix2D]")
 	REQUIRE(mat(0, 0) == 0);
 }
 
+TEST_CASE("Matrix provides non-owning views", "[Matrix2DView]")
+{
+	mtx::Matrix2D<int> mat(4, 5);
+	for (size_t r = 0; r < mat.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < mat.GetColumns(); ++c) {
+			mat(r, c) = static_cast<int>(r * 10 + c);
+		}
+	}
+	const mtx::Matrix2D<int>& matConst = mat;
+
+	// Test row and column views.
+	auto row = mat.RowView(2);
+	REQUIRE(row.GetSize() == 5);
+	REQUIRE(row[3] == 23);
+	REQUIRE(row.IsContiguous());
+	REQUIRE(std::equal(row.Begin(), row.End(), mat.Slice(2).begin()));
+
+	auto column = matConst.ColumnView(1);
+	REQUIRE(column.GetSize() == 4);
+	REQUIRE(column[3] == 31);
+	REQUIRE(!column.IsContiguous());
+	REQUIRE(std::accumulate(column.Begin(), column.End(), 0) == 64);
+	REQUIRE(column.End() - column.Begin() == 4);
+
+	// Views point into the matrix storage.
+	row[0] = -1;
+	REQUIRE(mat(2, 0) == -1);
+	REQUIRE(mat.GetView()(2, 0) == -1);
+
+	// Test block views.
+	auto block = mat.BlockView(1, 2, 2, 3);
+	REQUIRE(block.GetRows() == 2);
+	REQUIRE(block.GetColumns() == 3);
+	REQUIRE(block(0, 0) == 12);
+	REQUIRE(block(1, 2) == 24);
+	REQUIRE(block.Column(1)[1] == 23);
+	REQUIRE(block.Block(1, 1, 1, 2)(0, 1) == 24);
+	REQUIRE(mat.BlockView(4, 5, 0, 0).GetRows() == 0);
+
+	REQUIRE_THROWS_AS(mat.RowView(4), std::out_of_range);
+	REQUIRE_THROWS_AS(mat.ColumnView(5), std::out_of_range);
+	REQUIRE_THROWS_AS(mat.BlockView(3, 0, 2, 1), std::out_of_range);
+	REQUIRE_THROWS_AS(block.Row(2), std::out_of_range);
+
+	// Test TransformMatrices on views, result is written in place.
+	mtx::Matrix2D<int> result(2, 2, 0);
+	mtx::TransformMatrices(
+		matConst.BlockView(0, 0, 2, 2),
+		matConst.BlockView(2, 3, 2, 2),
+		result.GetView(),
+		std::plus<int>());
+	REQUIRE(result(0, 0) == 0 + 23);
+	REQUIRE(result(1, 1) == 11 + 34);
+
+	// Strided (column) views work as well.
+	mtx::Matrix2D<int> transposed(5, 4, 0);
+	mtx::Matrix2DView<int> transposedView(&transposed(0, 0), 4, 5, 1, 4);
+	mtx::TransformMatrices(
+		matConst.GetView(),
+		matConst.GetView(),
+		transposedView,
+		[] (int left, int) { return left; });
+	REQUIRE(transposed(3, 1) == mat(1, 3));
+
+	REQUIRE_THROWS_AS(
+		mtx::TransformMatrices(mat.GetView(), result.GetView(), result.GetView(), std::plus<int>()),
+		std::length_error);
+
+	// Test adapter analyses applied to the views.
+	mtx::Matrix2D<int> square(3, 3, 3);
+	REQUIRE(mtx::Matrix2DAdapter<int>::SumOverMainDiagonal(square.GetView()) == 9);
+	REQUIRE(mtx::Matrix2DAdapter<int>::SumOverMainDiagonal(square.BlockView(0, 0, 2, 2)) == 3);
+	square(1, 1) = 0;
+	REQUIRE(mtx::Matrix2DAdapter<int>::CountLocalMinimums(square.BlockView(1, 1, 2, 2)) == 1);
+	REQUIRE(mtx::Matrix2DAdapter<int>::NonNegativeRowsMultiplication(square.BlockView(0, 0, 1, 3)) == 27);
+	REQUIRE(mtx::Matrix2DAdapter<int>::LongestIdenticalSet(square.BlockView(1, 0, 2, 3)) == 1);
+
+	// Elements over the main diagonal are summed in T, fractions aren't truncated.
+	const mtx::Matrix2D<double> fractions(3, 3, 0.25);
+	REQUIRE(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(fractions.GetView()) == 0.75);
+	REQUIRE(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(fractions.BlockView(0, 0, 2, 3)) == 0.75);
+}
+
+namespace
+{
+
+//! Returns coordinates of elements of the ring n in clockwise order.
+std::vector<std::pair<size_t, size_t>> RingCoordinates(const size_t rows, const size_t columns, const size_t n)
+{
+	std::vector<std::pair<size_t, size_t>> ring;
+	for (size_t c = n; c < columns - n; ++c) {
+		ring.emplace_back(n, c);
+	}
+	for (size_t r = n + 1; r < rows - n; ++r) {
+		ring.emplace_back(r, columns - n - 1);
+	}
+	for (size_t c = columns - n - 1; c-- > n;) {
+		ring.emplace_back(rows - n - 1, c);
+	}
+	for (size_t r = rows - n - 1; --r > n;) {
+		ring.emplace_back(r, n);
+	}
+
+	return ring;
+}
+
+//! Integer which counts comparisons for equality.
+struct CountedInt
+{
+	CountedInt(const long long value = 0) : value_{ value } {}
+
+	friend bool operator==(const CountedInt& l, const CountedInt& r) { ++comparisons; return l.value_ == r.value_; }
+	friend bool operator<(const CountedInt& l, const CountedInt& r) { return l.value_ < r.value_; }
+	friend CountedInt operator+(const CountedInt& l, const CountedInt& r) { return l.value_ + r.value_; }
+	friend CountedInt operator*(const CountedInt& l, const CountedInt& r) { return l.value_ * r.value_; }
+
+	long long value_;
+	static size_t comparisons;
+};
+
+size_t CountedInt::comparisons = 0;
+
+}	// namespace
+
+TEST_CASE("CyclicShift rotates rings in place", "[Matrix2DAdapter]")
+{
+	for (const auto& size : { std::make_pair(1, 1), std::make_pair(2, 2), std::make_pair(3, 5),
+		std::make_pair(6, 4), std::make_pair(7, 7), std::make_pair(9, 12) })
+	{
+		const auto rows = static_cast<size_t>(size.first);
+		const auto columns = static_cast<size_t>(size.second);
+		for (const size_t step : { 0, 1, 2, 7, 13, 1000000007 })
+		{
+			auto mat = std::make_shared<mtx::Matrix2D<int>>(rows, columns);
+			for (size_t i = 0; i < rows * columns; ++i) {
+				(*mat)(i / columns, i % columns) = static_cast<int>(i);
+			}
+			const mtx::Matrix2D<int> original = *mat;
+
+			mtx::Matrix2DAdapter<int> adapter(mat);
+			adapter.CyclicShift(step);
+
+			mtx::Matrix2D<int> expected = original;
+			for (size_t n = 0; n < std::min(rows, columns) / 2; ++n)
+			{
+				const auto ring = RingCoordinates(rows, columns, n);
+				for (size_t k = 0; k < ring.size(); ++k)
+				{
+					const auto& to = ring[(k + step) % ring.size()];
+					expected(to.first, to.second) = original(ring[k].first, ring[k].second);
+				}
+			}
+			REQUIRE(*mat == expected);
+
+			adapter.CyclicShift(mtx::execution::par, step);
+			mtx::Matrix2DAdapter<int>::CyclicShift(expected.GetView(), step);
+			REQUIRE(*mat == expected);
+		}
+	}
+
+	// Rings of a block don't touch elements around it.
+	mtx::Matrix2D<int> mat(5, 6, 0);
+	mat(1, 1) = 1;
+	mtx::Matrix2DAdapter<int>::CyclicShift(mat.BlockView(1, 1, 3, 4), 3);
+	REQUIRE(mat(1, 1) == 0);
+	REQUIRE(mat(1, 4) == 1);
+	REQUIRE(std::accumulate(mat.Begin(), mat.End(), 0) == 1);
+}
+
+TEST_CASE("Longest identical set is the longest run of neighboring elements", "[Matrix2DAdapter]")
+{
+	using Adapter = mtx::Matrix2DAdapter<int>;
+	// The first row has more identical neighbors in total, the second one has the longest run.
+	const int elements[][8] = {
+		{ 1, 1, 2, 1, 1, 2, 1, 1 },
+		{ 0, 1, 5, 5, 5, 3, 4, 5 },
+		{ 7, 6, 5, 4, 3, 2, 1, 0 },
+		{ 9, 9, 8, 8, 8, 1, 1, 1 } };
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(4, 8);
+	for (size_t r = 0; r < 4; ++r)
+	{
+		for (size_t c = 0; c < 8; ++c) {
+			(*mat)(r, c) = elements[r][c];
+		}
+	}
+	const Adapter adapter(mat);
+	REQUIRE(adapter.LongestIdenticalSet() == 1);
+	REQUIRE(Adapter::Analyze(mat->GetView()).longestIdenticalSet_ == 1);
+
+	const auto runs = adapter.LongestIdenticalRuns();
+	REQUIRE(runs.size() == 4);
+	REQUIRE(runs[0] == (mtx::IdenticalRun{ 2, 0 }));
+	REQUIRE(runs[1] == (mtx::IdenticalRun{ 3, 2 }));
+	REQUIRE(runs[2] == (mtx::IdenticalRun{ 1, 0 }));
+	REQUIRE(runs[3] == (mtx::IdenticalRun{ 3, 2 }));
+	REQUIRE(adapter.LongestIdenticalRuns(mtx::execution::ParallelPolicy{ 3 }) == runs);
+
+	// Rows of the transposed view aren't contiguous.
+	const auto columns = Adapter::LongestIdenticalRuns(mat->GetView().Transposed());
+	REQUIRE(columns.size() == 8);
+	REQUIRE(columns[0] == (mtx::IdenticalRun{ 1, 0 }));
+	REQUIRE(columns[1] == (mtx::IdenticalRun{ 2, 0 }));
+	REQUIRE(columns[6] == (mtx::IdenticalRun{ 2, 2 }));
+	REQUIRE(Adapter::LongestIdenticalSet(mat->GetView().Transposed()) == 1);
+	REQUIRE(Adapter::LongestIdenticalRuns(mtx::Matrix2D<int>().GetView()).empty());
+
+	// Cached lengths of rows are runs as well.
+	auto cachedMat = std::make_shared<mtx::Matrix2D<int>>(*mat);
+	Adapter cached(cachedMat);
+	cached.EnableCache();
+	REQUIRE(cached.LongestIdenticalSet() == 1);
+	cached.SetElement(2, 7, 1);
+	cached.SetElement(2, 5, 1);
+	cached.SetElement(2, 4, 1);
+	REQUIRE(cached.LongestIdenticalSet() == 2);
+}
+
+TEST_CASE("Cached analyses follow changes of the matrix", "[Matrix2DAdapter]")
+{
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(20, 15, 1);
+	mtx::Matrix2DAdapter<int> adapter(mat);
+	REQUIRE(!adapter.IsCacheEnabled());
+	adapter.EnableCache();
+
+	// Adapters of the same matrix share the cache, adapters of other matrices don't.
+	const mtx::Matrix2DAdapter<int> other(mat);
+	const mtx::Matrix2DAdapter<int> copy(adapter);
+	REQUIRE(other.IsCacheEnabled());
+	REQUIRE(copy.IsCacheEnabled());
+	REQUIRE(!mtx::Matrix2DAdapter<int>(std::make_shared<mtx::Matrix2D<int>>(*mat)).IsCacheEnabled());
+
+	const auto check = [&mat, &other] ()
+	{
+		const auto view = mat->GetView();
+		REQUIRE(other.LongestIdenticalSet() == mtx::Matrix2DAdapter<int>::LongestIdenticalSet(view));
+		REQUIRE(other.NonNegativeRowsMultiplication()
+			== mtx::Matrix2DAdapter<int>::NonNegativeRowsMultiplication(view));
+		REQUIRE(other.SumOverMainDiagonal() == mtx::Matrix2DAdapter<int>::SumOverMainDiagonal(view));
+	};
+	check();
+
+	adapter.SetElement(3, 4, 2);
+	adapter.SetElement(7, 0, -1);
+	check();
+
+	adapter.ModifyRows(10, 12, [] (const mtx::Matrix2DView<int>& rows)
+	{
+		for (size_t c = 0; c < rows.GetColumns(); ++c) {
+			rows(1, c) = static_cast<int>(c % 3);
+		}
+	});
+	check();
+
+	adapter.CyclicShift(5);
+	check();
+	adapter.CyclicShift(mtx::execution::par, 3);
+	check();
+
+	// Writes by other owners are reported.
+	(*mat)(0, 1) = 7;
+	(*mat)(7, 0) = 1;
+	adapter.MarkRowsDirty(0, 8);
+	check();
+
+	// Reallocation and resizing reset the cache.
+	*mat = mtx::Matrix2D<int>(9, 30, 2);
+	check();
+	*mat = mtx::Matrix2D<int>();
+	check();
+	REQUIRE(other.LongestIdenticalSet() == -1);
+
+	REQUIRE_THROWS_AS(adapter.SetElement(0, 0, 1), std::out_of_range);
+	REQUIRE_THROWS_AS(adapter.MarkRowsDirty(0, 1), std::out_of_range);
+
+	adapter.DisableCache();
+	REQUIRE(!other.IsCacheEnabled());
+}
+
+TEST_CASE("Cached analyses rescan only changed rows", "[Matrix2DAdapter]")
+{
+	const size_t rows = 40;
+	const size_t columns = 25;
+	auto mat = std::make_shared<mtx::Matrix2D<CountedInt>>(rows, columns, CountedInt(1));
+	mtx::Matrix2DAdapter<CountedInt> adapter(mat);
+	adapter.EnableCache();
+
+	CountedInt::comparisons = 0;
+	REQUIRE(adapter.LongestIdenticalSet() == 0);
+	REQUIRE(CountedInt::comparisons == rows * (columns - 1));
+
+	CountedInt::comparisons = 0;
+	REQUIRE(adapter.LongestIdenticalSet() == 0);
+	REQUIRE(CountedInt::comparisons == 0);
+
+	adapter.SetElement(5, 3, CountedInt(2));
+	adapter.SetElement(9, 3, CountedInt(2));
+	adapter.SetElement(9, 4, CountedInt(2));
+	REQUIRE(adapter.LongestIdenticalSet() == 0);
+	REQUIRE(CountedInt::comparisons == 2 * (columns - 1));
+
+	adapter.ModifyRows(0, 2, [] (const mtx::Matrix2DView<CountedInt>& view) { view(1, 0) = 3; });
+	CountedInt::comparisons = 0;
+	REQUIRE(adapter.LongestIdenticalSet() == 0);
+	REQUIRE(CountedInt::comparisons == 2 * (columns - 1));
+	REQUIRE(adapter.NonNegativeRowsMultiplication().value_ == 3 * 2 * 2 * 2);
+	REQUIRE(adapter.SumOverMainDiagonal().value_
+		== mtx::Matrix2DAdapter<CountedInt>::SumOverMainDiagonal(mat->GetView()).value_);
+}
+
+TEST_CASE("Cached floating point results equal results without the cache", "[Matrix2DAdapter]")
+{
+	// Several blocks of rows, so the order of rounding matters.
+	const size_t rows = 1000;
+	const size_t columns = 64;
+	auto mat = std::make_shared<mtx::Matrix2D<double>>(rows, columns);
+	std::mt19937 generator;
+	std::uniform_real_distribution<double> distribution(0.999, 1.001);
+	for (size_t r = 0; r < rows; ++r)
+	{
+		for (size_t c = 0; c < columns; ++c) {
+			(*mat)(r, c) = distribution(generator);
+		}
+	}
+
+	mtx::Matrix2DAdapter<double> adapter(mat);
+	const mtx::Matrix2DAdapter<double> cached(mat);
+	const auto check = [&adapter, &cached, &mat] ()
+	{
+		const auto view = mat->GetView();
+		const double product = adapter.NonNegativeRowsMultiplication(mtx::execution::seq, view);
+		const double sum = adapter.SumOverMainDiagonal(mtx::execution::seq, view);
+		REQUIRE(adapter.NonNegativeRowsMultiplication(mtx::execution::ParallelPolicy{ 3 }, view) == product);
+		REQUIRE(adapter.SumOverMainDiagonal(mtx::execution::ParallelPolicy{ 3 }, view) == sum);
+		REQUIRE(cached.NonNegativeRowsMultiplication() == product);
+		REQUIRE(cached.SumOverMainDiagonal() == sum);
+	};
+
+	check();
+	adapter.EnableCache();
+	check();
+	adapter.SetElement(300, 10, 1.5);
+	adapter.SetElement(999, 0, 0.5);
+	check();
+	adapter.DisableCache();
+	check();
+}
+
+TEST_CASE("Concurrent readers see the matrix between writes", "[Matrix2DAdapter]")
+{
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(mtx::CreateRandomMatrix2D<int>(30, 20, 5));
+	mtx::Matrix2DAdapter<int> writer(mat);
+	const mtx::Matrix2DAdapter<int> reader(mat);
+	REQUIRE(!reader.IsConcurrent());
+	REQUIRE(reader.GetSnapshot() == mat);
+	writer.EnableConcurrentReaders();
+	REQUIRE(reader.IsConcurrent());
+
+	// Snapshots are copies, taken snapshots don't change.
+	const auto before = reader.GetSnapshot();
+	REQUIRE(before != mat);
+	REQUIRE(*before == *mat);
+	writer.SetElement(3, 4, -100);
+	REQUIRE((*before)(3, 4) != -100);
+	REQUIRE((*reader.GetSnapshot())(3, 4) == -100);
+
+	// Storage of released snapshots is reused, changed rows of the last writes are copied.
+	const auto check = [&mat, &reader] ()
+	{
+		REQUIRE(*reader.GetSnapshot() == *mat);
+		REQUIRE(reader.CountLocalMinimums() == mtx::Matrix2DAdapter<int>::CountLocalMinimums(mat->GetView()));
+		REQUIRE(reader.LongestIdenticalSet() == mtx::Matrix2DAdapter<int>::LongestIdenticalSet(mat->GetView()));
+		REQUIRE(reader.SumOverMainDiagonal() == mtx::Matrix2DAdapter<int>::SumOverMainDiagonal(mat->GetView()));
+	};
+	for (size_t i = 0; i < 10; ++i)
+	{
+		writer.SetElement(i * 3, i, static_cast<int>(i));
+		check();
+	}
+	writer.ModifyRows(5, 9, [] (const mtx::Matrix2DView<int>& rows) { rows(3, 7) = 42; });
+	check();
+	writer.CyclicShift(mtx::execution::par, 4);
+	check();
+	(*mat)(29, 19) = 11;
+	writer.MarkRowsDirty(29, 30);
+	check();
+
+	// Writer sets all elements to the same value one by one, readers never see a mix.
+	*mat = mtx::Matrix2D<int>(50, 50, 0);
+	writer.MarkRowsDirty(0, 50);
+	std::atomic<bool> done{ false };
+	std::atomic<int> inconsistent{ 0 };
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 3; ++i)
+	{
+		readers.emplace_back([&]
+		{
+			int last = 0;
+			while (!done.load())
+			{
+				const auto snapshot = reader.GetSnapshot();
+				const int value = (*snapshot)(0, 0);
+				const bool uniform = std::all_of(
+					snapshot->Begin(),
+					snapshot->End(),
+					[value] (const int element) { return element == value; });
+				const bool sumMatches = reader.SumOverMainDiagonal() >= value * 50 * 49 / 2;
+				if (!uniform || !sumMatches || value < last) {
+					++inconsistent;
+				}
+				last = value;
+			}
+		});
+	}
+	for (int value = 1; value <= 200; ++value)
+	{
+		writer.ModifyRows(0, 50, [value] (const mtx::Matrix2DView<int>& rows)
+		{
+			for (size_t r = 0; r < rows.GetRows(); ++r)
+			{
+				for (size_t c = 0; c < rows.GetColumns(); ++c) {
+					rows(r, c) = value;
+				}
+			}
+		});
+	}
+	done = true;
+	for (auto& thread : readers) {
+		thread.join();
+	}
+	REQUIRE(inconsistent == 0);
+	REQUIRE((*reader.GetSnapshot())(49, 49) == 200);
+
+	writer.DisableConcurrentReaders();
+	REQUIRE(!reader.IsConcurrent());
+	REQUIRE(reader.GetSnapshot() == mat);
+}
+
 TEST_CASE("MatrixAdapter has specialized interface", "[Matrix2DAdapter]")
 {
 	auto mat = std::make_shared<mtx::Matrix2D<int>>(3, 3, 3);
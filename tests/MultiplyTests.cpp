@@ -0,0 +1,99 @@
+#include "matrix/Matrix.h"
+
+#include "catch.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace
+{
+
+//! Reference implementation of the matrix multiplication.
+template<typename T>
+mtx::Matrix2D<T> NaiveMultiply(const mtx::Matrix2D<T>& left, const mtx::Matrix2D<T>& right)
+{
+	mtx::Matrix2D<T> result(left.GetRows(), right.GetColumns(), 0);
+	for (size_t r = 0; r < left.GetRows(); ++r)
+	{
+		for (size_t k = 0; k < left.GetColumns(); ++k)
+		{
+			for (size_t c = 0; c < right.GetColumns(); ++c) {
+				result(r, c) += left(r, k) * right(k, c);
+			}
+		}
+	}
+
+	return result;
+}
+
+}	// namespace
+
+TEST_CASE("Matrices can be multiplied", "[Multiply]")
+{
+	SECTION("Small matrices")
+	{
+		mtx::Matrix2D<int> left(2, 3);
+		mtx::Matrix2D<int> right(3, 2);
+		int val = 1;
+		for (auto it = left.Begin(); it != left.End(); ++it) {
+			*it = val++;
+		}
+		for (auto it = right.Begin(); it != right.End(); ++it) {
+			*it = val++;
+		}
+
+		const mtx::Matrix2D<int> product = left * right;
+		REQUIRE(product.GetRows() == 2);
+		REQUIRE(product.GetColumns() == 2);
+		REQUIRE(product(0, 0) == 1 * 7 + 2 * 9 + 3 * 11);
+		REQUIRE(product(1, 1) == 4 * 8 + 5 * 10 + 6 * 12);
+	}
+	SECTION("Sizes which aren't multiples of blocks")
+	{
+		const size_t sizes[][3] = { { 1, 1, 1 }, { 5, 7, 3 }, { 97, 300, 129 }, { 130, 17, 2100 } };
+		for (const auto& size : sizes)
+		{
+			const auto left = mtx::CreateRandomMatrix2D<int>(size[0], size[1]);
+			const auto right = mtx::CreateRandomMatrix2D<int>(size[1], size[2]);
+			REQUIRE(mtx::Multiply(left, right) == NaiveMultiply(left, right));
+		}
+	}
+	SECTION("Floating point matrices")
+	{
+		const auto left = mtx::CreateRandomMatrix2D<double>(67, 45);
+		const auto right = mtx::CreateRandomMatrix2D<double>(45, 33);
+		const auto product = left * right;
+		const auto expected = NaiveMultiply(left, right);
+		for (size_t r = 0; r < product.GetRows(); ++r)
+		{
+			for (size_t c = 0; c < product.GetColumns(); ++c) {
+				REQUIRE(product(r, c) == Approx(expected(r, c)));
+			}
+		}
+	}
+	SECTION("Views")
+	{
+		const auto mat = mtx::CreateRandomMatrix2D<long long>(20, 20);
+		mtx::Matrix2D<long long> result(6, 5, -1);
+		mtx::Multiply(mat.BlockView(1, 2, 6, 7), mat.BlockView(3, 4, 7, 5), result.GetView());
+
+		mtx::Matrix2D<long long> left(6, 7);
+		mtx::Matrix2D<long long> right(7, 5);
+		mtx::TransformMatrices(mat.BlockView(1, 2, 6, 7), mat.BlockView(1, 2, 6, 7), left.GetView(),
+			[] (long long val, long long) { return val; });
+		mtx::TransformMatrices(mat.BlockView(3, 4, 7, 5), mat.BlockView(3, 4, 7, 5), right.GetView(),
+			[] (long long val, long long) { return val; });
+		REQUIRE(result == NaiveMultiply(left, right));
+	}
+	SECTION("Mismatched sizes")
+	{
+		mtx::Matrix2D<int> left(2, 3);
+		mtx::Matrix2D<int> right(2, 3);
+		mtx::Matrix2D<int> result(2, 3);
+		REQUIRE_THROWS_AS(left * right, std::length_error);
+		REQUIRE_THROWS_AS(
+			mtx::Multiply(left.GetView(), right.GetView(), result.GetView()),
+			std::length_error);
+		REQUIRE((mtx::Matrix2D<int>(2, 0) * mtx::Matrix2D<int>(0, 3)) == mtx::Matrix2D<int>(2, 3, 0));
+	}
+}
@@ -0,0 +1,158 @@
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+
+#include "catch.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ParallelFor covers the range once", "[Parallel]")
+{
+	for (const size_t threads : { 1, 3, 8 })
+	{
+		std::vector<int> visits(1000, 0);
+		mtx::detail::ParallelFor(
+			mtx::execution::ParallelPolicy{ threads },
+			0,
+			visits.size(),
+			7,
+			[&visits] (const size_t first, const size_t last)
+			{
+				for (size_t i = first; i < last; ++i) {
+					++visits[i];
+				}
+			});
+		REQUIRE(visits == std::vector<int>(1000, 1));
+	}
+
+	REQUIRE_THROWS_AS(
+		mtx::detail::ParallelFor(
+			mtx::execution::ParallelPolicy{ 4 },
+			0,
+			100,
+			1,
+			[] (const size_t first, const size_t)
+			{
+				if (first > 0) {
+					throw std::runtime_error("failure");
+				}
+			}),
+		std::runtime_error);
+}
+
+TEST_CASE("Parallel overloads match sequential results", "[Parallel]")
+{
+	const mtx::execution::ParallelPolicy policies[] = { { 1 }, { 3 }, { 8 }, mtx::execution::par };
+
+	auto mat = std::make_shared<mtx::Matrix2D<int>>(mtx::CreateRandomMatrix2D<int>(517, 33));
+	(*mat)(100, 3) = -1;
+	for (size_t c = 0; c < 10; ++c) {
+		(*mat)(400, c) = 5;
+	}
+	const auto other = mtx::CreateRandomMatrix2D<int>(517, 33);
+	const mtx::Matrix2DAdapter<int> adapter(mat);
+
+	for (const auto& policy : policies)
+	{
+		REQUIRE(mtx::TransformMatrices(policy, *mat, other, std::minus<int>())
+			== mtx::TransformMatrices(*mat, other, std::minus<int>()));
+		REQUIRE(mtx::Equal(policy, *mat, *mat));
+		REQUIRE(mtx::Equal(policy, other, mtx::Matrix2D<int>(other)));
+		REQUIRE_FALSE(mtx::Equal(policy, *mat, other));
+
+		REQUIRE(adapter.CountLocalMinimums(policy) == adapter.CountLocalMinimums());
+		REQUIRE(adapter.LongestIdenticalSet(policy) == adapter.LongestIdenticalSet());
+		REQUIRE(adapter.LongestIdenticalRuns(policy) == adapter.LongestIdenticalRuns());
+		REQUIRE(adapter.NonNegativeRowsMultiplication(policy) == adapter.NonNegativeRowsMultiplication());
+		REQUIRE(adapter.SumOverMainDiagonal(policy) == adapter.SumOverMainDiagonal());
+	}
+
+	REQUIRE(adapter.CountLocalMinimums(mtx::execution::seq) == adapter.CountLocalMinimums());
+	REQUIRE(adapter.LongestIdenticalSet(mtx::execution::seq) == 400);
+
+	const mtx::Matrix2D<int> empty;
+	REQUIRE(mtx::Matrix2DAdapter<int>::LongestIdenticalSet(mtx::execution::par, empty.GetView()) == -1);
+	REQUIRE(mtx::Matrix2DAdapter<int>::SumOverMainDiagonal(mtx::execution::par, empty.GetView()) == 0);
+	REQUIRE_THROWS_AS(
+		mtx::TransformMatrices(mtx::execution::par, *mat, mtx::Matrix2D<int>(2, 2), std::plus<int>()),
+		std::length_error);
+}
+
+TEST_CASE("Parallel reductions don't depend on number of threads", "[Parallel]")
+{
+	mtx::Matrix2D<double> mat(3001, 61);
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> distribution(0.99, 1.01);
+	mtx::RandomizeElements(mtx::execution::ParallelPolicy{ 1 }, mat, generator, distribution);
+
+	// Same generator state gives the same matrix for any number of threads.
+	mtx::Matrix2D<double> copy(mat.GetSize());
+	std::mt19937 sameGenerator(42);
+	mtx::RandomizeElements(mtx::execution::ParallelPolicy{ 5 }, copy, sameGenerator, distribution);
+	REQUIRE(copy == mat);
+
+	const auto view = mat.GetView();
+	const double sum = mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(mtx::execution::seq, view);
+	const double product = mtx::Matrix2DAdapter<double>::NonNegativeRowsMultiplication(mtx::execution::seq, view);
+	for (const size_t threads : { 2, 3, 7, 16 })
+	{
+		const mtx::execution::ParallelPolicy policy{ threads };
+		REQUIRE(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(policy, view) == sum);
+		REQUIRE(mtx::Matrix2DAdapter<double>::NonNegativeRowsMultiplication(policy, view) == product);
+	}
+	REQUIRE(sum == Approx(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(view)));
+	REQUIRE(product == Approx(mtx::Matrix2DAdapter<double>::NonNegativeRowsMultiplication(view)));
+	REQUIRE(product > 0.0);
+}
+
+TEST_CASE("Fused analysis matches separate analyses", "[Parallel]")
+{
+	mtx::Matrix2D<double> mat(2999, 47);
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<int> distribution(0, 4);
+	for (auto it = mat.Begin(); it != mat.End(); ++it) {
+		*it = 0.9 + 0.05 * distribution(generator);
+	}
+	mat(17, 5) = -1.0;
+	for (size_t c = 0; c < 30; ++c) {
+		mat(2500, c) = 2.0;
+	}
+	const mtx::Matrix2DView<const double> view = mat.GetView();
+	using Adapter = mtx::Matrix2DAdapter<double>;
+
+	for (const auto& policy : { mtx::execution::ParallelPolicy{ 1 }, mtx::execution::ParallelPolicy{ 4 } })
+	{
+		const auto result = Adapter::Analyze(policy, view);
+		REQUIRE(result.localMinimums_ == Adapter::CountLocalMinimums(view));
+		REQUIRE(result.longestIdenticalSet_ == 2500);
+		REQUIRE(result.nonNegativeRowsMultiplication_ == Adapter::NonNegativeRowsMultiplication(policy, view));
+		REQUIRE(result.sumOverMainDiagonal_ == Adapter::SumOverMainDiagonal(policy, view));
+	}
+
+	// Analyses which aren't requested keep default values.
+	const auto partial = Adapter::Analyze(
+		view,
+		mtx::Analysis::CountLocalMinimums | mtx::Analysis::SumOverMainDiagonal);
+	REQUIRE(partial.localMinimums_ == Adapter::CountLocalMinimums(view));
+	REQUIRE(partial.longestIdenticalSet_ == -1);
+	REQUIRE(partial.nonNegativeRowsMultiplication_ == 1.0);
+	REQUIRE(partial.sumOverMainDiagonal_ == Adapter::SumOverMainDiagonal(mtx::execution::seq, view));
+
+	const auto adapter = Adapter(std::make_shared<mtx::Matrix2D<double>>(mat));
+	REQUIRE(adapter.Analyze(mtx::execution::par).localMinimums_ == adapter.CountLocalMinimums());
+	REQUIRE(adapter.Analyze(mtx::Analysis::LongestIdenticalSet).longestIdenticalSet_ == 2500);
+
+	// Special cases of empty matrices and matrices with a single row.
+	const mtx::Matrix2D<double> empty;
+	const auto emptyResult = Adapter::Analyze(mtx::execution::par, empty.GetView());
+	REQUIRE(emptyResult.longestIdenticalSet_ == -1);
+	REQUIRE(emptyResult.sumOverMainDiagonal_ == 0.0);
+	const mtx::Matrix2D<double> row(1, 5, 3.0);
+	REQUIRE(Adapter::Analyze(row.GetView()).sumOverMainDiagonal_ == 3.0);
+	REQUIRE(Adapter::Analyze(row.GetView()).longestIdenticalSet_ == 0);
+}
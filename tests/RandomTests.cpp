@@ -0,0 +1,113 @@
+#include "matrix/Matrix.h"
+#include "matrix/Random.h"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+//! Checks that the matrix filled by several threads matches the one filled by a single thread
+//! and all elements are within the range.
+template<typename T>
+void CheckUniform(const size_t rows, const size_t columns, const T low, const T high)
+{
+	mtx::Matrix2D<T> expected(rows, columns);
+	mtx::RandomizeUniform(expected.GetView(), 42, low, high);
+	for (auto it = expected.Begin(); it != expected.End(); ++it)
+	{
+		REQUIRE(*it >= low);
+		REQUIRE(*it <= high);
+	}
+
+	for (const size_t threads : { 1, 2, 3, 8 })
+	{
+		mtx::Matrix2D<T> mat(rows, columns);
+		mtx::RandomizeUniform(mtx::execution::ParallelPolicy{ threads }, mat.GetView(), 42, low, high);
+		REQUIRE(mat == expected);
+	}
+
+	// Padding of rows doesn't change values of elements.
+	mtx::Matrix2D<T> padded(typename mtx::Matrix2D<T>::Dimension{ rows, columns }, mtx::RowPadding{ 16 });
+	mtx::RandomizeUniform(mtx::execution::par, padded.GetView(), 42, low, high);
+	for (size_t r = 0; r < rows; ++r)
+	{
+		for (size_t c = 0; c < columns; ++c) {
+			REQUIRE(padded(r, c) == expected(r, c));
+		}
+	}
+}
+
+}	// namespace
+
+TEST_CASE("Counter-based generator gives access to any value of the sequence", "[random]")
+{
+	mtx::CounterRng generator(7);
+	std::vector<std::uint64_t> sequence(1000);
+	for (auto& value : sequence) {
+		value = generator();
+	}
+	REQUIRE(generator.GetCounter() == 1000);
+
+	const mtx::CounterRng other(7);
+	std::vector<std::uint64_t> bulk(600);
+	other.Generate(300, bulk.size(), bulk.data());
+	for (size_t i = 0; i < bulk.size(); ++i)
+	{
+		REQUIRE(other.Generate(300 + i) == sequence[300 + i]);
+		REQUIRE(bulk[i] == sequence[300 + i]);
+	}
+
+	mtx::CounterRng skipping(7);
+	skipping.Discard(500);
+	REQUIRE(skipping() == sequence[500]);
+	skipping.Seek(10);
+	REQUIRE(skipping() == sequence[10]);
+
+	REQUIRE(mtx::CounterRng(7, 1)() != sequence[0]);
+	REQUIRE(mtx::CounterRng(8)() != sequence[0]);
+
+	// Works as a generator of standard distributions.
+	std::uniform_int_distribution<int> distribution(1, 6);
+	const int value = distribution(generator);
+	REQUIRE((value >= 1 && value <= 6));
+}
+
+TEST_CASE("Random matrices don't depend on the number of threads", "[random]")
+{
+	CheckUniform<double>(131, 77, -1.0, 1.0);
+	CheckUniform<float>(64, 300, 0.0f, 100.0f);
+	CheckUniform<int>(97, 45, -5, 5);
+	CheckUniform<std::int8_t>(33, 19, std::numeric_limits<std::int8_t>::min(), std::numeric_limits<std::int8_t>::max());
+	CheckUniform<unsigned>(10, 1000, 0u, std::numeric_limits<unsigned>::max());
+	CheckUniform<long long>(20, 30, std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max());
+	CheckUniform<long long>(20, 30, -(1LL << 40), 1LL << 40);
+
+	// Every value of a small range appears.
+	mtx::Matrix2D<int> dice(50, 50);
+	mtx::RandomizeUniform(dice.GetView(), 1, 1, 6);
+	std::vector<int> counts(7, 0);
+	for (auto it = dice.Begin(); it != dice.End(); ++it) {
+		++counts[static_cast<size_t>(*it)];
+	}
+	for (int face = 1; face <= 6; ++face) {
+		REQUIRE(counts[static_cast<size_t>(face)] > 300);
+	}
+}
+
+TEST_CASE("Random matrices are reproducible by seed", "[random]")
+{
+	const auto mat = mtx::CreateRandomMatrix2D<double>(300, 200, 5);
+	REQUIRE(mat == mtx::CreateRandomMatrix2D<double>(mtx::execution::seq, 300, 200, 5));
+	REQUIRE(mat == mtx::CreateRandomMatrix2D<double>(mtx::execution::ParallelPolicy{ 7 }, 300, 200, 5));
+	REQUIRE_FALSE(mat == mtx::CreateRandomMatrix2D<double>(300, 200, 6));
+
+	const auto ints = mtx::CreateRandomMatrix2D<int>(40, 40);
+	for (auto it = ints.Begin(); it != ints.End(); ++it) {
+		REQUIRE((*it >= 0 && *it <= 100));
+	}
+}
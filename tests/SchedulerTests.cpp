@@ -0,0 +1,131 @@
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Parallel.h"
+#include "matrix/Scheduler.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Scheduler executes every element of the range once", "[Scheduler]")
+{
+	mtx::WorkStealingScheduler scheduler(3);
+	REQUIRE(scheduler.GetWorkersNumber() == 3);
+
+	for (const size_t grain : { 1, 5, 64, 10000 })
+	{
+		std::vector<std::atomic<int>> visits(1000);
+		std::atomic<bool> shortRange{ false };
+		scheduler.ParallelFor(0, visits.size(), grain, [&] (const size_t first, const size_t last)
+		{
+			if (last - first < grain && !(first == 0 && last == visits.size())) {
+				shortRange = true;
+			}
+			for (size_t i = first; i < last; ++i) {
+				++visits[i];
+			}
+		});
+
+		REQUIRE_FALSE(shortRange.load());
+		for (const auto& visit : visits) {
+			REQUIRE(visit.load() == 1);
+		}
+	}
+
+	bool called = false;
+	scheduler.ParallelFor(5, 5, 1, [&called] (const size_t, const size_t) { called = true; });
+	REQUIRE_FALSE(called);
+}
+
+TEST_CASE("Nested loops reuse workers of the scheduler", "[Scheduler]")
+{
+	mtx::WorkStealingScheduler scheduler(3);
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	std::atomic<size_t> sum{ 0 };
+
+	scheduler.ParallelFor(0, 64, 1, [&] (const size_t first, const size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			scheduler.ParallelFor(0, 100, 1, [&] (const size_t innerFirst, const size_t innerLast)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					threads.insert(std::this_thread::get_id());
+				}
+				for (size_t j = innerFirst; j < innerLast; ++j) {
+					sum += i * j;
+				}
+			});
+		}
+	});
+
+	REQUIRE(sum.load() == (63 * 64 / 2) * (99 * 100 / 2));
+	REQUIRE(threads.size() <= scheduler.GetWorkersNumber() + 1);
+}
+
+TEST_CASE("Scheduler rethrows exceptions of tasks", "[Scheduler]")
+{
+	mtx::WorkStealingScheduler scheduler(2);
+	REQUIRE_THROWS_AS(
+		scheduler.ParallelFor(0, 100, 1, [] (const size_t first, const size_t)
+		{
+			if (first >= 50) {
+				throw std::runtime_error("failure");
+			}
+		}),
+		std::runtime_error);
+
+	// Scheduler is usable after the failure.
+	std::atomic<size_t> count{ 0 };
+	scheduler.ParallelFor(0, 100, 1, [&count] (const size_t first, const size_t last) { count += last - first; });
+	REQUIRE(count.load() == 100);
+
+	mtx::WorkStealingScheduler inlineScheduler(0);
+	const auto caller = std::this_thread::get_id();
+	inlineScheduler.ParallelFor(0, 100, 1, [caller] (const size_t first, const size_t last)
+	{
+		REQUIRE(first == 0);
+		REQUIRE(last == 100);
+		REQUIRE(std::this_thread::get_id() == caller);
+	});
+}
+
+TEST_CASE("Matrix operations run on the injected scheduler", "[Scheduler]")
+{
+	mtx::WorkStealingScheduler scheduler(3);
+	const auto policy = mtx::execution::par.On(scheduler);
+	REQUIRE(policy.scheduler_ == &scheduler);
+
+	auto mat = std::make_shared<mtx::Matrix2D<double>>(mtx::CreateRandomMatrix2D<double>(2000, 40));
+	const auto other = mtx::CreateRandomMatrix2D<double>(2000, 40);
+	const mtx::Matrix2DAdapter<double> adapter(mat);
+
+	REQUIRE(mtx::TransformMatrices(policy, *mat, other, std::plus<double>())
+		== mtx::TransformMatrices(*mat, other, std::plus<double>()));
+	REQUIRE(mtx::Equal(policy, *mat, *mat));
+	REQUIRE(adapter.CountLocalMinimums(policy) == adapter.CountLocalMinimums());
+	REQUIRE(adapter.LongestIdenticalSet(policy) == adapter.LongestIdenticalSet());
+	REQUIRE(adapter.SumOverMainDiagonal(policy) == adapter.SumOverMainDiagonal(mtx::execution::seq));
+	REQUIRE(adapter.NonNegativeRowsMultiplication(policy)
+		== adapter.NonNegativeRowsMultiplication(mtx::execution::seq));
+
+	// Operations called from tasks of the scheduler compose with it.
+	std::vector<int> minimums(8, 0);
+	scheduler.ParallelFor(0, minimums.size(), 1, [&] (const size_t first, const size_t last)
+	{
+		for (size_t i = first; i < last; ++i) {
+			minimums[i] = adapter.CountLocalMinimums(policy);
+		}
+	});
+	REQUIRE(minimums == std::vector<int>(8, adapter.CountLocalMinimums()));
+}
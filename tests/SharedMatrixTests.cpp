@@ -0,0 +1,103 @@
+#include "matrix/Instrumentation.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/SharedMatrix.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Copies of shared matrix share storage until the first write", "[shared]")
+{
+	const auto source = mtx::CreateRandomMatrix2D<int>(20, 30, 7);
+	mtx::SharedMatrix2D<int> mat(source);
+	REQUIRE_FALSE(mat.IsShared());
+
+	mtx::instrumentation::Reset();
+	auto copy = mat;
+	const auto reader = copy;
+	REQUIRE(mat.IsShared());
+	REQUIRE(&copy.Read() == &mat.Read());
+	REQUIRE(mtx::instrumentation::GetSnapshot()[mtx::instrumentation::Operation::Copy].calls_ == 0);
+
+	// Reading doesn't clone.
+	REQUIRE(reader(3, 4) == source(3, 4));
+	REQUIRE(reader.GetView()(19, 29) == source(19, 29));
+	REQUIRE(std::equal(reader.Begin(), reader.End(), source.Begin()));
+	REQUIRE(&reader.Read() == &mat.Read());
+
+	copy(3, 4) = -1;
+	REQUIRE(&copy.Read() != &mat.Read());
+	REQUIRE(copy(3, 4) == -1);
+	REQUIRE(mat.Read()(3, 4) == source(3, 4));
+	REQUIRE(reader(3, 4) == source(3, 4));
+	if (mtx::instrumentation::IsEnabled()) {
+		REQUIRE(mtx::instrumentation::GetSnapshot()[mtx::instrumentation::Operation::Copy].calls_ == 1);
+	}
+
+	// The only owner writes without cloning.
+	const int* data = &copy.Read()(0, 0);
+	REQUIRE_FALSE(copy.IsShared());
+	*copy.Begin() = 5;
+	copy.GetView()(1, 1) = 6;
+	REQUIRE(&copy.Read()(0, 0) == data);
+
+	mtx::Matrix2DAdapter<int>::CyclicShift(copy.GetView());
+	REQUIRE(copy != mat);
+	REQUIRE(mat == reader);
+	REQUIRE(mat.Read() == source);
+
+	// Copies sharing storage are compared like copies of Matrix2D.
+	const mtx::SharedMatrix2D<double> withNan(2, 2, std::nan(""));
+	const mtx::SharedMatrix2D<double> sharedNan(withNan);
+	REQUIRE(sharedNan.IsShared());
+	REQUIRE(sharedNan != withNan);
+	REQUIRE_FALSE(mtx::SharedMatrix2D<double>::Matrix(sharedNan.Read()) == withNan.Read());
+	REQUIRE(sharedNan == sharedNan);
+}
+
+TEST_CASE("Shared matrices take part in expressions", "[shared]")
+{
+	const mtx::SharedMatrix2D<double> left(mtx::CreateRandomMatrix2D<double>(8, 9, 1));
+	const mtx::SharedMatrix2D<double> right(mtx::CreateRandomMatrix2D<double>(8, 9, 2));
+	const mtx::SharedMatrix2D<double> sum = left + right * 2.0;
+	REQUIRE(sum.Read() == mtx::Matrix2D<double>(left.Read() + right.Read() * 2.0));
+	REQUIRE(mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(sum.GetView())
+		== mtx::Matrix2DAdapter<double>::SumOverMainDiagonal(sum.Read().GetView()));
+
+	auto empty = mtx::SharedMatrix2D<double>();
+	REQUIRE(empty.GetRows() == 0);
+	empty = sum;
+	REQUIRE(empty == sum);
+}
+
+TEST_CASE("Copies of shared matrix are written by different threads", "[shared]")
+{
+	const mtx::SharedMatrix2D<int> mat(100, 100, 1);
+	std::vector<mtx::SharedMatrix2D<int>> copies(4, mat);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < copies.size(); ++i)
+	{
+		threads.emplace_back([&copies, i]
+		{
+			const auto view = copies[i].GetView();
+			for (size_t r = 0; r < view.GetRows(); ++r)
+			{
+				for (size_t c = 0; c < view.GetColumns(); ++c) {
+					view(r, c) += static_cast<int>(i);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(mat.Read() == mtx::Matrix2D<int>(100, 100, 1));
+	for (size_t i = 0; i < copies.size(); ++i) {
+		REQUIRE(copies[i].Read() == mtx::Matrix2D<int>(100, 100, 1 + static_cast<int>(i)));
+	}
+}
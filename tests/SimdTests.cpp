@@ -0,0 +1,248 @@
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Simd.h"
+
+#include "catch.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+//! Checks all kernels for sizes which cover full vectors and tails.
+template<typename T>
+void CheckKernels()
+{
+	for (size_t n = 0; n < 70; ++n)
+	{
+		std::vector<T> left(n);
+		std::vector<T> right(n);
+		std::vector<T> result(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			left[i] = static_cast<T>(i * 3 + 1);
+			right[i] = static_cast<T>(i % 7);
+		}
+
+		mtx::simd::Add(left.data(), right.data(), result.data(), n);
+		for (size_t i = 0; i < n; ++i) {
+			REQUIRE(result[i] == static_cast<T>(left[i] + right[i]));
+		}
+
+		mtx::simd::Subtract(left.data(), right.data(), result.data(), n);
+		for (size_t i = 0; i < n; ++i) {
+			REQUIRE(result[i] == static_cast<T>(left[i] - right[i]));
+		}
+
+		REQUIRE(mtx::simd::Sum(left.data(), n, static_cast<T>(5))
+			== std::accumulate(left.begin(), left.end(), static_cast<T>(5)));
+		REQUIRE(mtx::simd::Equal(left.data(), left.data(), n));
+		REQUIRE(!mtx::simd::AnyNegative(left.data(), n));
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::vector<T> other = left;
+			other[i] += 1;
+			REQUIRE(!mtx::simd::Equal(left.data(), other.data(), n));
+			other[i] = static_cast<T>(-1);
+			REQUIRE(mtx::simd::AnyNegative(other.data(), n));
+		}
+	}
+}
+
+//! Counts elements of rows [first, last) less than all their neighbors by the definition.
+template<typename T>
+int CountLocalMinimumsByDefinition(const mtx::Matrix2DView<const T>& view, const size_t first, const size_t last)
+{
+	const auto rows = static_cast<std::ptrdiff_t>(view.GetRows());
+	const auto columns = static_cast<std::ptrdiff_t>(view.GetColumns());
+	int counter = 0;
+	for (auto r = static_cast<std::ptrdiff_t>(first); r < static_cast<std::ptrdiff_t>(last); ++r)
+	{
+		for (std::ptrdiff_t c = 0; c < columns; ++c)
+		{
+			bool minimum = true;
+			for (std::ptrdiff_t dr = -1; dr <= 1; ++dr)
+			{
+				for (std::ptrdiff_t dc = -1; dc <= 1; ++dc)
+				{
+					const auto nr = r + dr;
+					const auto nc = c + dc;
+					if ((dr != 0 || dc != 0) && nr >= 0 && nr < rows && nc >= 0 && nc < columns
+						&& view(static_cast<size_t>(nr), static_cast<size_t>(nc)) <= view(static_cast<size_t>(r), static_cast<size_t>(c)))
+					{
+						minimum = false;
+					}
+				}
+			}
+			counter += minimum ? 1 : 0;
+		}
+	}
+
+	return counter;
+}
+
+//! Checks the stencil of local minimums for widths which cover full vectors, tails and borders.
+//! Values are taken from a small range, so there are many equal neighbors.
+template<typename T>
+void CheckLocalMinimums()
+{
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int> distribution(-3, 3);
+	for (size_t columns = 1; columns < 40; ++columns)
+	{
+		mtx::Matrix2D<T> mat(5, columns);
+		for (auto it = mat.Begin(); it != mat.End(); ++it) {
+			*it = static_cast<T>(distribution(generator));
+		}
+
+		const mtx::Matrix2DView<const T> view = mat.GetView();
+		REQUIRE(mtx::Matrix2DAdapter<T>::CountLocalMinimums(view) == CountLocalMinimumsByDefinition(view, 0, 5));
+		REQUIRE(mtx::Matrix2DAdapter<T>::CountLocalMinimums(view, 1, 3) == CountLocalMinimumsByDefinition(view, 1, 3));
+		const mtx::Matrix2DView<const T> block = mat.BlockView(1, columns / 3, 3, columns - columns / 3);
+		REQUIRE(mtx::Matrix2DAdapter<T>::CountLocalMinimums(block) == CountLocalMinimumsByDefinition(block, 0, 3));
+	}
+}
+
+//! Returns length and the first element of the longest run of identical elements by the definition.
+template<typename T>
+std::pair<size_t, size_t> LongestRunByDefinition(const std::vector<T>& data)
+{
+	std::pair<size_t, size_t> longest(1, 0);
+	for (size_t first = 0; first < data.size(); ++first)
+	{
+		size_t last = first;
+		while (last + 1 < data.size() && data[last + 1] == data[first]) {
+			++last;
+		}
+		if (last - first + 1 > longest.first) {
+			longest = std::make_pair(last - first + 1, first);
+		}
+	}
+
+	return longest;
+}
+
+//! Checks the run-length kernel for sizes which cover full masks, tails and runs
+//! crossing boundaries of masks. Values are taken from a small range, so there are many runs.
+template<typename T>
+void CheckLongestRun()
+{
+	std::mt19937 generator(11);
+	for (const int range : { 1, 2, 5 })
+	{
+		std::uniform_int_distribution<int> distribution(0, range);
+		for (size_t n = 0; n < 300; n += n < 140 ? 1 : 7)
+		{
+			std::vector<T> data(n);
+			for (auto& element : data) {
+				element = static_cast<T>(distribution(generator));
+			}
+			REQUIRE(mtx::simd::LongestRun(data.data(), n) == LongestRunByDefinition(data));
+		}
+	}
+
+	// A run crossing several masks and the first of two equal runs.
+	std::vector<T> data(400, static_cast<T>(1));
+	for (size_t i = 0; i < 60; ++i) {
+		data[i] = static_cast<T>(i % 2);
+	}
+	for (size_t i = 200; i < 400; i += 4) {
+		data[i] = static_cast<T>(2);
+	}
+	REQUIRE(mtx::simd::LongestRun(data.data(), data.size()) == std::make_pair(size_t{ 141 }, size_t{ 59 }));
+	data[100] = static_cast<T>(3);
+	REQUIRE(mtx::simd::LongestRun(data.data(), data.size()) == std::make_pair(size_t{ 99 }, size_t{ 101 }));
+}
+
+}	// namespace
+
+TEST_CASE("Vector kernels match scalar loops on every instruction set", "[Simd]")
+{
+	const auto supported = mtx::simd::GetSupportedIsa();
+	for (int level = 0; level <= static_cast<int>(supported); ++level)
+	{
+		const auto isa = static_cast<mtx::simd::Isa>(level);
+		mtx::simd::SetIsaLimit(isa);
+		INFO("Instruction set: " << mtx::simd::GetIsaName(isa));
+		REQUIRE(mtx::simd::GetActiveIsa() == isa);
+
+		CheckKernels<float>();
+		CheckKernels<double>();
+		CheckKernels<int>();
+		CheckKernels<long long>();
+
+		// Floating point comparison follows operator==.
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		const std::vector<double> zeros(9, 0.0);
+		std::vector<double> negativeZeros(9, -0.0);
+		REQUIRE(mtx::simd::Equal(zeros.data(), negativeZeros.data(), zeros.size()));
+		REQUIRE(!mtx::simd::AnyNegative(negativeZeros.data(), negativeZeros.size()));
+		negativeZeros[5] = nan;
+		REQUIRE(!mtx::simd::Equal(negativeZeros.data(), negativeZeros.data(), negativeZeros.size()));
+
+		CheckLongestRun<float>();
+		CheckLongestRun<double>();
+		CheckLongestRun<int>();
+		CheckLongestRun<long long>();
+		CheckLongestRun<unsigned int>();
+		const std::vector<double> nans(70, nan);
+		REQUIRE(mtx::simd::LongestRun(nans.data(), nans.size()) == std::make_pair(size_t{ 1 }, size_t{ 0 }));
+
+		CheckLocalMinimums<float>();
+		CheckLocalMinimums<double>();
+		CheckLocalMinimums<int>();
+		CheckLocalMinimums<long long>();
+		CheckLocalMinimums<unsigned int>();
+		CheckLocalMinimums<short>();
+
+		// Comparisons of 64 bit integers don't overflow for extreme values.
+		const long long extremes[] = {
+			std::numeric_limits<long long>::min(), std::numeric_limits<long long>::min() + 1, -1, 0, 1,
+			std::numeric_limits<long long>::max() - 1, std::numeric_limits<long long>::max() };
+		mtx::Matrix2D<long long> extreme(4, 23);
+		for (size_t i = 0; i < extreme.GetRows() * extreme.GetColumns(); ++i) {
+			extreme(i / 23, i % 23) = extremes[(i * 5 + i / 3) % 7];
+		}
+		REQUIRE(mtx::Matrix2DAdapter<long long>::CountLocalMinimums(extreme.GetView())
+			== CountLocalMinimumsByDefinition<long long>(extreme.GetView(), 0, 4));
+
+		// NaN neighbors don't prevent a minimum and a NaN element is a minimum, as with operator<=.
+		mtx::Matrix2D<double> grid(3, 20, 1.0);
+		grid(1, 4) = nan;
+		grid(1, 10) = 0.0;
+		grid(0, 11) = nan;
+		REQUIRE(mtx::Matrix2DAdapter<double>::CountLocalMinimums(grid.GetView())
+			== CountLocalMinimumsByDefinition<double>(grid.GetView(), 0, 3));
+		REQUIRE(mtx::Matrix2DAdapter<double>::CountLocalMinimums(grid.GetView()) == 3);
+
+		// Matrix operations use the kernels.
+		const mtx::Matrix2D<float> a(7, 9, 1.5f);
+		const mtx::Matrix2D<float> b(7, 9, 0.5f);
+		REQUIRE(mtx::TransformMatrices(a, b, std::plus<float>()) == mtx::Matrix2D<float>(7, 9, 2.0f));
+		const mtx::Matrix2D<float> difference = a - b;
+		REQUIRE(difference == mtx::Matrix2D<float>(7, 9, 1.0f));
+		REQUIRE(!(a == b));
+
+		auto mat = std::make_shared<mtx::Matrix2D<long long>>(5, 40, 2);
+		mtx::Matrix2DAdapter<long long> adapter(mat);
+		REQUIRE(adapter.SumOverMainDiagonal() == 2 * (39 + 38 + 37 + 36 + 35));
+
+		mat = std::make_shared<mtx::Matrix2D<long long>>(5, 40, 1);
+		adapter = mtx::Matrix2DAdapter<long long>(mat);
+		(*mat)(4, 0) = 3;
+		(*mat)(3, 33) = -1;
+		REQUIRE(adapter.NonNegativeRowsMultiplication() == 3);
+		(*mat)(4, 39) = -5;
+		REQUIRE(adapter.NonNegativeRowsMultiplication() == 1);
+	}
+
+	mtx::simd::SetIsaLimit(mtx::simd::Isa::Avx512);
+	REQUIRE(mtx::simd::GetActiveIsa() == supported);
+}
@@ -0,0 +1,191 @@
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/SparseMatrix.h"
+
+#include "catch.hpp"
+
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+//! Returns matrix where approximately density of elements are non-zeros from [-3, 3].
+template<typename T>
+mtx::Matrix2D<T> CreateSparseMatrix(const size_t rows, const size_t columns, const double density, std::mt19937& generator)
+{
+	mtx::Matrix2D<T> mat(rows, columns, T());
+	std::bernoulli_distribution stored(density);
+	std::uniform_int_distribution<int> values(-3, 3);
+	for (auto it = mat.Begin(); it != mat.End(); ++it)
+	{
+		if (stored(generator)) {
+			*it = static_cast<T>(values(generator));
+		}
+	}
+
+	return mat;
+}
+
+//! Checks that analyses of the sparse matrix match the ones of the dense matrix.
+template<typename T>
+void CheckAnalyses(const mtx::Matrix2D<T>& dense)
+{
+	const mtx::SparseMatrix2D<T> sparse(dense);
+	const auto view = dense.GetView();
+	REQUIRE(mtx::Matrix2DAdapter<T>::CountLocalMinimums(sparse)
+		== mtx::Matrix2DAdapter<T>::CountLocalMinimums(view));
+	REQUIRE(mtx::Matrix2DAdapter<T>::LongestIdenticalSet(sparse)
+		== mtx::Matrix2DAdapter<T>::LongestIdenticalSet(view));
+	REQUIRE(mtx::Matrix2DAdapter<T>::NonNegativeRowsMultiplication(sparse)
+		== mtx::Matrix2DAdapter<T>::NonNegativeRowsMultiplication(view));
+	REQUIRE(mtx::Matrix2DAdapter<T>::SumOverMainDiagonal(sparse)
+		== mtx::Matrix2DAdapter<T>::SumOverMainDiagonal(view));
+}
+
+}	// namespace
+
+TEST_CASE("Sparse matrix is built from triplets", "[sparse]")
+{
+	const std::vector<mtx::Triplet<int>> triplets = {
+		{ 2, 1, 5 },
+		{ 0, 3, 1 },
+		{ 2, 0, 4 },
+		{ 0, 3, 2 },
+		{ 1, 1, 7 },
+		{ 1, 1, -7 },
+		{ 2, 2, 0 },
+	};
+	const mtx::SparseMatrix2D<int> sparse(3, 4, triplets);
+
+	// Duplicates are summed, zeros aren't stored and columns of rows are sorted.
+	REQUIRE(sparse.GetRows() == 3);
+	REQUIRE(sparse.GetColumns() == 4);
+	REQUIRE(sparse.GetNonZeros() == 3);
+	REQUIRE(sparse.GetRowOffsets() == std::vector<size_t>{ 0, 1, 1, 3 });
+	REQUIRE(sparse.GetColumnIndices() == std::vector<size_t>{ 3, 0, 1 });
+	REQUIRE(sparse.GetValues() == std::vector<int>{ 3, 4, 5 });
+	REQUIRE(sparse(0, 3) == 3);
+	REQUIRE(sparse(1, 1) == 0);
+	REQUIRE(sparse.Find(1, 1) == nullptr);
+
+	const auto rebuilt = sparse.ToTriplets();
+	REQUIRE(rebuilt.size() == 3);
+	REQUIRE(mtx::SparseMatrix2D<int>(3, 4, rebuilt) == sparse);
+
+	REQUIRE_THROWS_AS(mtx::SparseMatrix2D<int>(3, 4, { { 3, 0, 1 } }), std::out_of_range);
+	REQUIRE_THROWS_AS(mtx::SparseMatrix2D<int>(3, 4, { { 0, 4, 1 } }), std::out_of_range);
+}
+
+TEST_CASE("Sparse matrix converts to and from dense matrix", "[sparse]")
+{
+	std::mt19937 generator;
+	for (const double density : { 0.0, 0.05, 0.5, 1.0 })
+	{
+		const auto dense = CreateSparseMatrix<double>(17, 23, density, generator);
+		const mtx::SparseMatrix2D<double> sparse(dense);
+		REQUIRE(sparse.ToDense() == dense);
+
+		const auto block = mtx::SparseMatrix2D<double>(dense.BlockView(2, 3, 10, 11)).ToDense();
+		for (size_t r = 0; r < block.GetRows(); ++r)
+		{
+			for (size_t c = 0; c < block.GetColumns(); ++c) {
+				REQUIRE(block(r, c) == dense(r + 2, c + 3));
+			}
+		}
+	}
+
+	const mtx::SparseMatrix2D<int> empty(0, 5);
+	REQUIRE(empty.ToDense().GetRows() == 0);
+	REQUIRE(empty.GetNonZeros() == 0);
+}
+
+TEST_CASE("Sparse matrices are added and subtracted", "[sparse]")
+{
+	std::mt19937 generator;
+	const auto left = CreateSparseMatrix<int>(31, 19, 0.1, generator);
+	const auto right = CreateSparseMatrix<int>(31, 19, 0.1, generator);
+	const mtx::SparseMatrix2D<int> sparseLeft(left);
+	const mtx::SparseMatrix2D<int> sparseRight(right);
+
+	REQUIRE((sparseLeft + sparseRight).ToDense() == mtx::TransformMatrices(left, right, std::plus<int>()));
+	REQUIRE((sparseLeft - sparseRight).ToDense() == mtx::TransformMatrices(left, right, std::minus<int>()));
+	// Cancelled elements aren't stored.
+	REQUIRE((sparseLeft - sparseLeft).GetNonZeros() == 0);
+
+	REQUIRE_THROWS_AS(sparseLeft + mtx::SparseMatrix2D<int>(31, 18), std::length_error);
+	REQUIRE_THROWS_AS(sparseLeft - mtx::SparseMatrix2D<int>(30, 19), std::length_error);
+}
+
+TEST_CASE("Sparse matrix is multiplied by dense matrix and vector", "[sparse]")
+{
+	std::mt19937 generator;
+	const auto left = CreateSparseMatrix<int>(37, 29, 0.1, generator);
+	const auto right = CreateSparseMatrix<int>(29, 13, 1.0, generator);
+	const mtx::SparseMatrix2D<int> sparse(left);
+	const auto expected = mtx::Multiply(left, right);
+
+	REQUIRE(mtx::Multiply(sparse, right) == expected);
+	REQUIRE(sparse * right == expected);
+
+	mtx::Matrix2D<int> result(37, 13, 100);
+	mtx::Multiply(mtx::execution::par, sparse, right.GetView(), result.GetView());
+	REQUIRE(result == expected);
+
+	std::vector<int> vec(29);
+	for (size_t r = 0; r < vec.size(); ++r) {
+		vec[r] = right(r, 0);
+	}
+	const auto product = sparse * vec;
+	REQUIRE(product.size() == 37);
+	for (size_t r = 0; r < product.size(); ++r) {
+		REQUIRE(product[r] == expected(r, 0));
+	}
+
+	REQUIRE_THROWS_AS(mtx::Multiply(sparse, left), std::length_error);
+	REQUIRE_THROWS_AS(sparse * std::vector<int>(28), std::length_error);
+}
+
+TEST_CASE("Analyses of sparse matrix match the dense ones", "[sparse]")
+{
+	std::mt19937 generator;
+	for (const size_t rows : { 1, 2, 3, 8, 25 })
+	{
+		for (const size_t columns : { 1, 2, 3, 9, 40 })
+		{
+			for (const double density : { 0.0, 0.05, 0.3, 0.9 })
+			{
+				CheckAnalyses(CreateSparseMatrix<int>(rows, columns, density, generator));
+				CheckAnalyses(CreateSparseMatrix<double>(rows, columns, density, generator));
+			}
+		}
+	}
+
+	// Zero surrounded by positive elements is a local minimum.
+	const mtx::SparseMatrix2D<int> ring(3, 3, {
+		{ 0, 0, 1 }, { 0, 1, 1 }, { 0, 2, 1 },
+		{ 1, 0, 1 }, { 1, 2, 1 },
+		{ 2, 0, 1 }, { 2, 1, 1 }, { 2, 2, 1 } });
+	REQUIRE(mtx::Matrix2DAdapter<int>::CountLocalMinimums(ring) == 1);
+	REQUIRE(mtx::Matrix2DAdapter<int>::CountLocalMinimums(mtx::SparseMatrix2D<int>(1, 1)) == 1);
+	REQUIRE(mtx::Matrix2DAdapter<int>::LongestIdenticalSet(mtx::SparseMatrix2D<int>(0, 3)) == -1);
+
+	// Gaps of zeros and stored elements form runs together, the longest run is in the second row.
+	const mtx::SparseMatrix2D<int> runs(2, 8, {
+		{ 0, 2, 1 }, { 0, 5, 1 },
+		{ 1, 0, 2 }, { 1, 1, 2 }, { 1, 2, 2 }, { 1, 4, 1 }, { 1, 6, 3 } });
+	REQUIRE(mtx::Matrix2DAdapter<int>::LongestIdenticalSet(runs) == 1);
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	mtx::Matrix2D<double> withNan(4, 5, 0.0);
+	withNan(1, 2) = nan;
+	withNan(3, 0) = 2.0;
+	const mtx::SparseMatrix2D<double> sparseNan(withNan);
+	REQUIRE(mtx::Matrix2DAdapter<double>::CountLocalMinimums(sparseNan)
+		== mtx::Matrix2DAdapter<double>::CountLocalMinimums(withNan.GetView()));
+	REQUIRE(mtx::Matrix2DAdapter<double>::LongestIdenticalSet(sparseNan)
+		== mtx::Matrix2DAdapter<double>::LongestIdenticalSet(withNan.GetView()));
+}
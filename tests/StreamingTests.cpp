@@ -0,0 +1,123 @@
+#include "matrix/BinaryFormat.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Streaming.h"
+
+#include "TemporaryFile.h"
+#include "catch.hpp"
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+//! Checks that streamed analyses of the saved matrix match the ones of the matrix in memory.
+template<typename T>
+void CheckAnalyses(const mtx::Matrix2D<T>& mat, const std::string& path)
+{
+	const auto view = mat.GetView();
+	for (const size_t bandRows : { 1, 2, 3, 7, 64, 1000 })
+	{
+		REQUIRE(mtx::streaming::CountLocalMinimums<T>(path, bandRows)
+			== mtx::Matrix2DAdapter<T>::CountLocalMinimums(view));
+		REQUIRE(mtx::streaming::LongestIdenticalSet<T>(path, bandRows)
+			== mtx::Matrix2DAdapter<T>::LongestIdenticalSet(view));
+		REQUIRE(mtx::streaming::NonNegativeRowsMultiplication<T>(path, bandRows)
+			== mtx::Matrix2DAdapter<T>::NonNegativeRowsMultiplication(view));
+		REQUIRE(mtx::streaming::SumOverMainDiagonal<T>(path, bandRows)
+			== mtx::Matrix2DAdapter<T>::SumOverMainDiagonal(view));
+	}
+}
+
+}	// namespace
+
+TEST_CASE("Bands are streamed with halo rows", "[Streaming]")
+{
+	const TemporaryFile file("StreamingTests.bin");
+	mtx::Matrix2D<int> mat(10, 3);
+	for (size_t r = 0; r < mat.GetRows(); ++r) {
+		mat(r, 0) = static_cast<int>(r);
+	}
+	mtx::Save(mat, file.path_);
+
+	mtx::streaming::BandStream<int> stream(file.path_, 4, 1);
+	REQUIRE(stream.GetRows() == 10);
+	REQUIRE(stream.GetColumns() == 3);
+
+	size_t expectedFirst = 0;
+	while (stream.Next())
+	{
+		const auto& band = stream.GetBand();
+		REQUIRE(band.firstRow_ == expectedFirst);
+		REQUIRE(band.haloTop_ == (expectedFirst == 0 ? 0 : 1));
+		REQUIRE(band.view_(band.haloTop_, 0) == static_cast<int>(band.firstRow_));
+		const size_t lastRow = band.firstRow_ + band.rows_;
+		REQUIRE(band.view_.GetRows() == band.haloTop_ + band.rows_ + (lastRow < 10 ? 1 : 0));
+		expectedFirst = lastRow;
+	}
+	REQUIRE(expectedFirst == 10);
+	REQUIRE_FALSE(stream.Next());
+}
+
+TEST_CASE("Streamed analyses match analyses in memory", "[Streaming]")
+{
+	const TemporaryFile file("StreamingTests.bin");
+
+	SECTION("Integer matrix")
+	{
+		auto mat = mtx::CreateRandomMatrix2D<int>(53, 41);
+		for (size_t c = 0; c < 20; ++c) {
+			mat(37, c) = 3;
+		}
+		mat(5, 5) = -1;
+		mtx::Save(mat, file.path_);
+		CheckAnalyses(mat, file.path_);
+	}
+
+	SECTION("Padded matrix wider than tall")
+	{
+		mtx::Matrix2D<double> mat(mtx::Matrix2D<double>::Dimension{ 9, 30 }, mtx::SimdRowPadding<double>());
+		mat = mtx::CreateRandomMatrix2D<double>(9, 30) * 0.02;
+		mtx::Save(mat, file.path_);
+		CheckAnalyses(mat, file.path_);
+	}
+
+	SECTION("Degenerate matrices")
+	{
+		mtx::Save(mtx::Matrix2D<int>(1, 5, 4), file.path_);
+		CheckAnalyses(mtx::Matrix2D<int>(1, 5, 4), file.path_);
+		mtx::Save(mtx::Matrix2D<int>(), file.path_);
+		REQUIRE(mtx::streaming::LongestIdenticalSet<int>(file.path_) == -1);
+		REQUIRE(mtx::streaming::SumOverMainDiagonal<int>(file.path_) == 0);
+	}
+}
+
+TEST_CASE("Streamed transformation writes the result file", "[Streaming]")
+{
+	const TemporaryFile leftFile("StreamingLeft.bin");
+	const TemporaryFile rightFile("StreamingRight.bin");
+	const TemporaryFile resultFile("StreamingResult.bin");
+
+	mtx::Matrix2D<float> left(mtx::Matrix2D<float>::Dimension{ 23, 19 }, mtx::SimdRowPadding<float>());
+	left = mtx::CreateRandomMatrix2D<float>(23, 19) + 0.0f;
+	const auto right = mtx::CreateRandomMatrix2D<float>(23, 19);
+	mtx::Save(left, leftFile.path_);
+	mtx::Save(right, rightFile.path_);
+
+	mtx::streaming::TransformMatrices<float>(
+		leftFile.path_,
+		rightFile.path_,
+		resultFile.path_,
+		std::minus<float>(),
+		5);
+	const auto result = mtx::Load<float>(resultFile.path_);
+	REQUIRE(result == mtx::TransformMatrices(left, right, std::minus<float>()));
+	REQUIRE(result.GetRowStride() == left.GetRowStride());
+
+	mtx::Save(mtx::Matrix2D<float>(3, 3), rightFile.path_);
+	REQUIRE_THROWS_AS(
+		mtx::streaming::TransformMatrices<float>(leftFile.path_, rightFile.path_, resultFile.path_, std::plus<float>()),
+		std::length_error);
+}
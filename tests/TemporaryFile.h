@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+//! Removes the file when the test is finished.
+struct TemporaryFile
+{
+	explicit TemporaryFile(std::string path) : path_{ std::move(path) } {}
+	~TemporaryFile() { std::remove(path_.c_str()); }
+	TemporaryFile(const TemporaryFile&) = delete;
+	TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+	std::string path_;
+};
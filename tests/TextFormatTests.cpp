@@ -0,0 +1,195 @@
+#include "matrix/Matrix.h"
+#include "matrix/TextFormat.h"
+
+#include "TemporaryFile.h"
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+//! Returns the matrix written as text and read back.
+template<typename T>
+mtx::Matrix2D<T> RoundTrip(const mtx::Matrix2D<T>& mat, const char separator = ',')
+{
+	std::stringstream stream;
+	mtx::SaveText(mat.GetView(), stream, separator);
+	return mtx::LoadText<T>(stream);
+}
+
+//! Returns matrix of T read from the text.
+template<typename T>
+mtx::Matrix2D<T> Parse(const std::string& text)
+{
+	std::istringstream stream(text);
+	return mtx::LoadText<T>(stream);
+}
+
+}	// namespace
+
+TEST_CASE("Matrices are written and read as text", "[TextFormat]")
+{
+	SECTION("Round trip keeps elements exactly")
+	{
+		const auto ints = mtx::CreateRandomMatrix2D<int>(37, 23, 1);
+		REQUIRE(RoundTrip(ints) == ints);
+		REQUIRE(RoundTrip(ints, ' ') == ints);
+		REQUIRE(RoundTrip(ints, '\t') == ints);
+
+		const auto doubles = mtx::CreateRandomMatrix2D<double>(41, 19, 2);
+		REQUIRE(RoundTrip(doubles) == doubles);
+		const auto floats = mtx::CreateRandomMatrix2D<float>(17, 50, 3);
+		REQUIRE(RoundTrip(floats) == floats);
+
+		mtx::Matrix2D<double> extremes(2, 6);
+		extremes(0, 0) = std::numeric_limits<double>::max();
+		extremes(0, 1) = std::numeric_limits<double>::min();
+		extremes(0, 2) = std::numeric_limits<double>::denorm_min();
+		extremes(0, 3) = -0.0;
+		extremes(0, 4) = std::numeric_limits<double>::infinity();
+		extremes(0, 5) = 0.1;
+		extremes(1, 0) = 9007199254740993.0;
+		extremes(1, 1) = -123456789.0;
+		extremes(1, 2) = 1e22;
+		extremes(1, 3) = 1e23;
+		extremes(1, 4) = 1.0 / 3;
+		extremes(1, 5) = -2.5e-300;
+		const auto read = RoundTrip(extremes);
+		REQUIRE(read == extremes);
+		REQUIRE(std::signbit(read(0, 3)));
+
+		mtx::Matrix2D<std::int64_t> integers(1, 3);
+		integers(0, 0) = std::numeric_limits<std::int64_t>::min();
+		integers(0, 1) = std::numeric_limits<std::int64_t>::max();
+		integers(0, 2) = 0;
+		REQUIRE(RoundTrip(integers) == integers);
+		mtx::Matrix2D<std::uint64_t> unsignedIntegers(1, 1, std::numeric_limits<std::uint64_t>::max());
+		REQUIRE(RoundTrip(unsignedIntegers) == unsignedIntegers);
+		mtx::Matrix2D<std::int8_t> bytes(2, 2, -128);
+		REQUIRE(RoundTrip(bytes) == bytes);
+	}
+
+	SECTION("Text has a line per row")
+	{
+		mtx::Matrix2D<double> mat(2, 3);
+		mat(0, 0) = 1;
+		mat(0, 1) = -2.5;
+		mat(1, 2) = 1e100;
+		std::ostringstream stream;
+		mtx::SaveText(mat.GetView(), stream);
+		REQUIRE(stream.str() == "1,-2.5,0\n0,0,1e+100\n");
+
+		std::ostringstream blockStream;
+		mtx::SaveText(mat.BlockView(0, 1, 2, 2), blockStream, ' ');
+		REQUIRE(blockStream.str() == "-2.5 0\n0 1e+100\n");
+	}
+
+	SECTION("Floating point elements are written with short digits")
+	{
+		mtx::Matrix2D<double> mat(1, 6);
+		mat(0, 0) = 0.1;
+		mat(0, 1) = 1e300;
+		mat(0, 2) = std::numeric_limits<double>::denorm_min();
+		mat(0, 3) = -0.00123;
+		mat(0, 4) = 123.456;
+		mat(0, 5) = std::numeric_limits<double>::max();
+		std::ostringstream stream;
+		mtx::SaveText(mat.GetView(), stream);
+		REQUIRE(stream.str() == "0.1,1e+300,5e-324,-0.00123,123.456,1.7976931348623157e+308\n");
+
+		mtx::Matrix2D<float> floats(1, 2);
+		floats(0, 0) = 0.1f;
+		floats(0, 1) = 3.4028235e38f;
+		std::ostringstream floatStream;
+		mtx::SaveText(floats.GetView(), floatStream);
+		REQUIRE(floatStream.str() == "0.1,3.4028235e+38\n");
+	}
+
+	SECTION("Random bit patterns are read back exactly")
+	{
+		std::mt19937_64 generator(6);
+		mtx::Matrix2D<double> doubles(200, 50);
+		for (size_t i = 0; i < doubles.GetRows() * doubles.GetColumns(); ++i)
+		{
+			auto& element = doubles(i / doubles.GetColumns(), i % doubles.GetColumns());
+			do
+			{
+				const std::uint64_t bits = generator();
+				std::memcpy(&element, &bits, sizeof(element));
+			} while (!std::isfinite(element));
+		}
+		REQUIRE(RoundTrip(doubles) == doubles);
+
+		mtx::Matrix2D<float> floats(200, 50);
+		for (size_t i = 0; i < floats.GetRows() * floats.GetColumns(); ++i)
+		{
+			auto& element = floats(i / floats.GetColumns(), i % floats.GetColumns());
+			do
+			{
+				const auto bits = static_cast<std::uint32_t>(generator());
+				std::memcpy(&element, &bits, sizeof(element));
+			} while (!std::isfinite(element));
+		}
+		REQUIRE(RoundTrip(floats) == floats);
+	}
+
+	SECTION("Parallel writing and reading give the same results")
+	{
+		const auto mat = mtx::CreateRandomMatrix2D<double>(3000, 17, 4);
+		std::stringstream sequential;
+		mtx::SaveText(mat.GetView(), sequential);
+		std::stringstream parallel;
+		mtx::SaveText(mtx::execution::ParallelPolicy{ 3 }, mat.GetView(), parallel);
+		REQUIRE(parallel.str() == sequential.str());
+		REQUIRE(mtx::LoadText<double>(mtx::execution::ParallelPolicy{ 3 }, parallel) == mat);
+	}
+
+	SECTION("Readers accept CSV and whitespace separated text")
+	{
+		const auto expected = Parse<int>("1 2 3\n4 5 6\n");
+		REQUIRE(expected.GetRows() == 2);
+		REQUIRE(expected.GetColumns() == 3);
+		REQUIRE(expected(1, 2) == 6);
+		REQUIRE(Parse<int>("1,2,3\r\n4,5,6\r\n") == expected);
+		REQUIRE(Parse<int>("  1 ,\t2;3\n\n   \n+4, 5, 6, \n") == expected);
+		REQUIRE(Parse<int>("1\t2\t3\n4\t5\t6") == expected);
+		REQUIRE(Parse<double>("1.5e1, .25, -3.\n0.000001, 1E-3, inf\n")(0, 0) == 15.0);
+		REQUIRE(Parse<double>("0.1 123456789012345678901234567890\n")(0, 1) == 1.2345678901234568e29);
+		REQUIRE(Parse<float>("0.1 16777217\n")(0, 0) == 0.1f);
+		REQUIRE(Parse<float>("0.1 16777217\n")(0, 1) == 16777216.0f);
+		REQUIRE(Parse<int>("").GetRows() == 0);
+		REQUIRE(Parse<int>("\n \n").GetColumns() == 0);
+	}
+
+	SECTION("Invalid text is reported")
+	{
+		REQUIRE_THROWS_AS(Parse<int>("1 2 3\n4 5\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<int>("1 2\n4 5 6\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<int>("1 x\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<int>("1.5\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<int>("2147483648\n"), std::runtime_error);
+		REQUIRE(Parse<int>("-2147483648\n")(0, 0) == std::numeric_limits<int>::min());
+		REQUIRE_THROWS_AS(Parse<unsigned>("-1\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<std::int8_t>("128\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<double>("1e\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(Parse<double>("1,,2\n"), std::runtime_error);
+		REQUIRE_THROWS_AS(mtx::LoadText<int>("no/such/file.txt"), std::runtime_error);
+	}
+
+	SECTION("Files are written and read")
+	{
+		const TemporaryFile file("TextFormatTests.csv");
+		const auto mat = mtx::CreateRandomMatrix2D<int>(100, 10, 5);
+		mtx::SaveText(mtx::execution::par, mat, file.path_);
+		REQUIRE(mtx::LoadText<int>(mtx::execution::par, file.path_) == mat);
+		REQUIRE(mtx::LoadText<int>(file.path_) == mat);
+	}
+}
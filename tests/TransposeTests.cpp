@@ -0,0 +1,136 @@
+#include "matrix/BinaryFormat.h"
+#include "matrix/Matrix.h"
+#include "matrix/Matrix2DAdapter.h"
+#include "matrix/Transpose.h"
+
+#include "catch.hpp"
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+//! Checks that result is the transposed source.
+template<typename S, typename D>
+void CheckTransposed(const mtx::Matrix2DView<S>& source, const mtx::Matrix2DView<D>& result)
+{
+	REQUIRE(result.GetRows() == source.GetColumns());
+	REQUIRE(result.GetColumns() == source.GetRows());
+	for (size_t r = 0; r < source.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < source.GetColumns(); ++c) {
+			REQUIRE(result(c, r) == source(r, c));
+		}
+	}
+}
+
+}	// namespace
+
+TEST_CASE("Matrices of any sizes are transposed", "[transpose]")
+{
+	const size_t sizes[][2] = { { 0, 0 }, { 1, 1 }, { 1, 77 }, { 77, 1 }, { 31, 33 }, { 100, 257 }, { 300, 65 } };
+	for (const auto& size : sizes)
+	{
+		const auto mat = mtx::CreateRandomMatrix2D<int>(size[0], size[1], 3);
+		mtx::Matrix2D<int> result(size[1], size[0]);
+		mtx::Transpose(mat.GetView(), result.GetView());
+		CheckTransposed(mat.GetView(), result.GetView());
+
+		mtx::Matrix2D<int> parallelResult(size[1], size[0]);
+		mtx::Transpose(mtx::execution::ParallelPolicy{ 3 }, mat.GetView(), parallelResult.GetView());
+		REQUIRE(parallelResult == result);
+
+		REQUIRE(mtx::Transpose(mat) == result);
+		REQUIRE(mtx::Transpose(mtx::Transpose(mtx::execution::seq, mat)) == mat);
+	}
+
+	// Views with any strides.
+	const auto mat = mtx::CreateRandomMatrix2D<double>(90, 70, 4);
+	const auto block = mat.BlockView(5, 10, 50, 40);
+	mtx::Matrix2D<double> padded(
+		mtx::Matrix2D<double>::Dimension{ 40, 50 },
+		mtx::SimdRowPadding<double>());
+	mtx::Transpose(block, padded.GetView());
+	CheckTransposed(block, padded.GetView());
+
+	mtx::Matrix2D<double> wrongSize(50, 40);
+	REQUIRE_THROWS_AS(mtx::Transpose(block, wrongSize.GetView()), std::length_error);
+}
+
+TEST_CASE("Square matrices are transposed in place", "[transpose]")
+{
+	for (const size_t size : { 0, 1, 2, 31, 32, 33, 100, 129 })
+	{
+		const auto source = mtx::CreateRandomMatrix2D<float>(size, size, 5);
+		auto mat = source;
+		mtx::TransposeInPlace(mat.GetView());
+		CheckTransposed(source.GetView(), mat.GetView());
+
+		auto parallel = source;
+		mtx::TransposeInPlace(mtx::execution::ParallelPolicy{ 4 }, parallel.GetView());
+		REQUIRE(parallel == mat);
+	}
+
+	mtx::Matrix2D<int> rectangle(3, 4);
+	REQUIRE_THROWS_AS(mtx::TransposeInPlace(rectangle.GetView()), std::length_error);
+}
+
+TEST_CASE("Column-major matrices keep columns next to each other", "[transpose]")
+{
+	const auto rowMajor = mtx::CreateRandomMatrix2D<int>(37, 53, 6);
+	const auto columnMajor = mtx::ConvertLayout(rowMajor, mtx::Layout::ColumnMajor);
+	REQUIRE(columnMajor.GetLayout() == mtx::Layout::ColumnMajor);
+	REQUIRE(columnMajor.GetRowStride() == 1);
+	REQUIRE(columnMajor.GetColumnStride() == 37);
+	REQUIRE(columnMajor.IsContiguous());
+	REQUIRE(columnMajor.ColumnView(3).IsContiguous());
+	REQUIRE(*(columnMajor.Begin() + 1) == rowMajor(1, 0));
+	for (size_t r = 0; r < rowMajor.GetRows(); ++r)
+	{
+		for (size_t c = 0; c < rowMajor.GetColumns(); ++c) {
+			REQUIRE(columnMajor(r, c) == rowMajor(r, c));
+		}
+	}
+	REQUIRE(columnMajor.Slice(4, 10, 20) == rowMajor.Slice(4, 10, 20));
+
+	// Layouts don't change values of elements seen by algorithms.
+	REQUIRE(columnMajor == rowMajor);
+	REQUIRE(mtx::Equal(mtx::execution::ParallelPolicy{ 3 }, columnMajor, rowMajor));
+	REQUIRE(mtx::ConvertLayout(columnMajor, mtx::Layout::RowMajor) == rowMajor);
+	REQUIRE(mtx::ConvertLayout(columnMajor, mtx::Layout::RowMajor).GetLayout() == mtx::Layout::RowMajor);
+
+	const auto sum = mtx::TransformMatrices(columnMajor, columnMajor, std::plus<int>());
+	REQUIRE(sum.GetLayout() == mtx::Layout::ColumnMajor);
+	REQUIRE(sum == mtx::TransformMatrices(rowMajor, rowMajor, std::plus<int>()));
+	REQUIRE(mtx::TransformMatrices(columnMajor, rowMajor, std::plus<int>()) == sum);
+	REQUIRE(mtx::TransformMatrices(mtx::execution::par, columnMajor, columnMajor, std::plus<int>()) == sum);
+
+	const mtx::Matrix2D<int> lazySum = columnMajor + rowMajor;
+	REQUIRE(lazySum == sum);
+	auto assigned = mtx::ConvertLayout(rowMajor, mtx::Layout::ColumnMajor);
+	assigned = columnMajor + columnMajor;
+	REQUIRE(assigned.GetLayout() == mtx::Layout::ColumnMajor);
+	REQUIRE(assigned == sum);
+
+	const auto transposed = mtx::Transpose(columnMajor);
+	REQUIRE(transposed.GetLayout() == mtx::Layout::ColumnMajor);
+	REQUIRE(transposed == mtx::Transpose(rowMajor));
+	REQUIRE(columnMajor * transposed == rowMajor * mtx::Transpose(rowMajor));
+
+	REQUIRE(mtx::Matrix2DAdapter<int>::CountLocalMinimums(columnMajor.GetView())
+		== mtx::Matrix2DAdapter<int>::CountLocalMinimums(rowMajor.GetView()));
+	REQUIRE(mtx::Matrix2DAdapter<int>::CountLocalMinimums(mtx::execution::ParallelPolicy{ 3 }, columnMajor.GetView())
+		== mtx::Matrix2DAdapter<int>::CountLocalMinimums(rowMajor.GetView()));
+	REQUIRE(mtx::Matrix2DAdapter<int>::LongestIdenticalSet(columnMajor.GetView())
+		== mtx::Matrix2DAdapter<int>::LongestIdenticalSet(rowMajor.GetView()));
+
+	// Files keep rows, so they are read back as row-major matrices.
+	std::stringstream stream;
+	mtx::Save(columnMajor, stream);
+	REQUIRE(mtx::Load<int>(stream) == rowMajor);
+
+	const mtx::Matrix2D<double> filled(mtx::Matrix2D<double>::Dimension{ 3, 5 }, mtx::Layout::ColumnMajor, 2.5);
+	REQUIRE(filled == mtx::Matrix2D<double>(3, 5, 2.5));
+}